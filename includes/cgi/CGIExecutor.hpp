@@ -64,20 +64,25 @@ private:
 	struct PipeSet {
 		int stdinPipe[2];   // Parent writes to child stdin
 		int stdoutPipe[2];  // Parent reads from child stdout
+		int bodyFd;         // Spooled request body, the child's stdin instead of the pipe (-1 if none)
 	};
 
+	static bool openPipe(int fds[2]);
 	bool createPipes(PipeSet& pipes);
 	void closePipes(PipeSet& pipes);
 
 	// Execute CGI script in child process
-	void executeChild(const std::string& cgiPath,
-	                 const std::string& scriptPath,
+	void executeChild(const char* cgiPath,
+	                 const char* scriptDir,
+	                 char** argv,
 	                 const PipeSet& pipes,
 	                 char** envp);
+	static void childError(const char* message);
 
 	// Handle parent process I/O
 	std::string handleParent(const PipeSet& pipes,
-	                        const std::string& requestBody,
+	                        const char* requestBody,
+	                        size_t bodyLength,
 	                        pid_t childPid,
 	                        int timeoutSeconds);
 
@@ -33,6 +33,24 @@ public:
 	void addServer(const Server& server);
 	const std::vector<Server>& getServers() const;
 
+	// Global settings (events block)
+	void setEventBackend(const std::string& backend);
+	const std::string& getEventBackend() const;
+	void setAcceptBudget(int budget);
+	int getAcceptBudget() const;
+	void setWorkerConnections(int count);
+	int getWorkerConnections() const;
+
+	// Global settings (main context)
+	void setMasterProcess(bool enabled);
+	bool getMasterProcess() const;
+	void setWorkerProcesses(int count);
+	int getWorkerProcesses() const;
+	void setWorkerThreads(int count);
+	int getWorkerThreads() const;
+	void setGzipCacheSize(size_t size);
+	size_t getGzipCacheSize() const;
+
 	// Server lookup
 	const Server* getServer(const std::string& host, int port, const std::string& serverName = "") const;
 	const Server* getDefaultServer(const std::string& host, int port) const;
@@ -45,4 +63,11 @@ public:
 
 private:
 	std::vector<Server> _servers;  // Lista de todos os servers configurados
+	std::string _eventBackend;     // Backend de eventos ("poll", "epoll", "io_uring" ou vazio = default)
+	int _acceptBudget;             // Máximo de accepts por listener em cada iteração do loop
+	int _workerConnections;        // Máximo de conexões por processo (acima disto: 503 imediato)
+	bool _masterProcess;           // Master a supervisionar os workers (necessário para reload)
+	int _workerProcesses;          // Número de processos worker
+	int _workerThreads;            // Event loops (threads) por processo
+	size_t _gzipCacheSize;         // Bytes de respostas comprimidas guardadas (partilhados pelas threads)
 };
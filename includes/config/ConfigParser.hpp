@@ -39,6 +39,10 @@ private:
 	std::vector<std::string> tokenize(const std::string& content);
 
 	// Parsing helpers
+	bool parseWorkerCount(std::vector<std::string>& tokens, size_t& index, Config& config);
+	bool parseEvents(std::vector<std::string>& tokens, size_t& index, Config& config);
+	bool parseEventsDirective(const std::string& directive, std::vector<std::string>& tokens,
+	                          size_t& index, Config& config);
 	bool parseServer(std::vector<std::string>& tokens, size_t& index, Server& server);
 	bool parseLocation(std::vector<std::string>& tokens, size_t& index, Route& route);
 	bool parseServerDirective(const std::string& directive, std::vector<std::string>& tokens,
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include "includes/http/Method.hpp"
 
 class Route {
 public:
@@ -32,7 +33,7 @@ public:
 
 	// Getters
 	const std::string& getPath() const;
-	const std::vector<std::string>& getAllowedMethods() const;
+	unsigned int getAllowedMethods() const;
 	const std::string& getRedirect() const;
 	const std::string& getRoot() const;
 	bool isDirectoryListingEnabled() const;
@@ -42,10 +43,11 @@ public:
 	const std::string& getCgiExtension() const;
 	bool isUploadEnabled() const;
 	const std::string& getUploadPath() const;
+	bool isSendfileEnabled() const;
 
 	// Setters
 	void setPath(const std::string& path);
-	void addAllowedMethod(const std::string& method);
+	bool addAllowedMethod(const std::string& method);
 	void setRedirect(const std::string& redirect);
 	void setRoot(const std::string& root);
 	void setDirectoryListing(bool enabled);
@@ -55,9 +57,10 @@ public:
 	void setCgiExtension(const std::string& extension);
 	void setUploadEnabled(bool enabled);
 	void setUploadPath(const std::string& uploadPath);
+	void setSendfile(bool enabled);
 
 	// Validation
-	bool isMethodAllowed(const std::string& method) const;
+	bool isMethodAllowed(HTTP::Method::Id method) const;
 	bool isValid() const;
 
 	// Debug
@@ -65,7 +68,7 @@ public:
 
 private:
 	std::string _path;                          // Path da route (ex: /uploads)
-	std::vector<std::string> _allowedMethods;   // Métodos permitidos (GET, POST, DELETE)
+	unsigned int _allowedMethods;               // Métodos permitidos (máscara de HTTP::Method::bit)
 	std::string _redirect;                      // Redirect URL (se configurado)
 	std::string _root;                          // Root directory para esta route
 	bool _directoryListing;                     // Directory listing enabled?
@@ -75,4 +78,5 @@ private:
 	std::string _cgiExtension;                  // Extensão de ficheiros CGI (.php, .py)
 	bool _uploadEnabled;                        // Upload enabled?
 	std::string _uploadPath;                    // Directory para uploads
+	bool _sendfile;                             // Ficheiros estáticos via sendfile() (off: pread + writev)
 };
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <ctime>
 
 class Server {
 public:
@@ -35,18 +36,37 @@ public:
 	const std::string& getHost() const;
 	const std::vector<std::string>& getServerNames() const;
 	size_t getMaxBodySize() const;
+	size_t getBodyBufferSize() const;
+	time_t getClientHeaderTimeout() const;
+	time_t getKeepaliveTimeout() const;
+	size_t getKeepaliveRequests() const;
+	int getListenBacklog() const;
 	const std::map<int, std::string>& getErrorPages() const;
 	const std::vector<Route>& getRoutes() const;
 	bool isDefaultServer() const;
+	bool isGzipEnabled() const;
+	bool isGzipType(const char* mimeType, size_t length) const;
+	size_t getGzipMinLength() const;
+	int getGzipLevel() const;
 
 	// Setters
 	void addPort(int port);
 	void setHost(const std::string& host);
 	void addServerName(const std::string& serverName);
 	void setMaxBodySize(size_t size);
+	void setBodyBufferSize(size_t size);
+	void setClientHeaderTimeout(time_t seconds);
+	void setKeepaliveTimeout(time_t seconds);
+	void setKeepaliveRequests(size_t requests);
+	void setListenBacklog(int backlog);
 	void setErrorPage(int code, const std::string& path);
 	void addRoute(const Route& route);
 	void setDefaultServer(bool isDefault);
+	void setGzip(bool enabled);
+	void clearGzipTypes();
+	void addGzipType(const std::string& mimeType);
+	void setGzipMinLength(size_t length);
+	void setGzipLevel(int level);
 
 	// Route matching
 	const Route* matchRoute(const std::string& path) const;
@@ -65,7 +85,16 @@ private:
 	std::string _host;                          // Host (ex: localhost, 0.0.0.0)
 	std::vector<std::string> _serverNames;      // Server names (ex: example.com, www.example.com)
 	size_t _maxBodySize;                        // Tamanho máximo do body (bytes)
+	size_t _bodyBufferSize;                     // Bodies maiores vão para um ficheiro temporário (bytes)
+	time_t _clientHeaderTimeout;                // Tempo máximo para receber os headers (segundos)
+	time_t _keepaliveTimeout;                   // Tempo de espera por outro pedido na mesma conexão (0 = desativado)
+	size_t _keepaliveRequests;                  // Máximo de pedidos servidos por conexão
+	int _listenBacklog;                         // Backlog do listen() (listen ... backlog=N)
 	std::map<int, std::string> _errorPages;     // Error pages customizadas
 	std::vector<Route> _routes;                 // Routes/locations
 	bool _isDefaultServer;                      // É o default server para este host:port?
+	bool _gzip;                                 // Comprimir respostas (gzip/deflate)?
+	std::vector<std::string> _gzipTypes;        // Tipos MIME que são comprimidos
+	size_t _gzipMinLength;                      // Bodies mais pequenos seguem sem compressão (bytes)
+	int _gzipLevel;                             // Nível do zlib (1-9), reduzido quando o CPU está em carga
 };
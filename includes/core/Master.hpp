@@ -0,0 +1,120 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Master.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:40:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:40:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Master.hpp
+ * Process supervisor (master_process on)
+ * Forks one worker per slot, each running its own ServerManager on its own
+ * SO_REUSEPORT listeners from the ListenerPool, so the kernel spreads
+ * accepts across them. Crashed workers are respawned.
+ *   SIGINT/SIGTERM  fast stop, forwarded to all workers
+ *   SIGQUIT         graceful stop: workers stop accepting and drain
+ *   SIGHUP          reload: re-parse the config, start a new generation of
+ *                   workers on the kept listeners, drain the old one
+ *   SIGUSR1         every worker logs its event loop stats
+ *   SIGUSR2         binary upgrade: exec a new master that inherits the
+ *                   listeners (then SIGQUIT this one)
+ */
+#pragma once
+
+#include "includes/config/Config.hpp"
+#include "includes/network/ListenerPool.hpp"
+#include <csignal>
+#include <ctime>
+#include <vector>
+#include <sys/types.h>
+
+class Master {
+public:
+	/**
+	 * Constructor
+	 * @param config: Parsed configuration (copied into every worker by fork)
+	 * @param configFile: Path re-read on SIGHUP
+	 * @param argv: Command line re-exec'd on SIGUSR2
+	 * @param listeners: Listening sockets, already synced for config
+	 */
+	Master(const Config& config, const std::string& configFile, char** argv, ListenerPool& listeners);
+
+	/**
+	 * Destructor
+	 */
+	~Master();
+
+	/**
+	 * Spawn the workers and supervise them until stopped
+	 * @return: Process exit status
+	 */
+	int run();
+
+	/**
+	 * Run one event loop in the current process until SIGINT/SIGTERM
+	 * (fast) or SIGQUIT (graceful)
+	 * Used directly for master_process off, and by every forked worker
+	 * @param config: Parsed configuration
+	 * @param listeners: Listening sockets to accept on
+	 * @return: Process exit status (WORKER_INIT_FAILED if startup failed)
+	 */
+	static int serve(const Config& config, const std::vector<Socket*>& listeners);
+
+	// Exit status of a worker that could not start (not respawned)
+	static const int WORKER_INIT_FAILED = 2;
+
+private:
+	// One supervised worker process
+	struct Worker {
+		pid_t pid;          // 0 while the slot has no live process
+		time_t startedAt;   // Spawn time, used to throttle crash loops
+	};
+
+	Config _config;                // Configuration handed to workers
+	std::string _configFile;       // Re-parsed on SIGHUP
+	char** _argv;                  // Re-exec'd on SIGUSR2
+	ListenerPool& _listeners;      // Listening sockets shared by all generations
+	std::vector<Worker> _workers;  // Worker slots (index = worker number)
+	std::vector<pid_t> _retiring;  // Workers of older generations, draining
+	pid_t _upgradePid;             // New binary started by SIGUSR2 (0 if none)
+	bool _failed;                  // A worker could not start
+	bool _stopping;                // Shutdown in progress (exits are expected)
+
+	// Workers that die sooner than this after spawning are respawned with a delay
+	static const int RESPAWN_THROTTLE_SEC = 1;
+	// Grace period before workers that ignore SIGTERM are killed
+	static const int SHUTDOWN_GRACE_SEC = 10;
+
+	// Signals recorded by the master's handlers (async-signal-safe flags)
+	static volatile sig_atomic_t s_stopSignal;
+	static volatile sig_atomic_t s_childExited;
+	static volatile sig_atomic_t s_alarm;
+	static volatile sig_atomic_t s_reload;
+	static volatile sig_atomic_t s_upgrade;
+	static volatile sig_atomic_t s_stats;
+
+	static void onStopSignal(int sig);
+	static void onChildExited(int sig);
+	static void onAlarm(int sig);
+	static void onReload(int sig);
+	static void onUpgrade(int sig);
+	static void onStats(int sig);
+	static void resetChildSignals();
+
+	bool spawnWorker(size_t slot);
+	void reload();
+	void upgradeBinary();
+	void reapWorkers();
+	void signalWorkers(int sig);
+	size_t liveWorkers() const;
+	void shutdownWorkers(sigset_t* waitMask);
+
+	// Disable copy
+	Master(const Master& other);
+	Master& operator=(const Master& other);
+};
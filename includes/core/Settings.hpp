@@ -19,6 +19,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "includes/core/Instance.hpp"
 
 /**
@@ -39,7 +40,14 @@ class Settings {
 		 * @param code: Código de status HTTP (ex: 200, 404, 500)
 		 * @return: String com a mensagem do status (ex: "OK", "Not Found", "Internal Server Error")
 		 */
-		const std::string httpStatusCode(int code) const;
+		const std::string& httpStatusCode(int code) const;
+
+		/**
+		 * Obtém a linha de status pré-formatada de um código
+		 * @param code: Código de status HTTP (100 a 599)
+		 * @return: Linha completa (ex: "HTTP/1.1 404 Not Found\r\n"), vazia fora desse intervalo
+		 */
+		const std::string& httpStatusLine(int code) const;
 
 		/**
 		 * Obtém o tipo MIME baseado na extensão do arquivo
@@ -54,6 +62,21 @@ class Settings {
 		 */
 		Settings();
 
+		// Mensagem de um código (NULL se desconhecido)
+		static const char* statusMessage(int code);
+
+		// Mensagens e linhas de status de 100 a 599, preenchidas no construtor:
+		// as respostas não formatam nem alocam nada para a linha de status
+		std::vector<std::string> _statusMessages;
+		std::vector<std::string> _statusLines;
+		std::string _unknownStatus;
+		std::string _noStatusLine;
+
+		// Tabela de tipos MIME, preenchida no construtor (só leitura depois,
+		// por isso partilhada sem locks entre as threads dos event loops)
+		std::map<std::string, std::string> _mimeTypes;
+		std::string _defaultMimeType;
+
 		// Instance é friend para poder chamar o construtor privado
 		friend class Instance;
 };
@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BodySink.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:31:45 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 23:31:45 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * BodySink.hpp
+ * Destination of a request body while it is being received
+ * The parser writes the decoded payload here as it arrives (Content-Length
+ * bytes or chunk data, without the chunk framing), so the connection buffer
+ * never has to hold the whole body. Bodies up to the buffer size stay in
+ * memory; a bigger one is spooled to an unlinked temp file as soon as it
+ * outgrows it, so an upload costs at most that much memory however large.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace HTTP {
+
+class BodySink {
+public:
+	static const size_t DEFAULT_BUFFER_SIZE = 16384;    // client_body_buffer_size
+
+	BodySink();
+	~BodySink();
+
+	/**
+	 * Bytes kept in memory before spooling (0: never spool)
+	 * A setting of the sink: clear() and swap() leave it.
+	 */
+	void setBufferSize(size_t size);
+
+	/**
+	 * Decoded body bytes, in order
+	 * @return: false if the temp file could not be created or written
+	 */
+	bool write(const char* data, size_t length);
+
+	size_t size() const;
+	bool isSpooled() const;
+	int fd() const;     // Temp file of a spooled body, -1 in memory
+
+	/**
+	 * The whole body: the memory buffer, or the temp file mapped read-only
+	 * (page cache, not heap). Valid until the next write(), clear() or swap().
+	 */
+	const char* bytes() const;
+
+	// Owned copy (the whole body in memory: small bodies only)
+	std::string str() const;
+
+	/**
+	 * Exchange bodies with another sink, without copying them
+	 */
+	void swap(BodySink& other);
+
+	void clear();
+
+	static const char* TEMP_TEMPLATE;     // mkstemp() pattern of the spool files
+
+private:
+	std::string _data;          // In-memory body
+	size_t _size;
+	size_t _bufferSize;
+	int _fd;                    // Spool file (already unlinked)
+	mutable void* _map;         // Mapping handed out by bytes()
+	mutable size_t _mapSize;
+
+	bool spool();
+	void unmap() const;
+
+	BodySink(const BodySink&);
+	BodySink& operator=(const BodySink&);
+};
+
+} // namespace HTTP
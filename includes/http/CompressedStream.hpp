@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CompressedStream.hpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * CompressedStream.hpp
+ * A range of a file, compressed as it is sent, in chunked framing
+ * Each read() takes the next READ_SIZE bytes of the file and returns what
+ * zlib made of them as one chunk; the last read() ends with the last
+ * chunk. The length is not known up front, so responses carrying it are
+ * chunked (HTTP/1.1 only), and memory stays bounded by the read size.
+ */
+#pragma once
+
+#include "includes/http/Compressor.hpp"
+#include "includes/network/OutputQueue.hpp"
+#include <sys/types.h>
+#include <vector>
+
+namespace HTTP {
+
+class CompressedStream : public OutputQueue::Source {
+public:
+	static const size_t READ_SIZE = 65536;
+
+	// Takes fd (closed with the stream)
+	CompressedStream(int fd, off_t offset, size_t length, Compressor::Encoding encoding, int level);
+	~CompressedStream();
+
+	bool read(std::string& out);
+	bool done() const;
+
+private:
+	int _fd;
+	off_t _offset;
+	size_t _left;               // File bytes not read yet
+	Compressor _compressor;
+	bool _started;
+	bool _done;
+	std::vector<char> _buffer;  // File bytes of one read
+	std::string _payload;       // Their compressed form
+
+	CompressedStream(const CompressedStream&);
+	CompressedStream& operator=(const CompressedStream&);
+};
+
+} // namespace HTTP
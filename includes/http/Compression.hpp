@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Compression.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Compression.hpp
+ * State the compression stage shares between the loops of a process
+ * (one instance, through Instance::Get, created before the threads start):
+ *  - an LRU cache of compressed static files, keyed by coding and ETag, so
+ *    a file is compressed once per version rather than once per request;
+ *  - the level actually used, lowered from the configured one while the
+ *    machine's CPUs are busy. Load is sampled from /proc/stat at most once
+ *    a second and the level moves one step at a time, with a gap between
+ *    the thresholds so it does not flap around a single value.
+ */
+#pragma once
+
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+#include <pthread.h>
+
+namespace HTTP {
+
+class Compression {
+public:
+	static const int BUSY_HIGH = 85;    // % CPU busy: back off one step
+	static const int BUSY_LOW = 60;     // % CPU busy: recover one step
+	static const int MAX_STEP = 3;      // Level halved per step; at MAX_STEP only the cache is used
+
+	Compression();
+	~Compression();
+
+	void setCacheSize(size_t bytes);
+	// Largest compressed file kept (bigger ones are streamed, not cached)
+	size_t maxEntrySize() const;
+
+	// Copy of a cached body; false if absent
+	bool lookup(const std::string& key, std::string& out);
+	void store(const std::string& key, const std::string& data);
+
+	/**
+	 * Level to compress with now, for a configured zlib level
+	 * @return: 1..configured, or 0 when the CPUs are too busy to compress
+	 */
+	int level(int configured);
+
+private:
+	struct Entry {
+		std::string key;
+		std::string data;
+	};
+	typedef std::list<Entry> EntryList;
+
+	pthread_mutex_t _mutex;
+	EntryList _entries;                             // Most recently used first
+	std::map<std::string, EntryList::iterator> _index;
+	size_t _cacheSize;
+	size_t _cacheUsed;
+
+	time_t _sampledAt;
+	unsigned long long _lastBusy;   // /proc/stat jiffies at the previous sample
+	unsigned long long _lastTotal;
+	int _step;
+
+	void evict(size_t needed);
+	void sampleLoad(time_t now);
+
+	Compression(const Compression&);
+	Compression& operator=(const Compression&);
+};
+
+} // namespace HTTP
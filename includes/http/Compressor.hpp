@@ -0,0 +1,71 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Compressor.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Compressor.hpp
+ * gzip/deflate content coding on top of zlib
+ * Picks the coding from Accept-Encoding and compresses a body in one call
+ * or as a stream of pieces. Without zlib (make GZIP=off) isAvailable() is
+ * false, negotiate() always answers identity and nothing is compressed.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace HTTP {
+
+class Compressor {
+public:
+	enum Encoding {
+		ENCODING_IDENTITY,
+		ENCODING_GZIP,      // RFC 1952
+		ENCODING_DEFLATE    // zlib stream (RFC 1950), what "deflate" means in HTTP
+	};
+
+	Compressor();
+	~Compressor();
+
+	static bool isAvailable();
+
+	/**
+	 * Coding to answer an Accept-Encoding value with: the one with the
+	 * highest q (gzip on ties); "*" covers the codings not named; q=0
+	 * refuses one. Identity when nothing better is acceptable.
+	 */
+	static Encoding negotiate(const char* acceptEncoding, size_t size);
+
+	// Content-Encoding token ("gzip", "deflate"; "" for identity)
+	static const char* name(Encoding encoding);
+
+	// Whole body at once; appended to out
+	static bool compress(Encoding encoding, int level, const char* data, size_t length, std::string& out);
+
+	/**
+	 * Stream: begin(), write() as the data comes, finish() once; the
+	 * compressed bytes produced so far are appended to out each time
+	 */
+	bool begin(Encoding encoding, int level);
+	bool write(const char* data, size_t length, std::string& out);
+	bool finish(std::string& out);
+
+private:
+	void* _stream;      // z_stream while a stream is open
+
+	bool run(const char* data, size_t length, bool last, std::string& out);
+	void end();
+
+	Compressor(const Compressor&);
+	Compressor& operator=(const Compressor&);
+};
+
+} // namespace HTTP
@@ -0,0 +1,195 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventLoop.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 15:10:37 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 15:10:37 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * EventLoop.hpp
+ * One reactor: a Poller, a dispatch table, a timer wheel and the client
+ * connections it owns. Every Connection lives and dies on the thread that
+ * runs its loop; other threads only hand new sockets over through post().
+ */
+#pragma once
+
+#include "includes/config/Config.hpp"
+#include "includes/network/Socket.hpp"
+#include "includes/network/Connection.hpp"
+#include "includes/network/Poller.hpp"
+#include "includes/utils/LoopStats.hpp"
+#include "includes/utils/SpscQueue.hpp"
+#include "includes/utils/TimerWheel.hpp"
+#include <csignal>
+#include <vector>
+#include <netinet/in.h>
+
+namespace HTTP {
+	class ServerManager;
+
+	class EventLoop {
+	public:
+		// Accepted socket handed from the acceptor to a loop
+		struct Handoff {
+			int fd;
+			struct sockaddr_in addr;
+			const Server* server;
+		};
+
+		/**
+		 * Constructor
+		 * @param acceptor: ServerManager that accepts on listeners registered here
+		 * @param id: Loop number (for logs)
+		 */
+		EventLoop(ServerManager* acceptor, size_t id);
+
+		/**
+		 * Destructor (closes every connection still owned by the loop)
+		 */
+		~EventLoop();
+
+		/**
+		 * Create the event backend and the wakeup channel
+		 * @param backendName: events { use ...; } value, empty for the default
+		 * @return: true on success
+		 */
+		bool init(const std::string& backendName);
+
+		/**
+		 * Watch a listening socket; its events go to the acceptor
+		 */
+		bool addListener(Socket* listener);
+
+		/**
+		 * Run the loop until stop() (blocking, on the owning thread)
+		 */
+		void run();
+
+		/**
+		 * Stop the loop (any thread, async-signal-safe)
+		 */
+		void stop();
+
+		/**
+		 * Graceful stop (any thread, async-signal-safe): close the listeners,
+		 * then return from run() once the loop owns no connection
+		 */
+		void drain();
+
+		/**
+		 * Ask the loop to call ServerManager::dumpStats() from its own thread
+		 * (any thread, async-signal-safe)
+		 */
+		void requestStats();
+
+		/**
+		 * Phase timings of this loop (read them with LoopStats::snapshot)
+		 */
+		const LoopStats& getStats() const;
+
+		/**
+		 * Take ownership of an accepted socket (owning thread only)
+		 * It is registered once the current event batch is dispatched
+		 * @return: true (the socket is owned by the loop from now on)
+		 */
+		bool adopt(int fd, const struct sockaddr_in& addr, const Server* server);
+
+		/**
+		 * Hand an accepted socket over to this loop (acceptor thread only)
+		 * @return: false if the hand-off queue is full
+		 */
+		bool post(const Handoff& handoff);
+
+		/**
+		 * Connections owned or queued for this loop (any thread)
+		 */
+		size_t load() const;
+
+		size_t getId() const;
+		const char* getBackendName() const;
+
+	private:
+		// Kind of file descriptor stored in the dispatch table
+		enum FdKind {
+			FD_NONE,      // Free slot
+			FD_LISTENER,  // Listening socket (accept new clients)
+			FD_CLIENT,    // Client connection
+			FD_WAKEUP     // Hand-off / stop notifications
+		};
+
+		// Dispatch table entry (indexed by fd)
+		struct FdSlot {
+			FdKind kind;
+			union {
+				Socket* listener;
+				Connection* connection;
+			};
+		};
+
+		ServerManager* _acceptor;                 // Accepts on FD_LISTENER events
+		size_t _id;                               // Loop number
+		Poller* _poller;                          // Event backend (poll/epoll/io_uring)
+		std::vector<Poller::Event> _readyEvents;  // Ready fds of the current iteration
+		std::vector<FdSlot> _fdTable;             // fd -> handler (O(1) dispatch)
+		TimerWheel _timers;                       // Connection/header timeouts
+		SpscQueue<Handoff> _handoffs;             // Sockets posted by the acceptor
+		std::vector<Handoff> _adopted;            // Sockets accepted by this loop, not yet registered
+		int _wakeReadFd;                          // eventfd (or pipe read end)
+		int _wakeWriteFd;                         // Same eventfd (or pipe write end)
+		int _wakePending;                         // A wakeup is already in flight (atomic)
+		size_t _load;                             // Owned + queued connections (atomic)
+		volatile sig_atomic_t _running;           // Cleared by stop() (atomic: any thread)
+		volatile sig_atomic_t _draining;          // Set by drain() (atomic: any thread)
+		bool _drainStarted;                       // Listeners closed (loop thread only)
+		bool _handoffsPending;                    // Register new sockets after the batch
+		volatile sig_atomic_t _statsRequested;    // Set by requestStats()
+		LoopStats _stats;                         // Per-phase timings
+		unsigned long long _phaseMark;            // End of the last timed phase (us)
+
+		// Upper bound for one wait, so signals that raced the wait are noticed
+		static const int MAX_WAIT_MS = 1000;
+		// Sockets that may wait in the hand-off queue
+		static const size_t HANDOFF_CAPACITY = 4096;
+		// Handling one request for longer than this stalls the loop: log it
+		static const unsigned long long SLOW_HANDLE_US = 100000;
+
+		// Setup
+		bool setupPoller(const std::string& backendName);
+		bool setupWakeup();
+		void wake();
+		void drainWakeup();
+		void drainHandoffs();
+		void closeListeners();
+		void closeIdleConnections();
+
+		// Interest management
+		void updateInterest(Connection* conn);
+		static short interestFor(const Connection* conn);
+
+		// Dispatch table
+		FdSlot& slotFor(int fd);
+		void clearSlot(int fd);
+
+		// Instrumentation
+		unsigned long long phaseDone(LoopStats::Phase phase);
+
+		// Event handling
+		bool registerConnection(int fd, const struct sockaddr_in& addr, const Server* server);
+		void dispatchEvent(const Poller::Event& event);
+		void handleClientSocket(Connection* conn, const Poller::Event& event);
+		void closeConnection(int fd);
+
+		// Cleanup
+		void expireTimers();
+		void cleanupAllConnections();
+
+		// Disable copy
+		EventLoop(const EventLoop& other);
+		EventLoop& operator=(const EventLoop& other);
+	};
+}
@@ -0,0 +1,147 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   HeaderTable.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:18:40 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 22:18:40 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * HeaderTable.hpp
+ * Flat header storage shared by Request and Response
+ * All names and values live in one byte buffer; the entries are offsets into
+ * it, kept in insertion order (the first INLINE_ENTRIES inside the object).
+ * Well-known headers get an Id once, when they are added, and are then found
+ * through a per-Id index: no lowercase copies, no allocation on lookup.
+ * Their names are not stored (canonicalName() gives the usual spelling).
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace HTTP {
+
+class HeaderTable {
+public:
+	enum Id {
+		HEADER_OTHER,             // Not a well-known header: looked up by name
+		HEADER_ACCEPT_ENCODING,
+		HEADER_ACCEPT_RANGES,
+		HEADER_ALLOW,
+		HEADER_CACHE_CONTROL,
+		HEADER_CONNECTION,
+		HEADER_CONTENT_ENCODING,
+		HEADER_CONTENT_LENGTH,
+		HEADER_CONTENT_RANGE,
+		HEADER_CONTENT_TYPE,
+		HEADER_COOKIE,
+		HEADER_DATE,
+		HEADER_ETAG,
+		HEADER_EXPECT,
+		HEADER_HOST,
+		HEADER_IF_MODIFIED_SINCE,
+		HEADER_IF_NONE_MATCH,
+		HEADER_IF_RANGE,
+		HEADER_KEEP_ALIVE,
+		HEADER_LAST_MODIFIED,
+		HEADER_LOCATION,
+		HEADER_RANGE,
+		HEADER_RETRY_AFTER,
+		HEADER_SERVER,
+		HEADER_TRANSFER_ENCODING,
+		HEADER_USER_AGENT,
+		HEADER_VARY,
+		HEADER_COUNT
+	};
+
+	// Entries stored inside the object before spilling to the heap
+	static const size_t INLINE_ENTRIES = 16;
+
+	HeaderTable();
+
+	/**
+	 * Append a header (repeats are kept; lookups see the last one)
+	 * @param id: lookup(name) if known, HEADER_OTHER otherwise
+	 */
+	void add(Id id, const char* name, size_t nameLength, const char* value, size_t valueLength);
+
+	/**
+	 * Replace the value of a header, or add it
+	 */
+	void set(Id id, const std::string& value);
+	void set(Id id, const char* value, size_t length);
+	void set(const std::string& name, const std::string& value);
+
+	// Drop every entry of a header
+	void remove(Id id);
+
+	// Lookups (last entry wins)
+	bool has(Id id) const;
+	bool has(const std::string& name) const;
+	std::string get(Id id) const;
+	std::string get(const std::string& name) const;
+
+	/**
+	 * Value of a header without copying it, valid until the table changes
+	 * @return NULL (length 0) if absent
+	 */
+	const char* peek(Id id, size_t& length) const;
+
+	// Exact comparison of a header's value with a span (false if absent)
+	bool valueIs(Id id, const char* value, size_t length) const;
+
+	/**
+	 * Case-insensitive comparison of a header's value (false if absent)
+	 */
+	bool valueEquals(Id id, const char* word) const;
+
+	// Entries in insertion order
+	size_t size() const;
+	Id id(size_t index) const;
+	std::string name(size_t index) const;
+	std::string value(size_t index) const;
+
+	/**
+	 * Append every entry as "Name: value\r\n"
+	 */
+	void appendTo(std::string& out) const;
+
+	// Size the byte buffer for the headers to come
+	void reserve(size_t bytes);
+	void clear();
+
+	// Id of a header name (any case), HEADER_OTHER if not well-known
+	static Id lookup(const char* name, size_t length);
+	static const char* canonicalName(Id id);
+
+private:
+	struct Entry {
+		Id id;
+		size_t nameOffset;      // Unused for well-known headers
+		size_t nameLength;
+		size_t valueOffset;
+		size_t valueLength;
+	};
+
+	std::string _data;                  // Names and values, back to back
+	Entry _inline[INLINE_ENTRIES];
+	std::vector<Entry> _overflow;       // Entries past INLINE_ENTRIES
+	size_t _count;
+	unsigned short _index[HEADER_COUNT];   // Entry + 1 of each well-known header (0 if absent)
+
+	Entry& entry(size_t index);
+	const Entry& entry(size_t index) const;
+	size_t find(Id id, const std::string& name) const;
+	void setValue(Entry& target, const char* value, size_t length);
+	void rebuildIndex();
+
+	static bool equalsIgnoreCase(const char* a, const char* b, size_t length);
+};
+
+} // namespace HTTP
@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Method.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:52:06 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 22:52:06 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Method.hpp
+ * Request methods the server implements
+ * The request line's method is turned into an Id once, by the parser;
+ * routes keep the methods they accept as a mask of bit(Id).
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace HTTP {
+
+class Method {
+public:
+	enum Id {
+		METHOD_UNKNOWN,     // Valid token, not implemented (501)
+		METHOD_GET,
+		METHOD_HEAD,
+		METHOD_POST,
+		METHOD_PUT,
+		METHOD_DELETE,
+		METHOD_OPTIONS,
+		METHOD_COUNT
+	};
+
+	// Every implemented method, as a mask
+	static const unsigned int ALL = ((1u << METHOD_COUNT) - 1) & ~1u;
+
+	// Id of a method name (case-sensitive), METHOD_UNKNOWN if not implemented
+	static Id lookup(const char* name, size_t length);
+	static Id lookup(const std::string& name);
+
+	static const char* name(Id id);
+
+	static unsigned int bit(Id id) { return 1u << id; }
+
+	/**
+	 * Methods of a mask as an Allow header value ("GET, HEAD, POST")
+	 */
+	static std::string list(unsigned int mask);
+};
+
+} // namespace HTTP
@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ParamList.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:10:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 23:10:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ParamList.hpp
+ * Decoded key=value pairs of a query string or urlencoded form body
+ * Every key and value is percent-decoded once, back to back, into one buffer;
+ * the entries are offsets into it, in the order they were sent.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace HTTP {
+
+class ParamList {
+public:
+	ParamList();
+
+	/**
+	 * Split "a=1&b=2" on '&' and '=' and decode each part
+	 * Replaces what the list held before.
+	 */
+	void parse(const char* data, size_t length);
+	void parse(const std::string& data);
+
+	// Lookups (last pair wins, like repeated keys did in a map)
+	bool has(const std::string& name) const;
+	std::string get(const std::string& name) const;
+
+	// Pairs in the order they were sent
+	size_t size() const;
+	std::string key(size_t index) const;
+	std::string value(size_t index) const;
+
+	void clear();
+
+	/**
+	 * Append data with %XX escapes and '+' decoded
+	 * Malformed escapes are kept as they are.
+	 */
+	static void decode(const char* data, size_t length, std::string& out);
+
+private:
+	struct Entry {
+		size_t keyOffset;
+		size_t keyLength;
+		size_t valueOffset;
+		size_t valueLength;
+	};
+
+	std::string _data;              // Decoded keys and values, back to back
+	std::vector<Entry> _entries;
+
+	size_t find(const std::string& name) const;
+};
+
+} // namespace HTTP
@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RangeSet.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 06:25:09 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 06:25:09 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * RangeSet.hpp
+ * Byte ranges of a Range header, resolved against the size of a file
+ * "bytes=0-99, 200-, -500" becomes absolute [first, last] pairs, sorted by
+ * offset with overlapping or adjacent ones merged, so no byte of the file is
+ * sent twice (a "0-,0-,0-,..." set cannot multiply the response, CVE-2011-3192);
+ * ranges starting past the end are left out. A header that is not a valid
+ * bytes range set is ignored as a whole (RFC 9110 14.2).
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace HTTP {
+
+class RangeSet {
+public:
+	// More ranges than this and the whole file is sent instead
+	static const size_t MAX_RANGES = 32;
+
+	enum Result {
+		RANGES_IGNORED,         // No usable Range: 200 with the whole file
+		RANGES_SATISFIABLE,     // At least one range overlaps the file: 206
+		RANGES_UNSATISFIABLE    // Valid, but none overlaps it: 416
+	};
+
+	RangeSet();
+
+	/**
+	 * Resolve a Range header value; replaces what the set held before
+	 * @param size: Size of the file the ranges select from
+	 */
+	Result parse(const char* header, size_t headerLength, size_t size);
+
+	size_t size() const;
+	size_t first(size_t index) const;
+	size_t last(size_t index) const;
+	size_t length(size_t index) const;
+	size_t totalLength() const;     // Bytes of all ranges together
+
+	void clear();
+
+private:
+	struct Range {
+		size_t first;
+		size_t last;
+	};
+
+	std::vector<Range> _ranges;
+
+	static bool parseNumber(const char*& pos, const char* end, size_t& value);
+	static bool startsBefore(const Range& a, const Range& b);
+	void coalesce();
+};
+
+} // namespace HTTP
@@ -17,8 +17,11 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <vector>
+#include "includes/http/HeaderTable.hpp"
+#include "includes/http/Method.hpp"
+#include "includes/http/ParamList.hpp"
+#include "includes/http/RequestParser.hpp"
 
 namespace HTTP {
 
@@ -29,34 +32,40 @@ public:
 	~Request();
 
 	// Parsing
-	bool parse(const std::string& rawRequest);
+	bool parse(const std::string& rawRequest);                         // Whole request in one string
+	void load(RequestParser& parser, const std::string& buffer);       // After parser.feed() == DONE (takes the body)
+	void loadHead(const RequestParser& parser, const std::string& buffer); // Once parser.headComplete(), no body yet
 	bool isComplete() const;
 
 	// Getters
 	const std::string& getMethod() const;
+	Method::Id getMethodId() const;
 	const std::string& getUri() const;
 	const std::string& getPath() const;
 	const std::string& getQuery() const;
 	const std::string& getVersion() const;
-	const std::map<std::string, std::string>& getHeaders() const;
+	const HeaderTable& getHeaders() const;
+	const HeaderTable& getTrailers() const;     // Fields after a chunked body
 	std::string getHeader(const std::string& name) const;
-	const std::string& getBody() const;
+	std::string getHeader(HeaderTable::Id id) const;
+	const BodySink& getBody() const;      // In memory, or spooled to a temp file
 
 	// Content properties
 	size_t getContentLength() const;
 	std::string getContentType() const;
 	bool hasHeader(const std::string& name) const;
+	bool hasHeader(HeaderTable::Id id) const;
 	bool isChunked() const;
 
 	// Connection properties
 	bool keepAlive() const;
 
-	// Query string helpers
-	std::map<std::string, std::string> getQueryParams() const;
+	// Query string helpers (parsed on first use, once per request)
+	const ParamList& getQueryParams() const;
 	std::string getQueryParam(const std::string& name) const;
 
-	// Form data helpers (application/x-www-form-urlencoded)
-	std::map<std::string, std::string> getFormData() const;
+	// Form data helpers (application/x-www-form-urlencoded, parsed on first use)
+	const ParamList& getFormData() const;
 	std::string getFormField(const std::string& name) const;
 
 	// Multipart helpers
@@ -72,16 +81,18 @@ public:
 private:
 	// Request line
 	std::string _method;     // GET, POST, DELETE, etc.
+	Method::Id _methodId;    // Resolved by the parser
 	std::string _uri;        // Full URI (/path?query)
 	std::string _path;       // Path part (/path)
 	std::string _query;      // Query string (query)
 	std::string _version;    // HTTP/1.1
 
 	// Headers
-	std::map<std::string, std::string> _headers;
+	HeaderTable _headers;
+	HeaderTable _trailers;
 
 	// Body
-	std::string _body;
+	BodySink _body;
 
 	// Parsing state
 	bool _complete;
@@ -89,20 +100,15 @@ private:
 	bool _hasContentLength;
 	bool _isChunked;
 
-	// Limits (RFC 7230)
-	static const size_t MAX_URI_LENGTH = 8192;
-	static const size_t MAX_HEADER_SIZE = 8192;
-	static const size_t MAX_HEADERS_COUNT = 100;
+	// Decoded parameters, filled by the first getter that needs them
+	mutable ParamList _queryParams;
+	mutable ParamList _formData;
+	mutable bool _queryParsed;
+	mutable bool _formParsed;
 
 	// Parsing helpers
-	bool parseRequestLine(const std::string& line);
-	bool parseHeader(const std::string& line);
 	void parseUri(const std::string& uri);
-	bool parseChunkedBody(const std::string& rawBody);
-	std::string decodeChunkedBody(const std::string& chunkedData);
 	std::string urlDecode(const std::string& str) const;
-	std::string toLowerCase(const std::string& str) const;
-	std::string trim(const std::string& str) const;
 };
 
 } // namespace HTTP
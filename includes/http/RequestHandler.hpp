@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <sys/stat.h>
 #include "Request.hpp"
 #include "Response.hpp"
 #include "includes/config/Server.hpp"
@@ -23,6 +24,8 @@
 
 namespace HTTP {
 
+class RangeSet;
+
 class RequestHandler {
 public:
 	// Constructor
@@ -32,13 +35,32 @@ public:
 	// Handle request
 	Response handle(const Request& request);
 
+	/**
+	 * Judge a request from its head alone (Expect: 100-continue)
+	 * @param rejection: Final response when it would be refused anyway
+	 * @return: true if the body is worth receiving
+	 */
+	bool checkHead(const Request& request, Response& rejection);
+
 private:
 	const Server* _server;
 
+	// Route lookup and method dispatch (handle() drops the body for HEAD)
+	Response dispatch(const Request& request);
+
+	// Content coding of the final response (gzip directives, Accept-Encoding)
+	void compress(const Request& request, Response& response);
+
+	// Route of a request, or NULL with the final response (501, 404, 405, 301)
+	const Route* admit(const Request& request, Response& early);
+	bool isCgiScript(const std::string& filePath, const Route* route);
+
 	// Method handlers
-	Response handleGet(const Request& request, const Route* route);
+	Response handleGet(const Request& request, const Route* route);   // GET and HEAD
 	Response handlePost(const Request& request, const Route* route);
+	Response handlePut(const Request& request, const Route* route);
 	Response handleDelete(const Request& request, const Route* route);
+	Response handleOptions(unsigned int allowed);
 
 	// Helper methods
 	std::string resolveFilePath(const std::string& path, const Route* route);
@@ -49,26 +71,33 @@ private:
 	std::string generateDirectoryListing(const std::string& path, const std::string& requestPath);
 	bool hasWritePermission(const std::string& path);
 	bool hasReadPermission(const std::string& path);
-	std::string generateETag(const std::string& filePath);
+	std::string generateETag(const struct stat& fileStat);
+
+	// Range requests (GET on a regular file)
+	bool ifRangeHolds(const Request& request, const Response& response);
+	bool setRangeBody(Response& response, int fd, const RangeSet& ranges, size_t size, bool zeroCopy);
+	std::string contentRange(size_t first, size_t last, size_t size);
 
 	// POST helpers
 	Response handleFormData(const Request& request, const Route* route);
 	Response handleFileUpload(const Request& request, const Route* route);
 	Response handleCGI(const Request& request, const Route* route, const std::string& scriptPath);
-	std::string saveUploadedFile(const std::string& content, const std::string& filename, const std::string& uploadDir);
+	std::string saveUploadedFile(const char* content, size_t length, const std::string& filename, const std::string& uploadDir);
 
 	// Multipart parsing
 	struct UploadedFile {
 		std::string filename;
 		std::string contentType;
-		std::string content;
+		const char* content;        // Inside the request body (not copied)
+		size_t contentLength;
 	};
-	std::vector<UploadedFile> parseMultipartData(const std::string& body, const std::string& boundary);
+	std::vector<UploadedFile> parseMultipartData(const char* data, size_t size, const std::string& boundary);
 
 	// Error responses
 	Response notFound(const std::string& path);
 	Response forbidden(const std::string& path);
-	Response methodNotAllowed(const std::string& method);
+	Response rangeNotSatisfiable(size_t size);
+	Response methodNotAllowed(const std::string& method, unsigned int allowed);
 	Response notImplemented(const std::string& method);
 	Response internalServerError(const std::string& message);
 };
@@ -0,0 +1,182 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RequestParser.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:41:08 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 20:41:08 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * RequestParser.hpp
+ * Incremental HTTP/1.1 request parser (byte-level state machine)
+ * Works on the connection's own buffer: feed() resumes where the previous
+ * call stopped, so each byte is looked at once however the request is split
+ * across reads. The request line and headers are recorded as offsets (Span)
+ * into the buffer; strings are only built when asked for (str()). The body
+ * is decoded into a BodySink as it arrives, so its bytes can be dropped from
+ * the buffer (dropBody()) while the rest is still being received.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "includes/http/BodySink.hpp"
+#include "includes/http/HeaderTable.hpp"
+#include "includes/http/Method.hpp"
+
+namespace HTTP {
+
+class RequestParser {
+public:
+	enum Result {
+		NEED_MORE,    // Request incomplete, call feed() again after the next read
+		DONE,         // One full request parsed (end() is where it stops)
+		FAILED        // Malformed request (see errorStatus())
+	};
+
+	// Bytes of the current request: [offset, offset + length) past start()
+	struct Span {
+		size_t offset;
+		size_t length;
+	};
+
+	struct HeaderSpan {
+		Span name;
+		Span value;     // Without surrounding whitespace
+		HeaderTable::Id id;     // Resolved once, when the name ends
+	};
+
+	// Limits (RFC 7230)
+	static const size_t MAX_METHOD_LENGTH = 32;
+	static const size_t MAX_URI_LENGTH = 8192;
+	static const size_t MAX_HEADER_SIZE = 8192;
+	static const size_t MAX_HEADERS_COUNT = 100;
+
+	RequestParser();
+
+	/**
+	 * Largest body accepted (0: no limit); bigger ones fail with 413
+	 * Kept across reset().
+	 */
+	void setMaxBodySize(size_t size);
+
+	// Body bytes kept in memory before the sink spools them to a temp file
+	void setBodyBufferSize(size_t size);
+
+	/**
+	 * Start a new request
+	 * @param start: Offset in the buffer where it begins (after the previous one)
+	 */
+	void reset(size_t start = 0);
+
+	/**
+	 * The bytes before start() were erased from the buffer
+	 */
+	void rebase();
+
+	/**
+	 * Erase the body bytes already written to the sink from the buffer
+	 * (the head stays, its spans are still needed)
+	 */
+	void dropBody(std::string& buffer);
+
+	/**
+	 * Parse the bytes appended to the buffer since the last call
+	 * @param buffer: Connection buffer (only ever appended to meanwhile)
+	 * @return: NEED_MORE, DONE or FAILED
+	 */
+	Result feed(const std::string& buffer);
+
+	// Position in the buffer
+	size_t start() const;
+	size_t end() const;             // One past the last byte of a DONE request
+	bool headComplete() const;      // Past the empty line (receiving the body, or DONE)
+
+	// Parsed request (valid once DONE)
+	const Span& method() const;
+	Method::Id methodId() const;    // METHOD_UNKNOWN if not implemented
+	const Span& target() const;
+	const Span& version() const;
+	const std::vector<HeaderSpan>& headers() const;
+	const std::vector<HeaderSpan>& trailers() const;    // Fields after the last chunk
+	BodySink& body();
+	const BodySink& body() const;
+	size_t bodyLength() const;
+	bool hasContentLength() const;
+	size_t contentLength() const;
+	bool isChunked() const;
+	bool expectsContinue() const;   // HTTP/1.1 head with Expect: 100-continue
+
+	// Status code for a FAILED request (400, 413, 414, 431, 500 or 501)
+	int errorStatus() const;
+
+	/**
+	 * Owned copy of a span (the only place the parser allocates strings)
+	 */
+	std::string str(const std::string& buffer, const Span& span) const;
+
+private:
+	enum State {
+		S_START,            // Empty lines before the request line
+		S_METHOD,
+		S_BEFORE_TARGET,
+		S_TARGET,
+		S_BEFORE_VERSION,
+		S_VERSION,
+		S_HEADER_START,     // Start of a header line or the empty line
+		S_HEADER_NAME,
+		S_BEFORE_VALUE,
+		S_HEADER_VALUE,
+		S_BODY,             // Content-Length bytes
+		S_CHUNK_SIZE,
+		S_CHUNK_EXTENSION,
+		S_CHUNK_DATA,
+		S_CHUNK_DATA_END,   // CRLF after the chunk data
+		S_DONE,
+		S_ERROR
+	};
+
+	State _state;
+	size_t _start;          // Buffer offset of the request
+	size_t _pos;            // Next byte to look at (relative to _start)
+	size_t _mark;           // Start of the current token (relative)
+	size_t _lineStart;      // Start of the current header line (relative)
+	size_t _valueEnd;       // End of the header value so far, whitespace excluded
+	bool _sawCr;            // Last byte was a CR, an LF must follow
+	bool _inTrailer;        // Header states are reading the trailer fields
+	size_t _headEnd;        // End of the head (relative): body bytes follow
+	size_t _maxBodySize;
+	int _errorStatus;
+
+	Span _method;
+	Method::Id _methodId;
+	Span _target;
+	Span _version;
+	std::vector<HeaderSpan> _headers;
+	std::vector<HeaderSpan> _trailers;
+	BodySink _body;
+	size_t _bodyLength;
+	size_t _remaining;      // Body or chunk bytes still expected
+	bool _hasContentLength;
+	size_t _contentLength;
+	bool _chunked;
+	bool _expectContinue;
+	bool _chunkDigits;      // At least one hex digit in the chunk size
+
+	Result fail(int status);
+	std::vector<HeaderSpan>& fields();
+	bool endHeader(const char* data);
+	bool endHeaders();
+	bool endChunkSize();
+	bool takeBytes(const char* data, size_t available);
+
+	static bool equalsIgnoreCase(const char* data, const Span& span, const char* word);
+	static Span makeSpan(size_t from, size_t to);
+};
+
+} // namespace HTTP
@@ -17,8 +17,13 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <sstream>
+#include <vector>
+#include <sys/types.h>
+#include "includes/http/HeaderTable.hpp"
+#include "includes/http/Compressor.hpp"
+
+class OutputQueue;
 
 namespace HTTP {
 
@@ -26,6 +31,8 @@ class Response {
 public:
 	// Constructor
 	Response();
+	Response(const Response& other);
+	Response& operator=(const Response& other);
 	~Response();
 
 	// Status
@@ -34,6 +41,8 @@ public:
 
 	// Headers
 	void setHeader(const std::string& name, const std::string& value);
+	void setHeader(HeaderTable::Id id, const std::string& value);
+	void removeHeader(HeaderTable::Id id);
 	void setContentType(const std::string& contentType);
 	void setContentLength(size_t length);
 	void setLastModified(time_t mtime);
@@ -43,20 +52,61 @@ public:
 	// Body
 	void setBody(const std::string& body);
 	void appendBody(const std::string& chunk);
+	void swapBody(std::string& body);   // body gets the previous one
+	void omitBody();    // HEAD: headers (Content-Length included) without the body
+
+	/**
+	 * Body read from a file as it is sent, never loaded here
+	 * The response owns fd (copies dup() it) and hands it to the output
+	 * queue in serialize().
+	 * @param zeroCopy: sendfile() it (the location's `sendfile`)
+	 */
+	void setBodyFile(int fd, off_t offset, size_t length, bool zeroCopy = true);
+
+	// Text, then a range of the body file (length 0: the text alone)
+	struct FilePart {
+		std::string text;
+		off_t offset;
+		size_t length;
+	};
+
+	// Body made of several ranges of one file (multipart/byteranges)
+	void setBodyFile(int fd, const std::vector<FilePart>& parts, bool zeroCopy = true);
+
+	// Whole file body read into out (false if it came up short)
+	bool readBodyFile(std::string& out) const;
+
+	/**
+	 * Send the file body compressed as it goes out, in chunks (its
+	 * compressed length is unknown): Content-Encoding is set and
+	 * Content-Length dropped. A single range of the file only.
+	 */
+	void streamCompressed(Compressor::Encoding encoding, int level);
 
 	// Chunked transfer encoding
 	void setChunked(bool chunked);
-	std::string buildChunkedResponse() const;
 
 	// Connection
 	void setKeepAlive(bool keepAlive);
 
-	// Build response string
+	/**
+	 * Queue for sending: the head is written in place into the queue's
+	 * text, the body is handed over (string swapped, file fd moved) and
+	 * any chunk framing goes around it; this response is left without a
+	 * body. Nothing here goes through iostreams.
+	 */
+	void serialize(OutputQueue& out);
+
+	// Build response string (copies the body; serialize() is the hot path)
 	std::string build() const;
 
 	// Getters
 	int getStatusCode() const;
+	const HeaderTable& getHeaders() const;
+	std::string getHeader(HeaderTable::Id id) const;
 	const std::string& getBody() const;
+	size_t getBodyLength() const;
+	bool hasFileBody() const;
 
 	// Common responses
 	static Response errorResponse(int code, const std::string& message = "");
@@ -68,12 +118,25 @@ public:
 private:
 	int _statusCode;
 	std::string _statusMessage;
-	std::map<std::string, std::string> _headers;
+	HeaderTable _headers;
 	std::string _body;
+	int _bodyFd;        // File body (-1: _body)
+	std::vector<FilePart> _bodyParts;
+	bool _bodyZeroCopy;
+	Compressor::Encoding _bodyEncoding;    // streamCompressed() coding of the file body
+	int _bodyLevel;
 	bool _chunked;
+	bool _bodyOmitted;
 
 	// Get status message for code
-	std::string getStatusMessage(int code) const;
+	const std::string& getStatusMessage(int code) const;
+	size_t bodyLength() const;
+	void queueFileParts(OutputQueue& out);
+	void closeBodyFile();
+	// Status line, headers and blank line; the chunk size line when chunked
+	void writeHead(std::string& out) const;
+	// Chunked only: end of the chunk (of length bytes) and the last chunk
+	void writeTail(std::string& out, size_t length) const;
 	std::string formatHttpDate(time_t time) const;
 };
 
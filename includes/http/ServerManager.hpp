@@ -13,17 +13,20 @@
 /**
  * ServerManager.hpp
  * HTTP Server Manager class for handling web server operations
- * Manages multiple listening sockets and client connections using poll()
+ * Accepts on the listening sockets it is given (the acceptor part) and owns
+ * one EventLoop per worker thread (the per-loop part). Loop #0 runs on the calling thread
+ * and also watches the listeners; accepted sockets go to the least-loaded loop.
  */
 #pragma once
 
 #include "includes/config/Config.hpp"
 #include "includes/network/Socket.hpp"
-#include "includes/network/Connection.hpp"
+#include "includes/http/EventLoop.hpp"
 #include <string>
 #include <vector>
 #include <map>
-#include <poll.h>
+#include <csignal>
+#include <pthread.h>
 
 namespace HTTP {
 	class ServerManager {
@@ -41,9 +44,10 @@ namespace HTTP {
 		/**
 		 * Initialize with configuration
 		 * @param config: Parsed configuration
+		 * @param listeners: Listening sockets to accept on (owned by a ListenerPool)
 		 * @return: true if initialized successfully
 		 */
-		bool init(const Config& config);
+		bool init(const Config& config, const std::vector<Socket*>& listeners);
 
 		/**
 		 * Start the server (blocking loop)
@@ -52,41 +56,73 @@ namespace HTTP {
 		bool run();
 
 		/**
-		 * Stop the server
+		 * Stop the server (async-signal-safe: only clears flags and wakes the loops)
 		 */
 		void stop();
 
+		/**
+		 * Graceful stop: close the listeners and return from run() once every
+		 * connection is finished (async-signal-safe)
+		 */
+		void drain();
+
+		/**
+		 * Ask loop #0 to dump the stats (async-signal-safe, e.g. from SIGUSR1)
+		 */
+		void requestStats();
+
+		/**
+		 * Phase timings summed over every loop of this process (any thread)
+		 */
+		void collectStats(LoopStats& total) const;
+
+		/**
+		 * Log the phase timings of every loop, and their total
+		 * Called by loop #0 after requestStats()
+		 */
+		void dumpStats() const;
+
 		/**
 		 * Check if server is running
 		 */
 		bool isRunning() const;
 
+		/**
+		 * Accept pending clients on a listener and hand them to a loop
+		 * Called by loop #0 when a listener becomes readable
+		 */
+		void handleListeningSocket(Socket* listenSocket);
+
+		/**
+		 * Hand a socket the event backend accepted on a listener to a loop
+		 * Called by loop #0 for completion backends (io_uring)
+		 */
+		void handleAcceptedSocket(Socket* listenSocket, int clientFd);
+
 	private:
-		Config _config;                           // Server configuration
-		std::vector<Socket*> _listeningSockets;   // Listening sockets
-		std::map<int, Connection*> _connections;  // Active connections (fd -> Connection)
-		std::vector<struct pollfd> _pollFds;      // Poll file descriptors
-		bool _running;                            // Is server running?
-		time_t _timeout;                          // Connection timeout (seconds)
+		Config _config;                           // Server configuration (read-only once running)
+		std::vector<Socket*> _listeningSockets;   // Listening sockets (not owned)
+		std::vector<EventLoop*> _loops;           // One reactor per worker thread
+		std::vector<pthread_t> _threads;          // Threads running loops #1..N-1
+		size_t _nextLoop;                         // Rotating start for load ties
+		bool _overloaded;                         // At worker_connections (rejecting with 503)
+		volatile sig_atomic_t _running;           // Is server running? (cleared from signal handlers)
+		volatile sig_atomic_t _draining;          // Graceful stop requested (set from signal handlers)
 
 		// Setup
-		bool setupListeningSockets();
-		Socket* createListeningSocket(const std::string& host, int port);
-
-		// Poll management
-		void rebuildPollFds();
-		void addToPoll(int fd, short events);
-		void removeFromPoll(int fd);
-
-		// Event handling
-		void handleListeningSocket(int fd);
-		void handleClientSocket(int fd, short revents);
-		void acceptNewConnection(Socket* listenSocket);
-		void closeConnection(int fd);
-
-		// Cleanup
-		void cleanupTimedOutConnections();
-		void cleanupAllConnections();
+		bool setupLoops();
+		bool setupListeningSockets(const std::vector<Socket*>& listeners);
+
+		// Threads
+		bool startThreads();
+		void joinThreads();
+		static void* threadMain(void* arg);
+
+		// Load balancing and overload protection
+		size_t totalLoad() const;
+		EventLoop* pickLoop();
+		void placeClient(int clientFd, const struct sockaddr_in& clientAddr, const Server* server, size_t& load);
+		static void rejectOverloaded(int clientFd);
 
 		// Disable copy
 		ServerManager(const ServerManager& other);
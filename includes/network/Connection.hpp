@@ -22,6 +22,8 @@
 #include <netinet/in.h>
 #include "includes/http/Request.hpp"
 #include "includes/http/Response.hpp"
+#include "includes/network/OutputQueue.hpp"
+#include "includes/utils/TimerWheel.hpp"
 
 // Forward declarations
 class Server;
@@ -32,17 +34,39 @@ public:
 	enum State {
 		READING_REQUEST,   // Reading HTTP request from client
 		PROCESSING,        // Processing request (e.g., CGI)
-		WRITING_RESPONSE,  // Writing HTTP response to client
+		WRITING_RESPONSE,  // Responses queued, waiting for the socket
 		CLOSING            // Connection should be closed
 	};
 
+	// Timers owned by a connection (TimerWheel::Timer::kind)
+	enum TimerKind {
+		TIMER_IDLE,        // No activity on the socket
+		TIMER_HEADER,      // Request headers not received in time
+		TIMER_KEEPALIVE    // No new request on a persistent connection
+	};
+
+	// Inactivity timeout (seconds)
+	static const time_t IDLE_TIMEOUT = 60;
+
+	// Pipelined responses waiting to be written; buffered requests beyond
+	// this wait until the client reads
+	static const size_t MAX_QUEUED_RESPONSES = 32;
+
 	// Constructors
-	Connection(int fd, const struct sockaddr_in& addr, const Server* server);
+	Connection(int fd, const struct sockaddr_in& addr, const Server* server, TimerWheel* timers);
 	~Connection();
 
 	// I/O operations
-	bool readRequest();
-	bool writeResponse();
+	bool readRequest();      // recv + parse; PROCESSING once a request is complete
+	bool receive(const char* data, ssize_t length); // Parse bytes read elsewhere (0 = peer closed)
+	void processRequest();   // Queue the response; PROCESSING again if another request is buffered
+	bool writeResponse();    // writev the queue; READING_REQUEST once it is empty (keep-alive)
+	bool hasPendingOutput() const;
+	bool wantsRead() const;  // Accepting more (pipelined) requests?
+
+	// Keep-alive
+	void disableKeepAlive(); // Close after the current response (graceful stop)
+	bool isIdle() const;     // Between requests, nothing buffered
 
 	// State management
 	State getState() const;
@@ -52,12 +76,9 @@ public:
 	int getFd() const;
 	const std::string& getClientHost() const;
 	int getClientPort() const;
-	time_t getLastActivity() const;
+	unsigned long long getLastActivity() const;
 	bool shouldClose() const;
 
-	// Timeout check
-	bool isTimedOut(time_t timeout) const;
-
 	// Buffer management
 	const std::string& getRequestBuffer() const;
 	void clearRequestBuffer();
@@ -70,14 +91,21 @@ private:
 	const Server* _server;        // Associated server configuration
 
 	State _state;                 // Current connection state
-	time_t _lastActivity;         // Last activity timestamp
+	TimerWheel* _timers;          // Timer wheel of the owning event loop
+	TimerWheel::Timer _idleTimer;   // Re-armed on every read/write
+	TimerWheel::Timer _headerTimer; // Armed until the request headers are complete
+	unsigned long long _lastActivity; // Last activity timestamp (monotonic ms)
 
 	std::string _requestBuffer;   // Buffer for incoming request
-	std::string _responseBuffer;  // Buffer for outgoing response
-	size_t _responseOffset;       // Offset for partial writes
+	HTTP::RequestParser _parser;  // Incremental parser state over _requestBuffer
+	HTTP::Request _request;       // Parsed request waiting for processRequest()
+	OutputQueue _output;          // Outgoing responses, in request order, one message each
 
 	bool _keepAlive;              // Keep-alive connection?
+	bool _keepAliveAllowed;       // Cleared by disableKeepAlive()
+	size_t _requestsServed;       // Responses sent on this connection
 	bool _shouldClose;            // Should close after response?
+	bool _expectAnswered;         // Expect: 100-continue of the current request handled
 
 	// Disable copy
 	Connection(const Connection& other);
@@ -85,4 +113,9 @@ private:
 
 	// Helper methods
 	void updateActivity();
+	bool parseRequest();          // Parse the next buffered request, if complete
+	bool answerExpectation();     // 100 Continue, or the final response right away
+	void rejectRequest(const HTTP::Response& response);
+	void queueResponse(HTTP::Response& response);
+	void nextRequest();           // Reset for the next request on this connection
 };
@@ -0,0 +1,51 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollPoller.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:07:52 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:07:52 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * EpollPoller.hpp
+ * Linux epoll backend - each fd is registered once with epoll_ctl
+ * and epoll_wait only returns the fds that are ready
+ */
+#pragma once
+
+#include "includes/network/Poller.hpp"
+
+#ifdef WEBSERV_HAVE_EPOLL
+
+#include <sys/epoll.h>
+
+class EpollPoller : public Poller {
+public:
+	EpollPoller();
+	virtual ~EpollPoller();
+
+	// Was epoll_create successful?
+	bool isValid() const;
+
+	virtual bool add(int fd, short events);
+	virtual bool modify(int fd, short events);
+	virtual void remove(int fd);
+	virtual int wait(std::vector<Event>& ready, int timeoutMs);
+	virtual const char* getName() const;
+
+private:
+	int _epollFd;                              // epoll instance
+	std::vector<struct epoll_event> _events;   // epoll_wait output buffer
+
+	static const size_t MIN_EVENTS = 64;
+	static const size_t MAX_EVENTS = 4096;
+
+	static unsigned int toEpoll(short events);
+	static short fromEpoll(unsigned int events);
+};
+
+#endif // WEBSERV_HAVE_EPOLL
@@ -0,0 +1,145 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoUringPoller.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:02:48 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 16:02:48 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * IoUringPoller.hpp
+ * Linux io_uring backend (raw syscalls, no liburing)
+ * Listeners get a multishot IORING_OP_ACCEPT and connections a multishot
+ * IORING_OP_RECV into a ring of provided buffers, so the kernel accepts
+ * and reads on its own and wait() returns the sockets and bytes instead
+ * of readiness. Everything else (POLLOUT, the wakeup fd) uses one-shot
+ * IORING_OP_POLL_ADD requests that are re-armed after they fire. Sends
+ * are not submitted here: responses still go out with writev()/sendfile()
+ * from the event loop, and POLLOUT only says when to retry them. Every
+ * arm, re-arm and cancel made during an iteration is queued in the
+ * submission ring and sent together with the wait in a single
+ * io_uring_enter().
+ */
+#pragma once
+
+#include "includes/network/Poller.hpp"
+
+#ifdef WEBSERV_HAVE_IO_URING
+# include <linux/io_uring.h>
+# if !defined(IORING_FEAT_EXT_ARG) || !defined(IORING_RECV_MULTISHOT)
+// Headers older than Linux 6.0: no timed wait or multishot recv, build without io_uring
+#  undef WEBSERV_HAVE_IO_URING
+# endif
+#endif
+
+#ifdef WEBSERV_HAVE_IO_URING
+
+class IoUringPoller : public Poller {
+public:
+	IoUringPoller();
+	virtual ~IoUringPoller();
+
+	// Were the ring and its buffers set up (kernel >= 5.19, io_uring not disabled)?
+	bool isValid() const;
+
+	virtual bool add(int fd, short events);
+	virtual bool addListener(int fd);
+	virtual bool addStream(int fd, short events);
+	virtual bool modify(int fd, short events);
+	virtual void remove(int fd);
+	virtual int wait(std::vector<Event>& ready, int timeoutMs);
+	virtual const char* getName() const;
+
+private:
+	// How a registered fd is watched
+	enum Mode {
+		MODE_POLL,      // One-shot polls for its whole interest
+		MODE_LISTENER,  // Multishot accept
+		MODE_STREAM     // Multishot recv for POLLIN, one-shot poll for POLLOUT
+	};
+
+	// Request kinds, in the top bits of user_data
+	enum Op {
+		OP_POLL,
+		OP_ACCEPT,
+		OP_RECV
+	};
+
+	// Per fd state
+	struct FdState {
+		unsigned char mode;
+		unsigned epoch;        // Bumped by add/remove: completions of a closed socket are dropped
+		unsigned pollSeq;      // Tags the current poll (bumped on every arm)
+		unsigned opSeq;        // Tags the current accept/recv (bumped on every arm)
+		bool pollArmed;        // A poll request is in flight
+		bool opArmed;          // A multishot accept/recv is in flight
+		bool eof;              // recv reached the end of the stream
+	};
+
+	int _ringFd;                     // io_uring instance
+	unsigned _sqEntries;             // Submission ring size
+
+	// Submission ring (shared with the kernel)
+	void* _sqRing;
+	size_t _sqRingSize;
+	unsigned* _sqHead;
+	unsigned* _sqTail;
+	unsigned* _sqMask;
+	unsigned* _sqArray;
+	struct io_uring_sqe* _sqes;
+	size_t _sqesSize;
+	unsigned _pending;               // Queued SQEs not yet submitted
+
+	// Completion ring (shared with the kernel)
+	void* _cqRing;
+	size_t _cqRingSize;
+	unsigned* _cqHead;
+	unsigned* _cqTail;
+	unsigned* _cqMask;
+	struct io_uring_cqe* _cqes;
+
+	// Provided buffers (shared with the kernel), filled by multishot recv
+	struct io_uring_buf* _bufRing;
+	unsigned short* _bufRingTail;
+	char* _buffers;
+	unsigned short _bufTail;
+	std::vector<unsigned short> _spent;  // Handed out by the last wait, returned by the next
+	bool _multishotRecv;                 // Cleared when the kernel rejects it (Linux 5.19)
+
+	std::vector<FdState> _fds;       // Indexed by fd
+	std::vector<int> _rearm;         // Fds whose requests ended and need new ones
+
+	static const unsigned RING_ENTRIES = 1024;
+	// Provided buffers: a power of two, each the size of a Connection read
+	static const unsigned BUFFER_COUNT = 256;
+	static const unsigned BUFFER_SIZE = 4096;
+	static const unsigned short BUFFER_GROUP = 0;
+	// user_data of requests whose completion is ignored (cancels)
+	static const unsigned long long IGNORED = ~0ULL;
+
+	bool setup();
+	bool setupBuffers();
+	struct io_uring_sqe* nextSqe();
+	int enter(unsigned minComplete, int timeoutMs);
+	void recycle(unsigned short bid);
+	void arm(int fd);
+	void queuePoll(int fd, short events);
+	void queueAccept(int fd);
+	void queueRecv(int fd);
+	void queueCancel(unsigned long long target);
+	void cancelPoll(int fd);
+	void cancelOp(int fd);
+	void track(int fd, Mode mode);
+	void reap(std::vector<Event>& ready);
+	void completePoll(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready);
+	void completeAccept(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready);
+	void completeRecv(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready);
+
+	static unsigned long long tag(Op op, int fd, unsigned epoch, unsigned seq);
+};
+
+#endif // WEBSERV_HAVE_IO_URING
@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ListenerPool.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 18:02:11 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 18:02:11 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ListenerPool.hpp
+ * Listening sockets that outlive worker generations
+ * One SO_REUSEPORT socket per host:port and worker slot, opened by the
+ * process that forks the workers. A reload keeps the sockets whose address
+ * did not change, so connections waiting in their accept queues are served
+ * by the next generation; a binary upgrade passes them to the new
+ * executable through the environment.
+ */
+#pragma once
+
+#include "includes/config/Config.hpp"
+#include "includes/network/Socket.hpp"
+#include <string>
+#include <vector>
+
+class ListenerPool {
+public:
+	// Environment variable holding the sockets passed across exec
+	static const char* const ENV_NAME;
+
+	/**
+	 * Constructor
+	 */
+	ListenerPool();
+
+	/**
+	 * Destructor (closes every socket still in the pool)
+	 */
+	~ListenerPool();
+
+	/**
+	 * Adopt the sockets passed by the binary that exec'd this one
+	 * @param value: ENV_NAME value ("fd:slot:host:port;..."), may be NULL
+	 */
+	void inherit(const char* value);
+
+	/**
+	 * Make the pool match a configuration: one socket per address and slot
+	 * Existing sockets are kept (backlog updated), missing ones opened and
+	 * the rest closed. Nothing changes if a socket cannot be opened.
+	 * @param config: Configuration to listen for
+	 * @param slots: Number of worker slots
+	 * @return: true on success
+	 */
+	bool sync(const Config& config, size_t slots);
+
+	/**
+	 * Close every socket that does not belong to a slot (in a forked worker)
+	 */
+	void retain(size_t slot);
+
+	/**
+	 * Sockets of one slot
+	 */
+	std::vector<Socket*> forSlot(size_t slot) const;
+
+	/**
+	 * Describe the sockets for a new binary (ENV_NAME value)
+	 */
+	std::string serialize() const;
+
+	/**
+	 * Let every socket survive execve (in the child, right before exec)
+	 */
+	void keepAcrossExec() const;
+
+private:
+	// One listening socket
+	struct Entry {
+		std::string host;
+		int port;
+		size_t slot;
+		int backlog;      // -1 if unknown (inherited)
+		Socket* socket;
+	};
+
+	std::vector<Entry> _entries;
+
+	int find(const std::string& host, int port, size_t slot) const;
+	static Socket* open(const std::string& host, int port, int backlog);
+
+	// Disable copy
+	ListenerPool(const ListenerPool& other);
+	ListenerPool& operator=(const ListenerPool& other);
+};
@@ -0,0 +1,131 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 06:10:41 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 06:10:41 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * OutputQueue.hpp
+ * Bytes waiting to go out on a connection, as a queue of segments
+ * A response is queued as its pieces rather than one contiguous string:
+ * the head block and any chunk framing as text in a buffer shared by the
+ * whole queue, the body as a string moved in from the Response, or a range
+ * of an open file. flush() hands as many segments as it can to a single
+ * writev() and keeps a cursor into the first one, so a partial write
+ * resumes exactly where the socket stopped. File ranges go out with
+ * sendfile() (the head before them corked into the same packets), or
+ * through a small staging buffer when sendfile is off: either way a file
+ * costs the same memory whatever its size. A Source produces its bytes
+ * only when the socket is ready for them (a file compressed on the fly).
+ */
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class OutputQueue {
+public:
+	// File bytes read per flush (a file segment ends the writev batch)
+	static const size_t FILE_STAGING_SIZE = 65536;
+	// Most file bytes one sendfile() call may take, so that one fast
+	// client cannot hold the loop
+	static const size_t SENDFILE_MAX = 1048576;
+
+	// Bytes made on demand, a piece at a time, as the socket drains
+	class Source {
+	public:
+		virtual ~Source() {}
+		// Append the next piece to out; false if it cannot be produced
+		virtual bool read(std::string& out) = 0;
+		// Nothing left to read
+		virtual bool done() const = 0;
+	};
+
+	OutputQueue();
+	~OutputQueue();     // Closes the files still queued
+
+	/**
+	 * Text written in place: append to the returned buffer, then endText()
+	 * queues what was appended as one segment
+	 */
+	std::string& beginText();
+	void endText();
+	void addText(const char* data, size_t length);
+
+	// Owned string, swapped in (data is left empty); nothing if empty
+	void addString(std::string& data);
+
+	/**
+	 * Range of an open file; the queue owns fd and closes it once sent
+	 * @param zeroCopy: sendfile() it, or read it through the staging buffer
+	 */
+	void addFile(int fd, off_t offset, size_t length, bool zeroCopy);
+
+	// The queue owns source and deletes it once it is done and sent
+	void addSource(Source* source);
+
+	// The segments queued since the previous call form one message
+	void endMessage();
+
+	/**
+	 * writev() the front of the queue, up to IOV_MAX segments, and
+	 * sendfile() the file that ends the batch, if any
+	 * @return: bytes written, -1 if the socket took nothing (would block,
+	 *          or failed) or a queued file or source could not be read
+	 *          (failed())
+	 */
+	ssize_t flush(int fd);
+
+	bool empty() const;
+	size_t messages() const;    // Messages not completely written
+	bool failed() const;        // A queued file or source came up short
+	void clear();
+
+private:
+	enum Kind {
+		SEGMENT_TEXT,       // _text[offset, offset + length)
+		SEGMENT_STRING,     // data
+		SEGMENT_FILE,       // fd, from fileOffset; sendfile() if zeroCopy
+		SEGMENT_SOURCE      // data: the current piece of source (ends a writev batch)
+	};
+
+	struct Segment {
+		Kind kind;
+		size_t offset;
+		size_t length;
+		std::string data;
+		int fd;
+		off_t fileOffset;
+		bool zeroCopy;
+		Source* source;
+		bool endsMessage;
+	};
+
+	std::deque<Segment> _segments;
+	size_t _cursor;             // Bytes of the front segment already written
+	std::string _text;          // Text segments, back to back (keeps its capacity)
+	size_t _textStart;          // Start of the pending text in _text
+	size_t _textMark;           // beginText() position
+	std::vector<char> _staging; // File bytes of the current batch
+	size_t _messages;
+	bool _failed;
+
+	Segment& push(Kind kind, size_t length);
+	bool stage(const Segment& segment, size_t from, size_t& staged);
+	bool refill(Segment& segment);
+	ssize_t sendFront(int fd);
+	void fileFailed(int fd);
+	void advance(size_t written);
+	void pop();
+
+	OutputQueue(const OutputQueue&);
+	OutputQueue& operator=(const OutputQueue&);
+};
@@ -0,0 +1,36 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollPoller.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:05:37 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:05:37 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * PollPoller.hpp
+ * poll() backend - keeps a persistent pollfd array instead of rebuilding it
+ * Add, modify and remove are O(1) through an fd -> slot index
+ */
+#pragma once
+
+#include "includes/network/Poller.hpp"
+
+class PollPoller : public Poller {
+public:
+	PollPoller();
+	virtual ~PollPoller();
+
+	virtual bool add(int fd, short events);
+	virtual bool modify(int fd, short events);
+	virtual void remove(int fd);
+	virtual int wait(std::vector<Event>& ready, int timeoutMs);
+	virtual const char* getName() const;
+
+private:
+	std::vector<struct pollfd> _pollFds;  // Watched fds (dense)
+	std::vector<int> _slots;              // fd -> index in _pollFds (-1 = none)
+};
@@ -0,0 +1,136 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Poller.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:02:11 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:02:11 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Poller.hpp
+ * Event notification backend used by the server event loop
+ * File descriptors are registered once and only their interest changes.
+ * Readiness backends report ready fds and leave the I/O to the caller;
+ * completion backends (io_uring) may accept and receive on their own and
+ * report the result instead.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <poll.h>
+
+// epoll is only available on Linux (disable with -DWEBSERV_NO_EPOLL)
+#if defined(__linux__) && !defined(WEBSERV_NO_EPOLL)
+# define WEBSERV_HAVE_EPOLL 1
+#endif
+
+// io_uring needs the kernel uapi header (disable with -DWEBSERV_NO_IO_URING);
+// whether the running kernel supports it is checked at runtime
+#if defined(__linux__) && !defined(WEBSERV_NO_IO_URING) && defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  define WEBSERV_HAVE_IO_URING 1
+# endif
+#endif
+
+class Poller {
+public:
+	// Available backends
+	enum Backend {
+		BACKEND_POLL,     // poll() over a persistent pollfd array
+		BACKEND_EPOLL,    // Linux epoll (only ready fds are returned)
+		BACKEND_IO_URING  // Linux io_uring multishot accept/recv, batched per wait
+	};
+
+	// What an event reports
+	enum EventType {
+		EVENT_READY,     // fd is ready (events), the caller does the I/O
+		EVENT_ACCEPTED,  // Listener fd accepted the socket in result
+		EVENT_RECEIVED   // result bytes of fd are in data (0 = peer closed)
+	};
+
+	// Ready event (events use the POLLIN/POLLOUT/POLLERR/POLLHUP bits;
+	// data stays valid until the next wait())
+	struct Event {
+		int fd;
+		short events;
+		EventType type;
+		int result;
+		const char* data;
+	};
+
+	virtual ~Poller();
+
+	/**
+	 * Register a file descriptor
+	 * @param fd: File descriptor to watch
+	 * @param events: Interest mask (POLLIN, POLLOUT)
+	 * @return: true if registered successfully
+	 */
+	virtual bool add(int fd, short events) = 0;
+
+	/**
+	 * Register a listening socket
+	 * Completion backends accept on it and report EVENT_ACCEPTED;
+	 * the default watches it for POLLIN
+	 */
+	virtual bool addListener(int fd);
+
+	/**
+	 * Register a connected socket
+	 * Completion backends receive on it while POLLIN is in the interest
+	 * and report EVENT_RECEIVED; the default is add()
+	 */
+	virtual bool addStream(int fd, short events);
+
+	/**
+	 * Change the interest mask of a registered fd
+	 * Does nothing (no syscall) when the mask did not change
+	 */
+	virtual bool modify(int fd, short events) = 0;
+
+	/**
+	 * Unregister a file descriptor (must be called before close())
+	 */
+	virtual void remove(int fd) = 0;
+
+	/**
+	 * Wait for events
+	 * @param ready: Filled with the ready fds (cleared first)
+	 * @param timeoutMs: Timeout in milliseconds (-1 = infinite)
+	 * @return: Number of ready fds, or -1 on error (errno is set)
+	 */
+	virtual int wait(std::vector<Event>& ready, int timeoutMs) = 0;
+
+	// Backend name (for logging)
+	virtual const char* getName() const = 0;
+
+	// Number of registered file descriptors
+	size_t size() const;
+
+	// Factory
+	static Poller* create(Backend backend);
+	static Backend defaultBackend();
+	static bool parseBackend(const std::string& name, Backend& backend);
+
+protected:
+	Poller();
+
+	// Interest mask per fd (-1 = not registered)
+	std::vector<short> _interest;
+	size_t _count;
+
+	bool isRegistered(int fd) const;
+	void setInterest(int fd, short events);
+	void clearInterest(int fd);
+	static Event readyEvent(int fd, short events);
+
+private:
+	// Disable copy
+	Poller(const Poller& other);
+	Poller& operator=(const Poller& other);
+};
@@ -24,24 +24,29 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+// Forward declarations
+class Server;
+
 class Socket {
 public:
 	// Constructors
 	Socket();
 	Socket(int fd);
+	Socket(int fd, const std::string& host, int port); // Already listening (inherited)
 	~Socket();
 
 	// Socket operations
 	bool create();
 	bool bind(const std::string& host, int port);
 	bool listen(int backlog = 128);
-	int accept(struct sockaddr_in& clientAddr);
+	int accept(struct sockaddr_in& clientAddr);  // Client fd is non-blocking and close-on-exec
 	void close();
 
 	// Configuration
 	bool setNonBlocking();
 	bool setReuseAddr();
 	bool setReusePort();
+	bool setCloseOnExec(bool enabled);
 
 	// Getters
 	int getFd() const;
@@ -49,6 +54,10 @@ public:
 	int getPort() const;
 	bool isValid() const;
 
+	// Default server for this listener (resolved once at startup)
+	void setServer(const Server* server);
+	const Server* getServer() const;
+
 	// Utils
 	static std::string getHostString(const struct sockaddr_in& addr);
 	static int getPortNumber(const struct sockaddr_in& addr);
@@ -58,6 +67,7 @@ private:
 	std::string _host; // Host address (e.g., "127.0.0.1", "0.0.0.0")
 	int _port;         // Port number
 	bool _valid;       // Is socket valid?
+	const Server* _server; // Default server for accepted clients (listeners only)
 
 	// Disable copy (C++98 way)
 	Socket(const Socket& other);
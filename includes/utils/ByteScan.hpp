@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ByteScan.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:36:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 21:36:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ByteScan.hpp
+ * Delimiter scanning over raw bytes (header runs, line ends, boundaries)
+ * Each scan has a scalar version and SSE4.2 / AVX2 kernels; the best one the
+ * CPU supports is picked once at startup (CPUID), so callers never care.
+ * Build with "make SIMD=off" to keep only the scalar code.
+ */
+#pragma once
+
+#include <cstddef>
+
+class ByteScan {
+public:
+	enum Level {
+		LEVEL_SCALAR,
+		LEVEL_SSE42,     // 16 bytes per step (PCMPESTRI for token runs)
+		LEVEL_AVX2       // 32 bytes per step
+	};
+
+	/**
+	 * Runs: first byte at or after from that is not in the class (size if none)
+	 */
+	static size_t skipToken(const char* data, size_t from, size_t size);     // tchar (methods, header names)
+	static size_t skipVisible(const char* data, size_t from, size_t size);   // VCHAR and obs-text
+	static size_t skipText(const char* data, size_t from, size_t size);      // Visible, SP and HTAB (header values)
+
+	/**
+	 * First CR or LF at or after from (size if none)
+	 */
+	static size_t findLineEnd(const char* data, size_t from, size_t size);
+
+	/**
+	 * First occurrence of needle at or after from (std::string::npos if none)
+	 */
+	static size_t find(const char* data, size_t from, size_t size, const char* needle, size_t length);
+
+	// Single bytes (table lookup)
+	static bool isToken(unsigned char c) { return (_classes[c] & CLASS_TOKEN) != 0; }
+	static bool isVisible(unsigned char c) { return (_classes[c] & CLASS_VISIBLE) != 0; }
+	static bool isText(unsigned char c) { return (_classes[c] & CLASS_TEXT) != 0; }
+
+	// Best level this CPU (and build) supports
+	static Level detect();
+
+	// Kernels in use; setLevel() is for benchmarks and is clamped to detect()
+	static Level level();
+	static Level setLevel(Level level);
+	static const char* levelName(Level level);
+
+private:
+	enum Class {
+		CLASS_TOKEN = 1,
+		CLASS_VISIBLE = 2,
+		CLASS_TEXT = 4
+	};
+
+	static unsigned char _classes[256];
+
+	friend struct ByteScanInit;
+};
@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoopStats.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:20:45 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:20:45 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * LoopStats.hpp
+ * Per-phase timing histograms of one event loop
+ * Written only by the loop's own thread; other threads read a consistent
+ * enough copy with snapshot() (relaxed atomics, no locks on the hot path)
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class LoopStats {
+public:
+	// What the loop spends its time on
+	enum Phase {
+		PHASE_LAG,       // Busy time of one iteration (how long ready clients may wait)
+		PHASE_ACCEPT,    // Accepting and adopting new connections
+		PHASE_READ,      // recv + request parsing
+		PHASE_HANDLE,    // RequestHandler (files, CGI, uploads) + response build
+		PHASE_WRITE,     // send
+		PHASE_TIMERS,    // Timeout sweep
+		PHASE_COUNT
+	};
+
+	// Power-of-two microsecond buckets: [0], [1,2), [2,4), ... last one open
+	static const unsigned int BUCKETS = 24;
+
+	struct Histogram {
+		unsigned long long count;
+		unsigned long long totalUs;
+		unsigned long long maxUs;
+		unsigned long long buckets[BUCKETS];
+	};
+
+	LoopStats();
+
+	/**
+	 * Add one sample (owning thread only)
+	 */
+	void record(Phase phase, unsigned long long us);
+
+	/**
+	 * Copy the counters (any thread)
+	 */
+	void snapshot(LoopStats& out) const;
+
+	/**
+	 * Add another set of counters to this one (for totals)
+	 */
+	void merge(const LoopStats& other);
+
+	const Histogram& get(Phase phase) const;
+
+	/**
+	 * Print one line per phase (count, avg, p50, p99, max) to the info log
+	 * @param title: Header line (e.g. "Loop #1")
+	 */
+	void dump(const std::string& title) const;
+
+	// Upper bound (us) of the bucket holding the given percentile
+	static unsigned long long percentile(const Histogram& histogram, double fraction);
+
+	static const char* phaseName(Phase phase);
+
+	// Current CLOCK_MONOTONIC time in microseconds
+	static unsigned long long monotonicUs();
+
+private:
+	Histogram _phases[PHASE_COUNT];
+};
@@ -0,0 +1,90 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SpscQueue.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 15:10:37 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 15:10:37 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * SpscQueue.hpp
+ * Bounded lock-free single-producer/single-consumer ring buffer
+ * One thread pushes, one other thread pops; no locks on either side.
+ * Ordering uses the GCC/Clang __atomic builtins (C++98 has no <atomic>).
+ */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+template<typename T>
+class SpscQueue {
+public:
+	/**
+	 * Constructor
+	 * @param capacity: Minimum number of slots (rounded up to a power of two)
+	 */
+	explicit SpscQueue(size_t capacity)
+		: _mask(0) {
+		size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		_items.resize(size);
+		_mask = size - 1;
+	}
+
+	/**
+	 * Append an item (producer thread only)
+	 * @return: false if the queue is full
+	 */
+	bool push(const T& item) {
+		size_t tail = __atomic_load_n(&_tail.value, __ATOMIC_RELAXED);
+		size_t head = __atomic_load_n(&_head.value, __ATOMIC_ACQUIRE);
+		if (tail - head > _mask) {
+			return false;
+		}
+		_items[tail & _mask] = item;
+		// Release: the item is visible before the new tail
+		__atomic_store_n(&_tail.value, tail + 1, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest item (consumer thread only)
+	 * @return: false if the queue is empty
+	 */
+	bool pop(T& item) {
+		size_t head = __atomic_load_n(&_head.value, __ATOMIC_RELAXED);
+		size_t tail = __atomic_load_n(&_tail.value, __ATOMIC_ACQUIRE);
+		if (head == tail) {
+			return false;
+		}
+		item = _items[head & _mask];
+		// Release: the slot is read before the producer may reuse it
+		__atomic_store_n(&_head.value, head + 1, __ATOMIC_RELEASE);
+		return true;
+	}
+
+private:
+	// Index padded to a cache line, so producer and consumer do not share one
+	struct Index {
+		size_t value;
+		char pad[64 - sizeof(size_t)];
+
+		Index() : value(0) {}
+	};
+
+	std::vector<T> _items;       // Ring storage
+	size_t _mask;                // Capacity - 1
+	Index _head;                 // Next slot to pop (written by consumer)
+	Index _tail;                 // Next slot to push (written by producer)
+
+	// Disable copy
+	SpscQueue(const SpscQueue& other);
+	SpscQueue& operator=(const SpscQueue& other);
+};
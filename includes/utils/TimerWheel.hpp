@@ -0,0 +1,106 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:40:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 16:40:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * TimerWheel.hpp
+ * Hierarchical timer wheel for connection, header and CGI timeouts
+ * Arm, re-arm and cancel are O(1); timers are intrusive list nodes
+ * embedded in the object that owns the timeout (no allocation)
+ */
+#pragma once
+
+#include <cstddef>
+
+class TimerWheel {
+public:
+	// Intrusive timer node
+	struct Timer {
+		Timer* prev;
+		Timer* next;
+		unsigned long long expires;  // Absolute expiry (ms, monotonic)
+		int kind;                    // Owner-defined tag (which timeout)
+		void* owner;                 // Object that owns this timer
+
+		Timer();
+		bool isArmed() const;
+	};
+
+	/**
+	 * Constructor
+	 * @param tickMs: Resolution of the wheel in milliseconds
+	 */
+	explicit TimerWheel(unsigned int tickMs = 10);
+	~TimerWheel();
+
+	/**
+	 * Arm (or re-arm) a timer to expire delayMs after now()
+	 */
+	void schedule(Timer* timer, unsigned long long delayMs);
+
+	/**
+	 * Disarm a timer (safe on timers that are not armed)
+	 */
+	void cancel(Timer* timer);
+
+	/**
+	 * Move the clock forward and collect the timers that expired
+	 * Expired timers are fetched with popExpired()
+	 */
+	void advance(unsigned long long nowMs);
+
+	/**
+	 * Next expired timer (NULL when none are left)
+	 * Timers cancelled before being popped are skipped
+	 */
+	Timer* popExpired();
+
+	/**
+	 * Milliseconds until the next timer may expire
+	 * @param maxMs: Upper bound returned when nothing expires sooner
+	 */
+	int nextTimeout(int maxMs) const;
+
+	// Cached clock (updated by advance)
+	unsigned long long now() const;
+
+	// Number of armed timers
+	size_t size() const;
+
+	// Current CLOCK_MONOTONIC time in milliseconds
+	static unsigned long long monotonicMs();
+
+private:
+	static const unsigned int LEVELS = 4;
+	static const unsigned int SLOT_BITS = 6;
+	static const unsigned int SLOTS = 1 << SLOT_BITS;   // 64 slots per level
+	static const unsigned int SLOT_MASK = SLOTS - 1;
+
+	unsigned int _tickMs;              // Wheel resolution
+	unsigned long long _now;           // Last time passed to advance (ms)
+	unsigned long long _currentTick;   // Next tick to be processed
+	size_t _count;                     // Armed timers (including expired, not popped)
+
+	Timer _slots[LEVELS][SLOTS];       // Sentinel list heads
+	Timer _expired;                    // Expired timers waiting for popExpired()
+
+	void insert(Timer* timer);
+	void cascade(unsigned int level);
+
+	static void listInit(Timer* head);
+	static bool listEmpty(const Timer* head);
+	static void listAppend(Timer* head, Timer* timer);
+	static void listUnlink(Timer* timer);
+
+	// Disable copy (sentinels point to themselves)
+	TimerWheel(const TimerWheel& other);
+	TimerWheel& operator=(const TimerWheel& other);
+};
@@ -33,6 +33,7 @@
 #include "includes/config/Route.hpp"
 #include "includes/config/ConfigParser.hpp"
 #include "includes/network/Socket.hpp"
+#include "includes/network/ListenerPool.hpp"
 #include "includes/network/Connection.hpp"
 #include "includes/http/ServerManager.hpp"
 #include "includes/cgi/CGIExecutor.hpp"
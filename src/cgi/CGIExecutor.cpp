@@ -19,6 +19,7 @@
 #include "includes/http/Response.hpp"
 #include "includes/config/Server.hpp"
 #include "includes/config/Route.hpp"
+#include "includes/utils/ByteScan.hpp"
 #include "includes/utils/Logger.hpp"
 #include "includes/core/Settings.hpp"
 #include <sys/types.h>
@@ -60,6 +61,33 @@ HTTP::Response Executor::execute(const HTTP::Request& request,
 		return HTTP::Response::errorResponse(500, "Failed to create pipes for CGI");
 	}
 
+	// A body spooled to a temp file is read by the script from the file
+	// itself, from the start; one in memory goes through the pipe
+	const HTTP::BodySink& body = request.getBody();
+	pipes.bodyFd = body.fd();
+	if (pipes.bodyFd >= 0 && lseek(pipes.bodyFd, 0, SEEK_SET) < 0) {
+		closePipes(pipes);
+		freeEnvArray(envp);
+		return HTTP::Response::errorResponse(500, "Failed to rewind the request body");
+	}
+
+	// Everything the child needs is built before fork(): it may only make
+	// async-signal-safe calls (see childError), so no allocation
+	const std::string& cgiPath = route->getCgiPath();
+	std::string scriptDir;
+	std::string scriptFilename = scriptPath;
+	size_t lastSlash = scriptPath.find_last_of('/');
+	if (lastSlash != std::string::npos) {
+		scriptDir = scriptPath.substr(0, lastSlash);
+		scriptFilename = scriptPath.substr(lastSlash + 1);
+	}
+
+	// argv[0] = cgi executable, argv[1] = script filename (NOT full path), argv[2] = NULL
+	char* argv[3];
+	argv[0] = const_cast<char*>(cgiPath.c_str());
+	argv[1] = const_cast<char*>(scriptFilename.c_str()); // Just filename after chdir
+	argv[2] = NULL;
+
 	// Fork process
 	pid_t pid = fork();
 	if (pid < 0) {
@@ -72,16 +100,18 @@ HTTP::Response Executor::execute(const HTTP::Request& request,
 
 	if (pid == 0) {
 		// Child process
-		executeChild(route->getCgiPath(), scriptPath, pipes, envp);
+		executeChild(cgiPath.c_str(), scriptDir.empty() ? NULL : scriptDir.c_str(), argv, pipes, envp);
 		// If executeChild returns, something went wrong
-		exit(1);
+		_exit(1);
 	}
 
 	// Parent process
 	freeEnvArray(envp);
 
 	// Handle parent I/O with timeout (default 30 seconds)
-	std::string cgiOutput = handleParent(pipes, request.getBody(), pid, 30);
+	std::string cgiOutput = (pipes.bodyFd >= 0)
+		? handleParent(pipes, NULL, 0, pid, 30)
+		: handleParent(pipes, body.bytes(), body.size(), pid, 30);
 
 	// Parse CGI output and build response
 	return parseCGIOutput(cgiOutput);
@@ -139,13 +169,14 @@ std::map<std::string, std::string> Executor::buildEnvironment(
 	env["PATH_TRANSLATED"] = scriptPath;
 
 	// Content information
-	if (request.hasHeader("Content-Type")) {
+	if (request.hasHeader(HTTP::HeaderTable::HEADER_CONTENT_TYPE)) {
 		env["CONTENT_TYPE"] = request.getContentType();
 	}
 
-	if (request.hasHeader("Content-Length")) {
+	// Decoded size, also for a chunked body (RFC 3875 4.1.2)
+	if (request.hasHeader(HTTP::HeaderTable::HEADER_CONTENT_LENGTH) || request.getBody().size() > 0) {
 		std::ostringstream lenStr;
-		lenStr << request.getContentLength();
+		lenStr << request.getBody().size();
 		env["CONTENT_LENGTH"] = lenStr.str();
 	} else {
 		env["CONTENT_LENGTH"] = "0";
@@ -153,10 +184,14 @@ std::map<std::string, std::string> Executor::buildEnvironment(
 
 	// HTTP headers (convert to HTTP_* format)
 	// All headers from request should be passed as HTTP_HEADER_NAME
-	const std::map<std::string, std::string>& headers = request.getHeaders();
-	for (std::map<std::string, std::string>::const_iterator it = headers.begin();
-	     it != headers.end(); ++it) {
-		std::string headerName = it->first;
+	const HTTP::HeaderTable& headers = request.getHeaders();
+	for (size_t index = 0; index < headers.size(); ++index) {
+		// Skip Content-Type and Content-Length (already set)
+		if (headers.id(index) == HTTP::HeaderTable::HEADER_CONTENT_TYPE
+		    || headers.id(index) == HTTP::HeaderTable::HEADER_CONTENT_LENGTH) {
+			continue;
+		}
+		std::string headerName = headers.name(index);
 
 		// Convert to uppercase and replace - with _
 		std::string envName = "HTTP_";
@@ -173,10 +208,7 @@ std::map<std::string, std::string> Executor::buildEnvironment(
 			}
 		}
 
-		// Skip Content-Type and Content-Length (already set)
-		if (envName != "HTTP_CONTENT_TYPE" && envName != "HTTP_CONTENT_LENGTH") {
-			env[envName] = it->second;
-		}
+		env[envName] = headers.value(index);
 	}
 
 	// Remote information (client)
@@ -214,14 +246,29 @@ void Executor::freeEnvArray(char** env) {
 	delete[] env;
 }
 
+// Pipe whose ends are not inherited by other CGI children forked meanwhile
+// by another loop thread (dup2() clears the flag on the child's stdin/stdout)
+bool Executor::openPipe(int fds[2]) {
+#ifdef __linux__
+	return pipe2(fds, O_CLOEXEC) == 0;
+#else
+	if (pipe(fds) < 0) {
+		return false;
+	}
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return true;
+#endif
+}
+
 // Create pipes for CGI I/O
 bool Executor::createPipes(PipeSet& pipes) {
-	if (pipe(pipes.stdinPipe) < 0) {
+	if (!openPipe(pipes.stdinPipe)) {
 		Logger::error << "Failed to create stdin pipe" << std::endl;
 		return false;
 	}
 
-	if (pipe(pipes.stdoutPipe) < 0) {
+	if (!openPipe(pipes.stdoutPipe)) {
 		Logger::error << "Failed to create stdout pipe" << std::endl;
 		close(pipes.stdinPipe[0]);
 		close(pipes.stdinPipe[1]);
@@ -240,12 +287,18 @@ void Executor::closePipes(PipeSet& pipes) {
 }
 
 // Execute CGI script in child process
-void Executor::executeChild(const std::string& cgiPath,
-                           const std::string& scriptPath,
+void Executor::executeChild(const char* cgiPath,
+                           const char* scriptDir,
+                           char** argv,
                            const PipeSet& pipes,
                            char** envp) {
 	// Redirect stdin
-	dup2(pipes.stdinPipe[0], STDIN_FILENO);
+	if (pipes.bodyFd >= 0) {
+		dup2(pipes.bodyFd, STDIN_FILENO);
+		close(pipes.bodyFd);
+	} else {
+		dup2(pipes.stdinPipe[0], STDIN_FILENO);
+	}
 
 	// Redirect stdout
 	dup2(pipes.stdoutPipe[1], STDOUT_FILENO);
@@ -257,40 +310,30 @@ void Executor::executeChild(const std::string& cgiPath,
 	close(pipes.stdoutPipe[1]);
 
 	// Change to script directory (required by subject)
-	std::string scriptDir;
-	std::string scriptFilename;
-
-	size_t lastSlash = scriptPath.find_last_of('/');
-	if (lastSlash != std::string::npos) {
-		scriptDir = scriptPath.substr(0, lastSlash);
-		scriptFilename = scriptPath.substr(lastSlash + 1);
-
-		if (chdir(scriptDir.c_str()) < 0) {
-			Logger::error << "Failed to chdir to: " << scriptDir << std::endl;
-			exit(1);
-		}
-	} else {
-		scriptFilename = scriptPath;
+	if (scriptDir != NULL && chdir(scriptDir) < 0) {
+		childError("Failed to chdir to CGI script directory\n");
 	}
 
-	// Prepare arguments for execve
-	// argv[0] = cgi executable, argv[1] = script filename (NOT full path), argv[2] = NULL
-	char* argv[3];
-	argv[0] = const_cast<char*>(cgiPath.c_str());
-	argv[1] = const_cast<char*>(scriptFilename.c_str()); // Just filename after chdir
-	argv[2] = NULL;
-
 	// Execute CGI
-	execve(cgiPath.c_str(), argv, envp);
+	execve(cgiPath, argv, envp);
 
 	// If we get here, execve failed
-	Logger::error << "execve failed for CGI: " << cgiPath << std::endl;
-	exit(1);
+	childError("execve failed for CGI interpreter\n");
+}
+
+// Report an error from the forked child and exit without running atexit
+// handlers or touching iostreams: another loop thread may have held their
+// locks at fork time, so only async-signal-safe calls are allowed here
+void Executor::childError(const char* message) {
+	ssize_t ret = write(STDERR_FILENO, message, std::strlen(message));
+	(void)ret;
+	_exit(1);
 }
 
 // Handle parent process I/O
 std::string Executor::handleParent(const PipeSet& pipes,
-                                  const std::string& requestBody,
+                                  const char* requestBody,
+                                  size_t bodyLength,
                                   pid_t childPid,
                                   int timeoutSeconds) {
 	// Close unused pipe ends
@@ -302,11 +345,11 @@ std::string Executor::handleParent(const PipeSet& pipes,
 	fcntl(pipes.stdoutPipe[0], F_SETFL, flags | O_NONBLOCK);
 
 	// Write request body to child stdin
-	if (!requestBody.empty()) {
+	if (requestBody != NULL && bodyLength > 0) {
 		size_t written = 0;
-		while (written < requestBody.length()) {
-			ssize_t n = write(pipes.stdinPipe[1], requestBody.c_str() + written,
-			                 requestBody.length() - written);
+		while (written < bodyLength) {
+			ssize_t n = write(pipes.stdinPipe[1], requestBody + written,
+			                 bodyLength - written);
 			if (n <= 0) {
 				Logger::warning << "Failed to write to CGI stdin" << std::endl;
 				break;
@@ -384,11 +427,12 @@ HTTP::Response Executor::parseCGIOutput(const std::string& cgiOutput) {
 	// or
 	// Headers\n\nBody
 
-	size_t headerEnd = cgiOutput.find("\r\n\r\n");
+	const char* data = cgiOutput.data();
+	size_t headerEnd = ByteScan::find(data, 0, cgiOutput.size(), "\r\n\r\n", 4);
 	bool usesCRLF = true;
 
 	if (headerEnd == std::string::npos) {
-		headerEnd = cgiOutput.find("\n\n");
+		headerEnd = ByteScan::find(data, 0, cgiOutput.size(), "\n\n", 2);
 		usesCRLF = false;
 		if (headerEnd == std::string::npos) {
 			// No header/body separation - treat all as body
@@ -400,38 +444,36 @@ HTTP::Response Executor::parseCGIOutput(const std::string& cgiOutput) {
 		}
 	}
 
-	// Split headers and body
-	std::string headersSection = cgiOutput.substr(0, headerEnd);
+	// Body
 	std::string body = cgiOutput.substr(headerEnd + (usesCRLF ? 4 : 2));
 
-	// Parse headers
+	// Parse headers (one line at a time, in place)
 	HTTP::Response response;
 	int statusCode = 200;
 	std::string contentType = "text/html";
 
-	std::istringstream headerStream(headersSection);
-	std::string line;
-	std::string delimiter = usesCRLF ? "\r\n" : "\n";
-
-	while (std::getline(headerStream, line)) {
-		// Remove \r if present
-		if (!line.empty() && line[line.length() - 1] == '\r') {
-			line = line.substr(0, line.length() - 1);
-		}
+	size_t lineStart = 0;
+	while (lineStart < headerEnd) {
+		size_t lineEnd = ByteScan::findLineEnd(data, lineStart, headerEnd);
+		size_t lineLength = lineEnd - lineStart;
+		const char* line = data + lineStart;
+		lineStart = lineEnd + 1;
 
-		if (line.empty()) continue;
+		if (lineLength == 0) continue;   // Between CR and LF
 
 		// Parse header: Name: Value
-		size_t colonPos = line.find(':');
-		if (colonPos == std::string::npos) continue;
+		const char* colon = static_cast<const char*>(std::memchr(line, ':', lineLength));
+		if (colon == NULL) continue;
 
-		std::string name = line.substr(0, colonPos);
-		std::string value = line.substr(colonPos + 1);
+		std::string name(line, colon);
+		const char* valueStart = colon + 1;
+		const char* valueEnd = line + lineLength;
 
 		// Trim whitespace from value
-		while (!value.empty() && (value[0] == ' ' || value[0] == '\t')) {
-			value = value.substr(1);
+		while (valueStart < valueEnd && (*valueStart == ' ' || *valueStart == '\t')) {
+			++valueStart;
 		}
+		std::string value(valueStart, valueEnd);
 
 		// Handle special CGI headers
 		if (name == "Status") {
@@ -19,7 +19,7 @@
 #include <iostream>
 
 // Constructors
-Config::Config() {}
+Config::Config() : _acceptBudget(64), _workerConnections(1024), _masterProcess(true), _workerProcesses(1), _workerThreads(1), _gzipCacheSize(8 * 1024 * 1024) {}
 
 Config::~Config() {}
 
@@ -30,6 +30,13 @@ Config::Config(const Config& other) {
 Config& Config::operator=(const Config& other) {
 	if (this != &other) {
 		_servers = other._servers;
+		_eventBackend = other._eventBackend;
+		_acceptBudget = other._acceptBudget;
+		_workerConnections = other._workerConnections;
+		_masterProcess = other._masterProcess;
+		_workerProcesses = other._workerProcesses;
+		_workerThreads = other._workerThreads;
+		_gzipCacheSize = other._gzipCacheSize;
 	}
 	return *this;
 }
@@ -43,6 +50,63 @@ const std::vector<Server>& Config::getServers() const {
 	return _servers;
 }
 
+// Global settings
+void Config::setEventBackend(const std::string& backend) {
+	_eventBackend = backend;
+}
+
+const std::string& Config::getEventBackend() const {
+	return _eventBackend;
+}
+
+void Config::setAcceptBudget(int budget) {
+	_acceptBudget = budget;
+}
+
+int Config::getAcceptBudget() const {
+	return _acceptBudget;
+}
+
+void Config::setWorkerConnections(int count) {
+	_workerConnections = count;
+}
+
+int Config::getWorkerConnections() const {
+	return _workerConnections;
+}
+
+void Config::setMasterProcess(bool enabled) {
+	_masterProcess = enabled;
+}
+
+bool Config::getMasterProcess() const {
+	return _masterProcess;
+}
+
+void Config::setWorkerProcesses(int count) {
+	_workerProcesses = count;
+}
+
+int Config::getWorkerProcesses() const {
+	return _workerProcesses;
+}
+
+void Config::setWorkerThreads(int count) {
+	_workerThreads = count;
+}
+
+int Config::getWorkerThreads() const {
+	return _workerThreads;
+}
+
+void Config::setGzipCacheSize(size_t size) {
+	_gzipCacheSize = size;
+}
+
+size_t Config::getGzipCacheSize() const {
+	return _gzipCacheSize;
+}
+
 // Server lookup
 const Server* Config::getServer(const std::string& host, int port, const std::string& serverName) const {
 	// 1. Procurar server com host:port e serverName matching
@@ -119,6 +183,13 @@ bool Config::isValid() const {
 void Config::print() const {
 	std::cout << "=== Configuration ===" << std::endl;
 	std::cout << "Total servers: " << _servers.size() << std::endl;
+	std::cout << "Event backend: " << (_eventBackend.empty() ? "default" : _eventBackend) << std::endl;
+	std::cout << "Accept budget: " << _acceptBudget << std::endl;
+	std::cout << "Worker connections: " << _workerConnections << std::endl;
+	std::cout << "Master process: " << (_masterProcess ? "on" : "off") << std::endl;
+	std::cout << "Worker processes: " << _workerProcesses << std::endl;
+	std::cout << "Worker threads: " << _workerThreads << std::endl;
+	std::cout << "Gzip cache size: " << _gzipCacheSize << " bytes" << std::endl;
 	std::cout << std::endl;
 
 	for (size_t i = 0; i < _servers.size(); ++i) {
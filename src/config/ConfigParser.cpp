@@ -19,6 +19,7 @@
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
+#include <unistd.h>
 
 ConfigParser::ConfigParser() : _error("") {}
 
@@ -50,8 +51,36 @@ bool ConfigParser::parse(const std::string& filename, Config& config) {
 				return false;
 			}
 			config.addServer(server);
+		} else if (token == "events") {
+			if (!parseEvents(tokens, index, config)) {
+				return false;
+			}
+		} else if (token == "worker_processes" || token == "worker_threads") {
+			if (!parseWorkerCount(tokens, index, config)) {
+				return false;
+			}
+		} else if (token == "master_process") {
+			++index;
+			if (index >= tokens.size() || (tokens[index] != "on" && tokens[index] != "off")) {
+				setError("Expected on/off after 'master_process'");
+				return false;
+			}
+			config.setMasterProcess(tokens[index++] == "on");
+			if (!expectToken(tokens, index, ";")) {
+				return false;
+			}
+		} else if (token == "gzip_cache_size") {
+			++index;
+			if (index >= tokens.size()) {
+				setError("Expected size after 'gzip_cache_size'");
+				return false;
+			}
+			config.setGzipCacheSize(toSize(tokens[index++]));
+			if (!expectToken(tokens, index, ";")) {
+				return false;
+			}
 		} else {
-			setError("Unexpected token: " + token + " (expected 'server')");
+			setError("Unexpected token: " + token + " (expected 'server', 'events', 'master_process', 'worker_processes', 'worker_threads' or 'gzip_cache_size')");
 			return false;
 		}
 	}
@@ -131,6 +160,100 @@ std::vector<std::string> ConfigParser::tokenize(const std::string& content) {
 	return tokens;
 }
 
+// Parse worker_processes / worker_threads directive (main context)
+bool ConfigParser::parseWorkerCount(std::vector<std::string>& tokens, size_t& index, Config& config) {
+	std::string directive = tokens[index++];
+
+	if (index >= tokens.size()) {
+		setError("Expected number or 'auto' after '" + directive + "'");
+		return false;
+	}
+
+	std::string value = tokens[index++];
+	int count;
+	if (value == "auto") {
+		// Um worker por core disponível
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		count = (cores > 0) ? static_cast<int>(cores) : 1;
+	} else if (isNumber(value) && value.size() <= 4 && toInt(value) > 0) {
+		count = toInt(value);
+	} else {
+		setError("Invalid " + directive + ": " + value + " (expected a positive number or 'auto')");
+		return false;
+	}
+
+	if (directive == "worker_processes") {
+		config.setWorkerProcesses(count);
+	} else {
+		config.setWorkerThreads(count);
+	}
+	return expectToken(tokens, index, ";");
+}
+
+// Parse events block (global event loop settings)
+bool ConfigParser::parseEvents(std::vector<std::string>& tokens, size_t& index, Config& config) {
+	++index; // Skip "events"
+
+	if (!expectToken(tokens, index, "{"))
+		return false;
+
+	while (index < tokens.size() && tokens[index] != "}") {
+		const std::string& directive = tokens[index];
+		if (!parseEventsDirective(directive, tokens, index, config)) {
+			return false;
+		}
+	}
+
+	if (!expectToken(tokens, index, "}"))
+		return false;
+
+	return true;
+}
+
+// Parse events directive
+bool ConfigParser::parseEventsDirective(const std::string& directive,
+                                       std::vector<std::string>& tokens,
+                                       size_t& index,
+                                       Config& config) {
+	++index; // Skip directive
+
+	if (directive == "use") {
+		if (index >= tokens.size()) {
+			setError("Expected poll, epoll or io_uring after 'use'");
+			return false;
+		}
+		std::string backend = tokens[index++];
+		if (backend != "poll" && backend != "epoll" && backend != "io_uring") {
+			setError("Unknown event backend: " + backend + " (expected poll, epoll or io_uring)");
+			return false;
+		}
+		config.setEventBackend(backend);
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "accept_budget") {
+		if (index >= tokens.size() || !isNumber(tokens[index]) || tokens[index].size() > 6
+		    || toInt(tokens[index]) <= 0) {
+			setError("Invalid accept_budget (expected a positive number)");
+			return false;
+		}
+		config.setAcceptBudget(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "worker_connections") {
+		if (index >= tokens.size() || !isNumber(tokens[index]) || tokens[index].size() > 7
+		    || toInt(tokens[index]) <= 0) {
+			setError("Invalid worker_connections (expected a positive number)");
+			return false;
+		}
+		config.setWorkerConnections(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else {
+		setError("Unknown events directive: " + directive);
+		return false;
+	}
+}
+
 // Parse server block
 bool ConfigParser::parseServer(std::vector<std::string>& tokens, size_t& index, Server& server) {
 	++index; // Skip "server"
@@ -226,6 +349,22 @@ bool ConfigParser::parseServerDirective(const std::string& directive,
 			server.addPort(port);
 		}
 
+		// Parâmetros opcionais: backlog=N
+		while (index < tokens.size() && tokens[index] != ";") {
+			const std::string& param = tokens[index++];
+			if (param.compare(0, 8, "backlog=") == 0) {
+				std::string value = param.substr(8);
+				if (!isNumber(value) || value.size() > 6 || toInt(value) <= 0) {
+					setError("Invalid backlog in listen directive: " + value);
+					return false;
+				}
+				server.setListenBacklog(toInt(value));
+			} else {
+				setError("Unknown listen parameter: " + param);
+				return false;
+			}
+		}
+
 		return expectToken(tokens, index, ";");
 
 	} else if (directive == "host") {
@@ -251,6 +390,71 @@ bool ConfigParser::parseServerDirective(const std::string& directive,
 		server.setMaxBodySize(size);
 		return expectToken(tokens, index, ";");
 
+	} else if (directive == "client_body_buffer_size") {
+		if (index >= tokens.size()) {
+			setError("Expected size after 'client_body_buffer_size'");
+			return false;
+		}
+		server.setBodyBufferSize(toSize(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "client_header_timeout") {
+		if (index >= tokens.size() || !isNumber(tokens[index])) {
+			setError("Expected seconds after 'client_header_timeout'");
+			return false;
+		}
+		server.setClientHeaderTimeout(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "keepalive_timeout") {
+		if (index >= tokens.size() || !isNumber(tokens[index])) {
+			setError("Expected seconds after 'keepalive_timeout'");
+			return false;
+		}
+		server.setKeepaliveTimeout(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "keepalive_requests") {
+		if (index >= tokens.size() || !isNumber(tokens[index]) || toInt(tokens[index]) < 1) {
+			setError("Expected a positive number after 'keepalive_requests'");
+			return false;
+		}
+		server.setKeepaliveRequests(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "gzip") {
+		if (index >= tokens.size() || (tokens[index] != "on" && tokens[index] != "off")) {
+			setError("Expected on/off after 'gzip'");
+			return false;
+		}
+		server.setGzip(tokens[index++] == "on");
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "gzip_types") {
+		// A lista substitui os tipos por omissão
+		server.clearGzipTypes();
+		while (index < tokens.size() && tokens[index] != ";") {
+			server.addGzipType(tokens[index++]);
+		}
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "gzip_min_length") {
+		if (index >= tokens.size()) {
+			setError("Expected size after 'gzip_min_length'");
+			return false;
+		}
+		server.setGzipMinLength(toSize(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
+	} else if (directive == "gzip_comp_level") {
+		if (index >= tokens.size() || !isNumber(tokens[index])
+			|| toInt(tokens[index]) < 1 || toInt(tokens[index]) > 9) {
+			setError("Expected a level from 1 to 9 after 'gzip_comp_level'");
+			return false;
+		}
+		server.setGzipLevel(toInt(tokens[index++]));
+		return expectToken(tokens, index, ";");
+
 	} else if (directive == "error_page") {
 		if (index + 1 >= tokens.size()) {
 			setError("Expected code and path after 'error_page'");
@@ -276,7 +480,12 @@ bool ConfigParser::parseLocationDirective(const std::string& directive,
 
 	if (directive == "allow_methods" || directive == "methods") {
 		while (index < tokens.size() && tokens[index] != ";") {
-			route.addAllowedMethod(tokens[index++]);
+			if (!route.addAllowedMethod(tokens[index])) {
+				setError("Unknown method in '" + directive + "': " + tokens[index]
+				         + " (expected GET, HEAD, POST, PUT, DELETE or OPTIONS)");
+				return false;
+			}
+			++index;
 		}
 		return expectToken(tokens, index, ";");
 
@@ -345,6 +554,15 @@ bool ConfigParser::parseLocationDirective(const std::string& directive,
 		route.setUploadPath(tokens[index++]);
 		return expectToken(tokens, index, ";");
 
+	} else if (directive == "sendfile") {
+		if (index >= tokens.size()) {
+			setError("Expected on/off after 'sendfile'");
+			return false;
+		}
+		std::string value = tokens[index++];
+		route.setSendfile(value == "on");
+		return expectToken(tokens, index, ";");
+
 	} else {
 		setError("Unknown location directive: " + directive);
 		return false;
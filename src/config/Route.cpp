@@ -29,9 +29,10 @@ Route::Route()
 	, _cgiPath("")
 	, _cgiExtension("")
 	, _uploadEnabled(false)
-	, _uploadPath("") {
-	// Por default, permitir GET
-	_allowedMethods.push_back("GET");
+	, _uploadPath("")
+	, _sendfile(true) {
+	// Por default, permitir GET (e HEAD)
+	_allowedMethods = HTTP::Method::bit(HTTP::Method::METHOD_GET) | HTTP::Method::bit(HTTP::Method::METHOD_HEAD);
 }
 
 Route::Route(const std::string& path)
@@ -43,9 +44,10 @@ Route::Route(const std::string& path)
 	, _cgiPath("")
 	, _cgiExtension("")
 	, _uploadEnabled(false)
-	, _uploadPath("") {
-	// Por default, permitir GET
-	_allowedMethods.push_back("GET");
+	, _uploadPath("")
+	, _sendfile(true) {
+	// Por default, permitir GET (e HEAD)
+	_allowedMethods = HTTP::Method::bit(HTTP::Method::METHOD_GET) | HTTP::Method::bit(HTTP::Method::METHOD_HEAD);
 }
 
 Route::~Route() {}
@@ -67,13 +69,14 @@ Route& Route::operator=(const Route& other) {
 		_cgiExtension = other._cgiExtension;
 		_uploadEnabled = other._uploadEnabled;
 		_uploadPath = other._uploadPath;
+		_sendfile = other._sendfile;
 	}
 	return *this;
 }
 
 // Getters
 const std::string& Route::getPath() const { return _path; }
-const std::vector<std::string>& Route::getAllowedMethods() const { return _allowedMethods; }
+unsigned int Route::getAllowedMethods() const { return _allowedMethods; }
 const std::string& Route::getRedirect() const { return _redirect; }
 const std::string& Route::getRoot() const { return _root; }
 bool Route::isDirectoryListingEnabled() const { return _directoryListing; }
@@ -83,19 +86,22 @@ const std::string& Route::getCgiPath() const { return _cgiPath; }
 const std::string& Route::getCgiExtension() const { return _cgiExtension; }
 bool Route::isUploadEnabled() const { return _uploadEnabled; }
 const std::string& Route::getUploadPath() const { return _uploadPath; }
+bool Route::isSendfileEnabled() const { return _sendfile; }
 
 // Setters
 void Route::setPath(const std::string& path) {
 	_path = path;
 }
 
-void Route::addAllowedMethod(const std::string& method) {
-	// Verificar se já existe
-	for (size_t i = 0; i < _allowedMethods.size(); ++i) {
-		if (_allowedMethods[i] == method)
-			return;
-	}
-	_allowedMethods.push_back(method);
+bool Route::addAllowedMethod(const std::string& method) {
+	HTTP::Method::Id id = HTTP::Method::lookup(method);
+	if (id == HTTP::Method::METHOD_UNKNOWN)
+		return false;
+	_allowedMethods |= HTTP::Method::bit(id);
+	// GET inclui HEAD (mesma resposta, sem body)
+	if (id == HTTP::Method::METHOD_GET)
+		_allowedMethods |= HTTP::Method::bit(HTTP::Method::METHOD_HEAD);
+	return true;
 }
 
 void Route::setRedirect(const std::string& redirect) {
@@ -134,13 +140,13 @@ void Route::setUploadPath(const std::string& uploadPath) {
 	_uploadPath = uploadPath;
 }
 
+void Route::setSendfile(bool enabled) {
+	_sendfile = enabled;
+}
+
 // Validation
-bool Route::isMethodAllowed(const std::string& method) const {
-	for (size_t i = 0; i < _allowedMethods.size(); ++i) {
-		if (_allowedMethods[i] == method)
-			return true;
-	}
-	return false;
+bool Route::isMethodAllowed(HTTP::Method::Id method) const {
+	return (_allowedMethods & HTTP::Method::bit(method)) != 0;
 }
 
 bool Route::isValid() const {
@@ -163,13 +169,7 @@ bool Route::isValid() const {
 void Route::print() const {
 	std::cout << "  Route: " << _path << std::endl;
 
-	std::cout << "    Allowed methods: ";
-	for (size_t i = 0; i < _allowedMethods.size(); ++i) {
-		std::cout << _allowedMethods[i];
-		if (i < _allowedMethods.size() - 1)
-			std::cout << ", ";
-	}
-	std::cout << std::endl;
+	std::cout << "    Allowed methods: " << HTTP::Method::list(_allowedMethods) << std::endl;
 
 	if (!_redirect.empty())
 		std::cout << "    Redirect: " << _redirect << std::endl;
@@ -199,4 +199,8 @@ void Route::print() const {
 		std::cout << "    Upload enabled: yes" << std::endl;
 		std::cout << "    Upload path: " << _uploadPath << std::endl;
 	}
+
+	if (!_sendfile) {
+		std::cout << "    Sendfile: off" << std::endl;
+	}
 }
@@ -23,7 +23,21 @@
 Server::Server()
 	: _host("0.0.0.0")
 	, _maxBodySize(1048576) // 1MB default
-	, _isDefaultServer(false) {
+	, _bodyBufferSize(16384)
+	, _clientHeaderTimeout(60)
+	, _keepaliveTimeout(75) // Defaults do nginx
+	, _keepaliveRequests(1000)
+	, _listenBacklog(511) // Default do nginx em Linux
+	, _isDefaultServer(false)
+	, _gzip(false)
+	, _gzipMinLength(256)
+	, _gzipLevel(6) {
+	// Assets de texto (gzip_types substitui a lista)
+	_gzipTypes.push_back("text/html");
+	_gzipTypes.push_back("text/css");
+	_gzipTypes.push_back("text/plain");
+	_gzipTypes.push_back("application/javascript");
+	_gzipTypes.push_back("application/json");
 }
 
 Server::~Server() {}
@@ -38,9 +52,18 @@ Server& Server::operator=(const Server& other) {
 		_host = other._host;
 		_serverNames = other._serverNames;
 		_maxBodySize = other._maxBodySize;
+		_bodyBufferSize = other._bodyBufferSize;
+		_clientHeaderTimeout = other._clientHeaderTimeout;
+		_keepaliveTimeout = other._keepaliveTimeout;
+		_keepaliveRequests = other._keepaliveRequests;
+		_listenBacklog = other._listenBacklog;
 		_errorPages = other._errorPages;
 		_routes = other._routes;
 		_isDefaultServer = other._isDefaultServer;
+		_gzip = other._gzip;
+		_gzipTypes = other._gzipTypes;
+		_gzipMinLength = other._gzipMinLength;
+		_gzipLevel = other._gzipLevel;
 	}
 	return *this;
 }
@@ -50,9 +73,26 @@ const std::vector<int>& Server::getPorts() const { return _ports; }
 const std::string& Server::getHost() const { return _host; }
 const std::vector<std::string>& Server::getServerNames() const { return _serverNames; }
 size_t Server::getMaxBodySize() const { return _maxBodySize; }
+size_t Server::getBodyBufferSize() const { return _bodyBufferSize; }
+time_t Server::getClientHeaderTimeout() const { return _clientHeaderTimeout; }
+time_t Server::getKeepaliveTimeout() const { return _keepaliveTimeout; }
+size_t Server::getKeepaliveRequests() const { return _keepaliveRequests; }
+int Server::getListenBacklog() const { return _listenBacklog; }
 const std::map<int, std::string>& Server::getErrorPages() const { return _errorPages; }
 const std::vector<Route>& Server::getRoutes() const { return _routes; }
 bool Server::isDefaultServer() const { return _isDefaultServer; }
+bool Server::isGzipEnabled() const { return _gzip; }
+size_t Server::getGzipMinLength() const { return _gzipMinLength; }
+int Server::getGzipLevel() const { return _gzipLevel; }
+
+bool Server::isGzipType(const char* mimeType, size_t length) const {
+	for (size_t i = 0; i < _gzipTypes.size(); ++i) {
+		if (_gzipTypes[i].compare(0, std::string::npos, mimeType, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
 
 // Setters
 void Server::addPort(int port) {
@@ -76,6 +116,26 @@ void Server::setMaxBodySize(size_t size) {
 	_maxBodySize = size;
 }
 
+void Server::setBodyBufferSize(size_t size) {
+	_bodyBufferSize = size;
+}
+
+void Server::setClientHeaderTimeout(time_t seconds) {
+	_clientHeaderTimeout = seconds;
+}
+
+void Server::setKeepaliveTimeout(time_t seconds) {
+	_keepaliveTimeout = seconds;
+}
+
+void Server::setKeepaliveRequests(size_t requests) {
+	_keepaliveRequests = requests;
+}
+
+void Server::setListenBacklog(int backlog) {
+	_listenBacklog = backlog;
+}
+
 void Server::setErrorPage(int code, const std::string& path) {
 	_errorPages[code] = path;
 }
@@ -84,6 +144,26 @@ void Server::addRoute(const Route& route) {
 	_routes.push_back(route);
 }
 
+void Server::setGzip(bool enabled) {
+	_gzip = enabled;
+}
+
+void Server::clearGzipTypes() {
+	_gzipTypes.clear();
+}
+
+void Server::addGzipType(const std::string& mimeType) {
+	_gzipTypes.push_back(mimeType);
+}
+
+void Server::setGzipMinLength(size_t length) {
+	_gzipMinLength = length;
+}
+
+void Server::setGzipLevel(int level) {
+	_gzipLevel = level;
+}
+
 void Server::setDefaultServer(bool isDefault) {
 	_isDefaultServer = isDefault;
 }
@@ -177,6 +257,13 @@ void Server::print() const {
 	}
 
 	std::cout << "  Max body size: " << _maxBodySize << " bytes" << std::endl;
+	std::cout << "  Body buffer size: " << _bodyBufferSize << " bytes" << std::endl;
+	if (_gzip) {
+		std::cout << "  Gzip: level " << _gzipLevel << ", from " << _gzipMinLength << " bytes, " << _gzipTypes.size() << " type(s)" << std::endl;
+	}
+	std::cout << "  Client header timeout: " << _clientHeaderTimeout << "s" << std::endl;
+	std::cout << "  Keep-alive: " << _keepaliveTimeout << "s, " << _keepaliveRequests << " requests" << std::endl;
+	std::cout << "  Listen backlog: " << _listenBacklog << std::endl;
 	std::cout << "  Default server: " << (_isDefaultServer ? "yes" : "no") << std::endl;
 
 	if (!_errorPages.empty()) {
@@ -0,0 +1,478 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Master.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:40:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:40:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Master.cpp
+ * Implementation of the prefork process supervisor
+ */
+#include "includes/core/Master.hpp"
+#include "includes/config/ConfigParser.hpp"
+#include "includes/http/ServerManager.hpp"
+#include "includes/http/Compression.hpp"
+#include "includes/core/Instance.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+#ifdef __linux__
+# include <sys/prctl.h>
+#endif
+
+volatile sig_atomic_t Master::s_stopSignal = 0;
+volatile sig_atomic_t Master::s_childExited = 0;
+volatile sig_atomic_t Master::s_alarm = 0;
+volatile sig_atomic_t Master::s_reload = 0;
+volatile sig_atomic_t Master::s_upgrade = 0;
+volatile sig_atomic_t Master::s_stats = 0;
+
+namespace {
+	// Event loop of this process, stopped from SIGINT/SIGTERM/SIGQUIT
+	HTTP::ServerManager* g_serverManager = NULL;
+
+	void stopServer(int sig) {
+		(void)sig;
+		if (g_serverManager) {
+			g_serverManager->stop();
+		}
+	}
+
+	void drainServer(int sig) {
+		(void)sig;
+		if (g_serverManager) {
+			g_serverManager->drain();
+		}
+	}
+
+	void dumpServerStats(int sig) {
+		(void)sig;
+		if (g_serverManager) {
+			g_serverManager->requestStats();
+		}
+	}
+
+	void installHandler(int sig, void (*handler)(int)) {
+		struct sigaction sa;
+		std::memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = handler;
+		sigemptyset(&sa.sa_mask);
+		sa.sa_flags = 0; // No SA_RESTART: waits must return on signals
+		sigaction(sig, &sa, NULL);
+	}
+
+	// Signals the master handles (blocked outside sigsuspend)
+	const int g_masterSignals[] = { SIGINT, SIGTERM, SIGQUIT, SIGCHLD, SIGALRM, SIGHUP, SIGUSR1, SIGUSR2 };
+	const size_t g_masterSignalCount = sizeof(g_masterSignals) / sizeof(g_masterSignals[0]);
+}
+
+// Constructor
+Master::Master(const Config& config, const std::string& configFile, char** argv, ListenerPool& listeners)
+	: _config(config)
+	, _configFile(configFile)
+	, _argv(argv)
+	, _listeners(listeners)
+	, _upgradePid(0)
+	, _failed(false)
+	, _stopping(false) {
+	Worker empty;
+	empty.pid = 0;
+	empty.startedAt = 0;
+	_workers.resize(config.getWorkerProcesses(), empty);
+}
+
+// Destructor
+Master::~Master() {}
+
+// Run one event loop in the current process
+int Master::serve(const Config& config, const std::vector<Socket*>& listeners) {
+	HTTP::ServerManager serverManager;
+
+	// Shared by the loop threads: created before they start
+	Instance::Get<HTTP::Compression>()->setCacheSize(config.getGzipCacheSize());
+
+	if (!serverManager.init(config, listeners)) {
+		Logger::error << "Failed to initialize server manager" << std::endl;
+		return WORKER_INIT_FAILED;
+	}
+
+	// Setup signal handlers
+	g_serverManager = &serverManager;
+	installHandler(SIGINT, stopServer);   // Ctrl+C
+	installHandler(SIGTERM, stopServer);  // kill
+	installHandler(SIGQUIT, drainServer); // Graceful stop
+	installHandler(SIGUSR1, dumpServerStats); // Event loop stats to the log
+	signal(SIGHUP, SIG_IGN);              // Reload and upgrade are the master's job
+	signal(SIGUSR2, SIG_IGN);
+
+	std::cout << std::endl;
+
+	// Start server (blocking)
+	serverManager.run();
+
+	g_serverManager = NULL;
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	signal(SIGQUIT, SIG_DFL);
+	signal(SIGUSR1, SIG_DFL);
+	signal(SIGHUP, SIG_DFL);
+	signal(SIGUSR2, SIG_DFL);
+	return 0;
+}
+
+// Signal handlers only record what happened; the master loop acts on it
+void Master::onStopSignal(int sig) {
+	s_stopSignal = sig;
+}
+
+void Master::onChildExited(int sig) {
+	(void)sig;
+	s_childExited = 1;
+}
+
+void Master::onAlarm(int sig) {
+	(void)sig;
+	s_alarm = 1;
+}
+
+void Master::onReload(int sig) {
+	(void)sig;
+	s_reload = 1;
+}
+
+void Master::onUpgrade(int sig) {
+	(void)sig;
+	s_upgrade = 1;
+}
+
+void Master::onStats(int sig) {
+	(void)sig;
+	s_stats = 1;
+}
+
+// In a forked child: default dispositions and the original (empty) mask
+void Master::resetChildSignals() {
+	for (size_t i = 0; i < g_masterSignalCount; ++i) {
+		signal(g_masterSignals[i], SIG_DFL);
+	}
+	sigset_t empty;
+	sigemptyset(&empty);
+	sigprocmask(SIG_SETMASK, &empty, NULL);
+}
+
+// Spawn the workers and supervise them until stopped
+int Master::run() {
+	// Block the signals we wait for, so none is lost between checks and
+	// sigsuspend(); waitMask is the mask used while suspended
+	sigset_t blocked, savedMask, waitMask;
+	sigemptyset(&blocked);
+	for (size_t i = 0; i < g_masterSignalCount; ++i) {
+		sigaddset(&blocked, g_masterSignals[i]);
+	}
+	sigprocmask(SIG_BLOCK, &blocked, &savedMask);
+
+	waitMask = savedMask;
+	for (size_t i = 0; i < g_masterSignalCount; ++i) {
+		sigdelset(&waitMask, g_masterSignals[i]);
+	}
+
+	installHandler(SIGINT, onStopSignal);
+	installHandler(SIGTERM, onStopSignal);
+	installHandler(SIGQUIT, onStopSignal);
+	installHandler(SIGCHLD, onChildExited);
+	installHandler(SIGALRM, onAlarm);
+	installHandler(SIGHUP, onReload);
+	installHandler(SIGUSR1, onStats);
+	installHandler(SIGUSR2, onUpgrade);
+
+	Logger::info << "Master process " << Logger::param(getpid()) << " starting "
+	             << Logger::param(_workers.size()) << " worker processes" << std::endl;
+
+	for (size_t i = 0; i < _workers.size() && !_failed; ++i) {
+		if (!spawnWorker(i)) {
+			_failed = true;
+		}
+	}
+
+	// Supervise: reap exited workers and respawn the ones that crashed
+	while (!s_stopSignal && !_failed) {
+		sigsuspend(&waitMask);
+
+		if (s_childExited) {
+			s_childExited = 0;
+			reapWorkers();
+		}
+
+		if (s_reload && !_failed) {
+			s_reload = 0;
+			reload();
+		}
+
+		if (s_upgrade) {
+			s_upgrade = 0;
+			upgradeBinary();
+		}
+
+		// Every worker dumps its own loops
+		if (s_stats) {
+			s_stats = 0;
+			signalWorkers(SIGUSR1);
+		}
+
+		for (size_t i = 0; i < _workers.size() && !s_stopSignal && !_failed; ++i) {
+			if (_workers[i].pid != 0) {
+				continue;
+			}
+			// Do not spin on a worker that keeps crashing right after start
+			if (std::time(NULL) - _workers[i].startedAt < RESPAWN_THROTTLE_SEC) {
+				sleep(RESPAWN_THROTTLE_SEC);
+			}
+			if (!spawnWorker(i)) {
+				_failed = true;
+			}
+		}
+	}
+
+	shutdownWorkers(&waitMask);
+
+	for (size_t i = 0; i < g_masterSignalCount; ++i) {
+		signal(g_masterSignals[i], SIG_DFL);
+	}
+	sigprocmask(SIG_SETMASK, &savedMask, NULL);
+
+	return _failed ? 1 : 0;
+}
+
+// Fork a worker for the given slot
+bool Master::spawnWorker(size_t slot) {
+	pid_t masterPid = getpid();
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		Logger::error << "Failed to fork worker #" << slot << ": " << Logger::errstr() << std::endl;
+		return false;
+	}
+
+	if (pid == 0) {
+		resetChildSignals();
+
+#ifdef __linux__
+		// Do not outlive a master that was killed without a chance to forward
+		prctl(PR_SET_PDEATHSIG, SIGTERM);
+		if (getppid() != masterPid) {
+			std::exit(0);
+		}
+#else
+		(void)masterPid;
+#endif
+		// Only this slot's listeners, so closing one elsewhere really closes it
+		_listeners.retain(slot);
+		std::exit(serve(_config, _listeners.forSlot(slot)));
+	}
+
+	_workers[slot].pid = pid;
+	_workers[slot].startedAt = std::time(NULL);
+	Logger::success << "Worker #" << slot << " started (pid: " << pid << ")" << std::endl;
+	return true;
+}
+
+// SIGHUP: start a new generation on the new configuration, drain the old one
+void Master::reload() {
+	Logger::info << "Reloading configuration from " << Logger::param(_configFile) << std::endl;
+
+	// Nothing changes unless the new file parses and every listener opens
+	Config config;
+	ConfigParser parser;
+	if (!parser.parse(_configFile, config)) {
+		Logger::error << parser.getError() << std::endl;
+		Logger::error << "Reload aborted, keeping the current configuration" << std::endl;
+		return;
+	}
+	if (!_listeners.sync(config, config.getWorkerProcesses())) {
+		Logger::error << "Reload aborted, keeping the current configuration" << std::endl;
+		return;
+	}
+
+	std::vector<pid_t> previous;
+	for (size_t i = 0; i < _workers.size(); ++i) {
+		if (_workers[i].pid != 0) {
+			previous.push_back(_workers[i].pid);
+		}
+	}
+
+	_config = config;
+	Worker empty;
+	empty.pid = 0;
+	empty.startedAt = 0;
+	_workers.assign(config.getWorkerProcesses(), empty);
+
+	for (size_t i = 0; i < _workers.size() && !_failed; ++i) {
+		if (!spawnWorker(i)) {
+			_failed = true;
+		}
+	}
+
+	// The new generation is accepting: the old one stops and drains
+	for (size_t i = 0; i < previous.size(); ++i) {
+		kill(previous[i], SIGQUIT);
+		_retiring.push_back(previous[i]);
+	}
+
+	Logger::success << "Configuration reloaded, " << previous.size()
+	                << " old worker(s) draining" << std::endl;
+}
+
+// SIGUSR2: exec the (possibly replaced) binary with the listeners inherited
+void Master::upgradeBinary() {
+	if (_upgradePid != 0) {
+		Logger::warning << "Binary upgrade already running (pid: " << _upgradePid << ")" << std::endl;
+		return;
+	}
+
+	std::string inherited = _listeners.serialize();
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		Logger::error << "Failed to fork new binary: " << Logger::errstr() << std::endl;
+		return;
+	}
+
+	if (pid == 0) {
+		resetChildSignals();
+		_listeners.keepAcrossExec();
+		setenv(ListenerPool::ENV_NAME, inherited.c_str(), 1);
+		execv(_argv[0], _argv);
+		Logger::error << "Failed to execute " << _argv[0] << ": " << Logger::errstr() << std::endl;
+		_exit(WORKER_INIT_FAILED);
+	}
+
+	_upgradePid = pid;
+	Logger::info << "Started new binary " << Logger::param(_argv[0]) << " (pid: " << pid
+	             << "), send SIGQUIT to " << getpid() << " once it is serving" << std::endl;
+}
+
+// Collect every exited child and free its slot
+void Master::reapWorkers() {
+	int status;
+	pid_t pid;
+
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+		if (pid == _upgradePid) {
+			_upgradePid = 0;
+			Logger::warning << "New binary (pid: " << pid << ") exited, this master keeps serving" << std::endl;
+			continue;
+		}
+
+		for (size_t i = 0; i < _retiring.size(); ++i) {
+			if (_retiring[i] == pid) {
+				_retiring.erase(_retiring.begin() + i);
+				Logger::info << "Old worker (pid: " << pid << ") drained" << std::endl;
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < _workers.size(); ++i) {
+			if (_workers[i].pid != pid) {
+				continue;
+			}
+			_workers[i].pid = 0;
+
+			if (WIFEXITED(status) && WEXITSTATUS(status) == WORKER_INIT_FAILED) {
+				Logger::error << "Worker #" << i << " (pid: " << pid << ") failed to start" << std::endl;
+				_failed = true;
+			} else if (_stopping) {
+				Logger::info << "Worker #" << i << " (pid: " << pid << ") stopped" << std::endl;
+			} else if (WIFSIGNALED(status)) {
+				Logger::warning << "Worker #" << i << " (pid: " << pid << ") killed by signal "
+				                << WTERMSIG(status) << ", respawning" << std::endl;
+			} else {
+				Logger::warning << "Worker #" << i << " (pid: " << pid << ") exited with status "
+				                << WEXITSTATUS(status) << ", respawning" << std::endl;
+			}
+			break;
+		}
+	}
+}
+
+// Send a signal to every live worker, old generations included
+void Master::signalWorkers(int sig) {
+	for (size_t i = 0; i < _workers.size(); ++i) {
+		if (_workers[i].pid != 0) {
+			kill(_workers[i].pid, sig);
+		}
+	}
+	for (size_t i = 0; i < _retiring.size(); ++i) {
+		kill(_retiring[i], sig);
+	}
+}
+
+size_t Master::liveWorkers() const {
+	size_t count = _retiring.size();
+	for (size_t i = 0; i < _workers.size(); ++i) {
+		if (_workers[i].pid != 0) {
+			++count;
+		}
+	}
+	return count;
+}
+
+// Forward the stop signal and wait for the workers to exit
+// SIGQUIT lets them drain for as long as they need; a SIGINT/SIGTERM
+// meanwhile turns it into a fast stop
+void Master::shutdownWorkers(sigset_t* waitMask) {
+	int sig = s_stopSignal ? s_stopSignal : SIGTERM;
+
+	_stopping = true;
+	s_stopSignal = 0;
+	if (liveWorkers() == 0) {
+		return;
+	}
+
+	bool graceful = (sig == SIGQUIT);
+	Logger::warning << (graceful ? "Gracefully stopping " : "Stopping ") << liveWorkers() << " workers..." << std::endl;
+	signalWorkers(sig);
+
+	// A second stop signal or the grace period running out kills the rest
+	bool killed = false;
+	s_alarm = 0;
+	if (!graceful) {
+		alarm(SHUTDOWN_GRACE_SEC);
+	}
+
+	while (liveWorkers() > 0) {
+		sigsuspend(waitMask);
+
+		if (s_childExited) {
+			s_childExited = 0;
+			reapWorkers();
+		}
+		if (liveWorkers() == 0) {
+			break;
+		}
+
+		if (graceful) {
+			if (s_stopSignal && s_stopSignal != SIGQUIT) {
+				Logger::warning << "Fast stop requested, stopping " << liveWorkers() << " workers..." << std::endl;
+				signalWorkers(SIGTERM);
+				alarm(SHUTDOWN_GRACE_SEC);
+				graceful = false;
+			}
+			s_stopSignal = 0;
+		} else if (!killed && (s_stopSignal || s_alarm)) {
+			Logger::warning << "Workers did not stop, killing them" << std::endl;
+			signalWorkers(SIGKILL);
+			killed = true;
+		}
+	}
+
+	alarm(0);
+}
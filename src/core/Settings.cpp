@@ -16,8 +16,45 @@
  */
 #include "includes/core/Settings.hpp"
 
-Settings::Settings() {
+namespace {
+    // Range of the preformatted status lines
+    const int FIRST_STATUS = 100;
+    const int LAST_STATUS = 599;
+}
+
+Settings::Settings() : _defaultMimeType("application/octet-stream") {
     // Constructor - settings are hard-coded
+    // Static mime type mapping
+    // In a real implementation, this would be loaded from config
+    _mimeTypes["html"] = "text/html";
+    _mimeTypes["htm"] = "text/html";
+    _mimeTypes["css"] = "text/css";
+    _mimeTypes["js"] = "application/javascript";
+    _mimeTypes["json"] = "application/json";
+    _mimeTypes["xml"] = "application/xml";
+    _mimeTypes["txt"] = "text/plain";
+    _mimeTypes["csv"] = "text/csv";
+    _mimeTypes["png"] = "image/png";
+    _mimeTypes["jpg"] = "image/jpeg";
+    _mimeTypes["jpeg"] = "image/jpeg";
+    _mimeTypes["gif"] = "image/gif";
+    _mimeTypes["svg"] = "image/svg+xml";
+    _mimeTypes["ico"] = "image/x-icon";
+    _mimeTypes["pdf"] = "application/pdf";
+    _mimeTypes["zip"] = "application/zip";
+    _mimeTypes["tar"] = "application/x-tar";
+    _mimeTypes["gz"] = "application/gzip";
+
+    // Status lines, formatted once
+    _unknownStatus = "Unknown Status";
+    for (int code = FIRST_STATUS; code <= LAST_STATUS; ++code) {
+        const char* message = statusMessage(code);
+        _statusMessages.push_back(message ? message : _unknownStatus);
+
+        char digits[4] = { static_cast<char>('0' + code / 100), static_cast<char>('0' + code / 10 % 10),
+                           static_cast<char>('0' + code % 10), '\0' };
+        _statusLines.push_back(std::string("HTTP/1.1 ") + digits + " " + _statusMessages.back() + "\r\n");
+    }
 }
 
 bool Settings::isValid() const {
@@ -25,13 +62,28 @@ bool Settings::isValid() const {
     return true;
 }
 
-const std::string Settings::httpStatusCode(int code) const {
+const std::string& Settings::httpStatusCode(int code) const {
+    if (code < FIRST_STATUS || code > LAST_STATUS) {
+        return _unknownStatus;
+    }
+    return _statusMessages[code - FIRST_STATUS];
+}
+
+const std::string& Settings::httpStatusLine(int code) const {
+    if (code < FIRST_STATUS || code > LAST_STATUS) {
+        return _noStatusLine;
+    }
+    return _statusLines[code - FIRST_STATUS];
+}
+
+const char* Settings::statusMessage(int code) {
     // Basic HTTP status code mapping
     // In a real implementation, this would be loaded from config
     switch (code) {
         case 200: return "OK";
         case 201: return "Created";
         case 204: return "No Content";
+        case 206: return "Partial Content";
         case 301: return "Moved Permanently";
         case 302: return "Found";
         case 304: return "Not Modified";
@@ -41,53 +93,26 @@ const std::string Settings::httpStatusCode(int code) const {
         case 404: return "Not Found";
         case 405: return "Method Not Allowed";
         case 408: return "Request Timeout";
+        case 409: return "Conflict";
         case 413: return "Payload Too Large";
         case 414: return "URI Too Long";
+        case 416: return "Range Not Satisfiable";
+        case 431: return "Request Header Fields Too Large";
         case 500: return "Internal Server Error";
         case 501: return "Not Implemented";
         case 502: return "Bad Gateway";
         case 503: return "Service Unavailable";
         case 504: return "Gateway Timeout";
         case 505: return "HTTP Version Not Supported";
-        default: return "Unknown Status";
+        default: return NULL;
     }
 }
 
 const std::string& Settings::httpMimeType(const std::string& ext) const {
-    // Static mime type mapping
-    // In a real implementation, this would be loaded from config
-    static std::map<std::string, std::string> mimeTypes;
-    static bool initialized = false;
-
-    // Initialize the map on first use (C++98 compatible)
-    if (!initialized) {
-        mimeTypes["html"] = "text/html";
-        mimeTypes["htm"] = "text/html";
-        mimeTypes["css"] = "text/css";
-        mimeTypes["js"] = "application/javascript";
-        mimeTypes["json"] = "application/json";
-        mimeTypes["xml"] = "application/xml";
-        mimeTypes["txt"] = "text/plain";
-        mimeTypes["csv"] = "text/csv";
-        mimeTypes["png"] = "image/png";
-        mimeTypes["jpg"] = "image/jpeg";
-        mimeTypes["jpeg"] = "image/jpeg";
-        mimeTypes["gif"] = "image/gif";
-        mimeTypes["svg"] = "image/svg+xml";
-        mimeTypes["ico"] = "image/x-icon";
-        mimeTypes["pdf"] = "application/pdf";
-        mimeTypes["zip"] = "application/zip";
-        mimeTypes["tar"] = "application/x-tar";
-        mimeTypes["gz"] = "application/gzip";
-        initialized = true;
-    }
-
-    static std::string defaultType = "application/octet-stream";
-
-    std::map<std::string, std::string>::const_iterator it = mimeTypes.find(ext);
-    if (it != mimeTypes.end()) {
+    std::map<std::string, std::string>::const_iterator it = _mimeTypes.find(ext);
+    if (it != _mimeTypes.end()) {
         return it->second;
     }
 
-    return defaultType;
+    return _defaultMimeType;
 }
@@ -0,0 +1,160 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BodySink.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:31:45 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 23:31:45 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * BodySink.cpp
+ * Implementation of the request body sink
+ */
+#include "includes/http/BodySink.hpp"
+#include "includes/utils/Logger.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace HTTP {
+
+const char* BodySink::TEMP_TEMPLATE = "/tmp/webserv-body-XXXXXX";
+
+BodySink::BodySink()
+	: _size(0)
+	, _bufferSize(DEFAULT_BUFFER_SIZE)
+	, _fd(-1)
+	, _map(NULL)
+	, _mapSize(0) {
+}
+
+BodySink::~BodySink() {
+	clear();
+}
+
+void BodySink::setBufferSize(size_t size) {
+	_bufferSize = size;
+}
+
+bool BodySink::write(const char* data, size_t length) {
+	if (_fd < 0 && _bufferSize > 0 && _size + length > _bufferSize && !spool()) {
+		return false;
+	}
+	if (_fd < 0) {
+		_data.append(data, length);
+		_size += length;
+		return true;
+	}
+
+	unmap();
+	size_t written = 0;
+	while (written < length) {
+		ssize_t n = ::write(_fd, data + written, length - written);
+		if (n <= 0) {
+			Logger::error << "Failed to write request body to its temp file" << std::endl;
+			return false;
+		}
+		written += static_cast<size_t>(n);
+	}
+	_size += length;
+	return true;
+}
+
+size_t BodySink::size() const {
+	return _size;
+}
+
+bool BodySink::isSpooled() const {
+	return _fd >= 0;
+}
+
+int BodySink::fd() const {
+	return _fd;
+}
+
+// Mapped once per size: repeated calls between writes are free
+const char* BodySink::bytes() const {
+	if (_fd < 0 || _size == 0) {
+		return _data.data();
+	}
+	if (_map == NULL || _mapSize != _size) {
+		unmap();
+		void* mapped = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+		if (mapped == MAP_FAILED) {
+			Logger::error << "Failed to map the request body temp file" << std::endl;
+			return NULL;
+		}
+		_map = mapped;
+		_mapSize = _size;
+	}
+	return static_cast<const char*>(_map);
+}
+
+std::string BodySink::str() const {
+	const char* data = bytes();
+	return data ? std::string(data, _size) : std::string();
+}
+
+void BodySink::swap(BodySink& other) {
+	_data.swap(other._data);
+	std::swap(_size, other._size);
+	std::swap(_fd, other._fd);
+	std::swap(_map, other._map);
+	std::swap(_mapSize, other._mapSize);
+}
+
+void BodySink::clear() {
+	unmap();
+	if (_fd >= 0) {
+		::close(_fd);
+		_fd = -1;
+	}
+	_data.clear();
+	_size = 0;
+}
+
+// Move what is in memory to a new temp file; the name is unlinked right
+// away, so the file goes when the descriptor is closed. Close-on-exec:
+// CGI children forked meanwhile must not inherit other requests' bodies
+bool BodySink::spool() {
+	std::string path(TEMP_TEMPLATE);
+#ifdef __linux__
+	int fd = mkostemp(&path[0], O_CLOEXEC);
+#else
+	int fd = mkstemp(&path[0]);
+	if (fd >= 0) {
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+	}
+#endif
+	if (fd < 0) {
+		Logger::error << "Failed to create a temp file for the request body" << std::endl;
+		return false;
+	}
+	unlink(path.c_str());
+	_fd = fd;
+
+	size_t buffered = _size;
+	_size = 0;
+	if (!write(_data.data(), buffered)) {
+		return false;
+	}
+	std::string().swap(_data);      // Release the memory, not just the size
+	Logger::debug << "Request body spooled to a temp file (fd: " << _fd << ")" << std::endl;
+	return true;
+}
+
+void BodySink::unmap() const {
+	if (_map != NULL) {
+		munmap(_map, _mapSize);
+		_map = NULL;
+		_mapSize = 0;
+	}
+}
+
+} // namespace HTTP
@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CompressedStream.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * CompressedStream.cpp
+ * Implementation of the on-the-fly compressed file body
+ */
+#include "includes/http/CompressedStream.hpp"
+#include <unistd.h>
+
+namespace HTTP {
+
+CompressedStream::CompressedStream(int fd, off_t offset, size_t length, Compressor::Encoding encoding, int level)
+	: _fd(fd)
+	, _offset(offset)
+	, _left(length)
+	, _started(false)
+	, _done(false) {
+	_started = _compressor.begin(encoding, level);
+}
+
+CompressedStream::~CompressedStream() {
+	if (_fd >= 0) {
+		close(_fd);
+	}
+}
+
+bool CompressedStream::read(std::string& out) {
+	if (!_started) {
+		return false;
+	}
+
+	// zlib may hold a whole read back: read on until it gives something
+	_payload.clear();
+	bool last = false;
+	while (_payload.empty() && !last) {
+		if (_left > 0) {
+			if (_buffer.empty()) {
+				_buffer.resize(READ_SIZE);
+			}
+			size_t wanted = (_left < _buffer.size()) ? _left : _buffer.size();
+			ssize_t got = pread(_fd, &_buffer[0], wanted, _offset);
+			if (got <= 0 || !_compressor.write(&_buffer[0], static_cast<size_t>(got), _payload)) {
+				return false;   // Truncated since it was opened
+			}
+			_offset += got;
+			_left -= static_cast<size_t>(got);
+		}
+		if (_left == 0) {
+			if (!_compressor.finish(_payload)) {
+				return false;
+			}
+			last = true;
+		}
+	}
+
+	if (!_payload.empty()) {
+		static const char DIGITS[] = "0123456789abcdef";
+		char size[32];
+		char* pos = size + sizeof(size);
+		size_t value = _payload.size();
+		do {
+			*--pos = DIGITS[value % 16];
+			value /= 16;
+		} while (value != 0);
+		out.append(pos, static_cast<size_t>(size + sizeof(size) - pos));
+		out.append("\r\n", 2);
+		out += _payload;
+		out.append("\r\n", 2);
+	}
+	if (last) {
+		out.append("0\r\n\r\n", 5);
+		_done = true;
+		close(_fd);
+		_fd = -1;
+	}
+	return true;
+}
+
+bool CompressedStream::done() const {
+	return _done;
+}
+
+} // namespace HTTP
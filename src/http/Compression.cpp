@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Compression.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Compression.cpp
+ * Implementation of the shared compression cache and load-based level
+ */
+#include "includes/http/Compression.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cstdio>
+
+namespace HTTP {
+
+Compression::Compression()
+	: _cacheSize(0)
+	, _cacheUsed(0)
+	, _sampledAt(0)
+	, _lastBusy(0)
+	, _lastTotal(0)
+	, _step(0) {
+	pthread_mutex_init(&_mutex, NULL);
+}
+
+Compression::~Compression() {
+	pthread_mutex_destroy(&_mutex);
+}
+
+void Compression::setCacheSize(size_t bytes) {
+	pthread_mutex_lock(&_mutex);
+	_cacheSize = bytes;
+	evict(0);
+	pthread_mutex_unlock(&_mutex);
+}
+
+size_t Compression::maxEntrySize() const {
+	return _cacheSize / 8;
+}
+
+bool Compression::lookup(const std::string& key, std::string& out) {
+	pthread_mutex_lock(&_mutex);
+	std::map<std::string, EntryList::iterator>::iterator found = _index.find(key);
+	bool hit = (found != _index.end());
+	if (hit) {
+		_entries.splice(_entries.begin(), _entries, found->second);
+		out = found->second->data;
+	}
+	pthread_mutex_unlock(&_mutex);
+	return hit;
+}
+
+void Compression::store(const std::string& key, const std::string& data) {
+	if (data.size() > maxEntrySize()) {
+		return;
+	}
+	pthread_mutex_lock(&_mutex);
+	if (_index.find(key) == _index.end()) {
+		evict(data.size());
+		_entries.push_front(Entry());
+		_entries.front().key = key;
+		_entries.front().data = data;
+		_index[key] = _entries.begin();
+		_cacheUsed += data.size();
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+// Drop the least recently used entries until needed more bytes fit (locked)
+void Compression::evict(size_t needed) {
+	while (!_entries.empty() && _cacheUsed + needed > _cacheSize) {
+		_cacheUsed -= _entries.back().data.size();
+		_index.erase(_entries.back().key);
+		_entries.pop_back();
+	}
+}
+
+int Compression::level(int configured) {
+	time_t now = time(NULL);
+	pthread_mutex_lock(&_mutex);
+	if (now != _sampledAt) {
+		sampleLoad(now);
+	}
+	int step = _step;
+	pthread_mutex_unlock(&_mutex);
+
+	if (step >= MAX_STEP) {
+		return 0;
+	}
+	int adjusted = configured >> step;
+	return (adjusted < 1) ? 1 : adjusted;
+}
+
+// CPU busy % since the previous sample, from the first line of /proc/stat
+// (locked; without /proc the level stays as configured)
+void Compression::sampleLoad(time_t now) {
+	_sampledAt = now;
+	FILE* stat = fopen("/proc/stat", "r");
+	if (!stat) {
+		return;
+	}
+	unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+	int fields = fscanf(stat, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+	                    &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
+	fclose(stat);
+	if (fields < 4) {
+		return;
+	}
+
+	unsigned long long busy = user + nice + system + irq + softirq + steal;
+	unsigned long long total = busy + idle + iowait;
+	bool first = (_lastTotal == 0);
+	unsigned long long busyDelta = busy - _lastBusy;
+	unsigned long long totalDelta = total - _lastTotal;
+	_lastBusy = busy;
+	_lastTotal = total;
+	if (first || totalDelta == 0) {
+		return;
+	}
+
+	int percent = static_cast<int>(busyDelta * 100 / totalDelta);
+	int step = _step;
+	if (percent >= BUSY_HIGH && step < MAX_STEP) {
+		++step;
+	} else if (percent <= BUSY_LOW && step > 0) {
+		--step;
+	}
+	if (step != _step) {
+		Logger::warning << "CPU " << percent << "% busy: compression "
+		                << (step > _step ? "backing off" : "recovering") << " (step " << step
+		                << "/" << MAX_STEP << ")" << std::endl;
+		_step = step;
+	}
+}
+
+} // namespace HTTP
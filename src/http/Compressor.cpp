@@ -0,0 +1,229 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Compressor.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 07:02:18 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 07:02:18 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Compressor.cpp
+ * Implementation of the gzip/deflate compressor
+ */
+#include "includes/http/Compressor.hpp"
+#include <strings.h>
+#ifdef WEBSERV_GZIP
+# include <zlib.h>
+#endif
+
+namespace HTTP {
+
+namespace {
+	bool isSpace(char c) {
+		return c == ' ' || c == '\t';
+	}
+
+	// q value in thousandths ("q=0.5" -> 500); no q means 1
+	int parseQuality(const char* pos, const char* end) {
+		while (pos < end && *pos != ';') {
+			++pos;
+		}
+		while (pos < end) {
+			++pos;
+			while (pos < end && isSpace(*pos)) {
+				++pos;
+			}
+			if (end - pos >= 2 && (*pos == 'q' || *pos == 'Q') && pos[1] == '=') {
+				pos += 2;
+				int quality = 0;
+				if (pos < end && (*pos == '0' || *pos == '1')) {
+					quality = (*pos++ - '0') * 1000;
+				}
+				if (pos < end && *pos == '.') {
+					++pos;
+					for (int scale = 100; scale > 0 && pos < end && *pos >= '0' && *pos <= '9'; scale /= 10) {
+						quality += (*pos++ - '0') * scale;
+					}
+				}
+				return quality > 1000 ? 1000 : quality;
+			}
+			while (pos < end && *pos != ';') {
+				++pos;
+			}
+		}
+		return 1000;
+	}
+
+	bool tokenIs(const char* token, size_t length, const char* name) {
+		size_t nameLength = 0;
+		while (name[nameLength]) {
+			++nameLength;
+		}
+		return length == nameLength && strncasecmp(token, name, length) == 0;
+	}
+}
+
+Compressor::Compressor() : _stream(NULL) {}
+
+Compressor::~Compressor() {
+	end();
+}
+
+bool Compressor::isAvailable() {
+#ifdef WEBSERV_GZIP
+	return true;
+#else
+	return false;
+#endif
+}
+
+Compressor::Encoding Compressor::negotiate(const char* acceptEncoding, size_t size) {
+	if (!isAvailable()) {
+		return ENCODING_IDENTITY;
+	}
+	int gzip = -1;
+	int deflate = -1;
+	int any = -1;
+
+	const char* pos = acceptEncoding;
+	const char* end = pos + size;
+	while (pos < end) {
+		while (pos < end && (isSpace(*pos) || *pos == ',')) {
+			++pos;
+		}
+		const char* token = pos;
+		while (pos < end && *pos != ',' && *pos != ';' && !isSpace(*pos)) {
+			++pos;
+		}
+		size_t length = static_cast<size_t>(pos - token);
+		const char* item = pos;
+		while (pos < end && *pos != ',') {
+			++pos;
+		}
+		if (length == 0) {
+			continue;
+		}
+		int quality = parseQuality(item, pos);
+		if (tokenIs(token, length, "gzip") || tokenIs(token, length, "x-gzip")) {
+			gzip = quality;
+		} else if (tokenIs(token, length, "deflate")) {
+			deflate = quality;
+		} else if (tokenIs(token, length, "*")) {
+			any = quality;
+		}
+	}
+
+	if (gzip < 0) {
+		gzip = (any < 0) ? 0 : any;
+	}
+	if (deflate < 0) {
+		deflate = (any < 0) ? 0 : any;
+	}
+	if (gzip > 0 && gzip >= deflate) {
+		return ENCODING_GZIP;
+	}
+	return (deflate > 0) ? ENCODING_DEFLATE : ENCODING_IDENTITY;
+}
+
+const char* Compressor::name(Encoding encoding) {
+	switch (encoding) {
+		case ENCODING_GZIP:
+			return "gzip";
+		case ENCODING_DEFLATE:
+			return "deflate";
+		default:
+			return "";
+	}
+}
+
+bool Compressor::compress(Encoding encoding, int level, const char* data, size_t length, std::string& out) {
+	Compressor compressor;
+	return compressor.begin(encoding, level)
+	    && compressor.write(data, length, out)
+	    && compressor.finish(out);
+}
+
+bool Compressor::begin(Encoding encoding, int level) {
+	end();
+#ifdef WEBSERV_GZIP
+	if (encoding == ENCODING_IDENTITY) {
+		return false;
+	}
+	z_stream* stream = new z_stream();
+	stream->zalloc = Z_NULL;
+	stream->zfree = Z_NULL;
+	stream->opaque = Z_NULL;
+	// windowBits + 16: gzip header and trailer instead of the zlib ones
+	int windowBits = (encoding == ENCODING_GZIP) ? 15 + 16 : 15;
+	if (deflateInit2(stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		delete stream;
+		return false;
+	}
+	_stream = stream;
+	return true;
+#else
+	(void)encoding;
+	(void)level;
+	return false;
+#endif
+}
+
+bool Compressor::write(const char* data, size_t length, std::string& out) {
+	return run(data, length, false, out);
+}
+
+bool Compressor::finish(std::string& out) {
+	bool finished = run(NULL, 0, true, out);
+	end();
+	return finished;
+}
+
+bool Compressor::run(const char* data, size_t length, bool last, std::string& out) {
+#ifdef WEBSERV_GZIP
+	z_stream* stream = static_cast<z_stream*>(_stream);
+	if (!stream) {
+		return false;
+	}
+	stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	stream->avail_in = static_cast<uInt>(length);
+	int flush = last ? Z_FINISH : Z_NO_FLUSH;
+	int status;
+	do {
+		// Room for what the input can turn into, written straight into out
+		size_t start = out.size();
+		size_t room = deflateBound(stream, stream->avail_in) + 64;
+		out.resize(start + room);
+		stream->next_out = reinterpret_cast<Bytef*>(&out[start]);
+		stream->avail_out = static_cast<uInt>(room);
+		status = deflate(stream, flush);
+		out.resize(start + room - stream->avail_out);
+		if (status == Z_STREAM_ERROR) {
+			return false;
+		}
+	} while (stream->avail_in > 0 || (last && status != Z_STREAM_END));
+	return true;
+#else
+	(void)data;
+	(void)length;
+	(void)last;
+	(void)out;
+	return false;
+#endif
+}
+
+void Compressor::end() {
+#ifdef WEBSERV_GZIP
+	z_stream* stream = static_cast<z_stream*>(_stream);
+	if (stream) {
+		deflateEnd(stream);
+		delete stream;
+		_stream = NULL;
+	}
+#endif
+}
+
+} // namespace HTTP
@@ -0,0 +1,527 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventLoop.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 15:10:37 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 15:10:37 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * EventLoop.cpp
+ * Implementation of a single reactor loop
+ */
+#include "includes/http/EventLoop.hpp"
+#include "includes/http/ServerManager.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdint.h>
+#ifdef __linux__
+# include <sys/eventfd.h>
+#endif
+
+namespace HTTP {
+
+// Constructor
+EventLoop::EventLoop(ServerManager* acceptor, size_t id)
+	: _acceptor(acceptor)
+	, _id(id)
+	, _poller(NULL)
+	, _handoffs(HANDOFF_CAPACITY)
+	, _wakeReadFd(-1)
+	, _wakeWriteFd(-1)
+	, _wakePending(0)
+	, _load(0)
+	, _running(0)
+	, _draining(0)
+	, _drainStarted(false)
+	, _handoffsPending(false)
+	, _statsRequested(0)
+	, _phaseMark(0) {}
+
+// Destructor
+EventLoop::~EventLoop() {
+	cleanupAllConnections();
+
+	// Sockets accepted or posted but never adopted
+	for (size_t i = 0; i < _adopted.size(); ++i) {
+		close(_adopted[i].fd);
+	}
+	Handoff handoff;
+	while (_handoffs.pop(handoff)) {
+		close(handoff.fd);
+	}
+
+	if (_wakeReadFd >= 0) {
+		close(_wakeReadFd);
+	}
+	if (_wakeWriteFd >= 0 && _wakeWriteFd != _wakeReadFd) {
+		close(_wakeWriteFd);
+	}
+	delete _poller;
+}
+
+// Create the event backend and the wakeup channel
+bool EventLoop::init(const std::string& backendName) {
+	if (!setupPoller(backendName)) {
+		return false;
+	}
+	if (!setupWakeup()) {
+		Logger::error << "Failed to create wakeup channel for loop #" << _id << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Setup event backend (events { use ...; } or build default)
+bool EventLoop::setupPoller(const std::string& backendName) {
+	Poller::Backend backend = Poller::defaultBackend();
+
+	if (!backendName.empty() && !Poller::parseBackend(backendName, backend)) {
+		Logger::error << "Unknown event backend: " << backendName << std::endl;
+		return false;
+	}
+
+	_poller = Poller::create(backend);
+	Logger::debug << "Loop #" << _id << " using " << _poller->getName() << " event backend" << std::endl;
+	return true;
+}
+
+// Wakeup channel: eventfd on Linux, a self-pipe elsewhere
+bool EventLoop::setupWakeup() {
+#ifdef __linux__
+	_wakeReadFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_wakeReadFd < 0) {
+		return false;
+	}
+	_wakeWriteFd = _wakeReadFd;
+#else
+	int fds[2];
+	if (pipe(fds) < 0) {
+		return false;
+	}
+	for (int i = 0; i < 2; ++i) {
+		fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+		fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+	}
+	_wakeReadFd = fds[0];
+	_wakeWriteFd = fds[1];
+#endif
+
+	if (!_poller->add(_wakeReadFd, POLLIN)) {
+		return false;
+	}
+	FdSlot& slot = slotFor(_wakeReadFd);
+	slot.kind = FD_WAKEUP;
+	slot.connection = NULL;
+	return true;
+}
+
+// Interrupt the wait; several wakeups before the loop drains cost one write
+void EventLoop::wake() {
+	if (__atomic_exchange_n(&_wakePending, 1, __ATOMIC_ACQ_REL) != 0) {
+		return;
+	}
+#ifdef __linux__
+	uint64_t one = 1;
+	ssize_t ret = write(_wakeWriteFd, &one, sizeof(one));
+#else
+	char one = 1;
+	ssize_t ret = write(_wakeWriteFd, &one, sizeof(one));
+#endif
+	(void)ret; // A full pipe/counter already means a wakeup is pending
+}
+
+void EventLoop::drainWakeup() {
+	// Clear the flag first: a wake() racing with the drain writes again.
+	// An exchange (not a plain store) so the drain sees every push made
+	// before the last wake() that found the flag already set
+	__atomic_exchange_n(&_wakePending, 0, __ATOMIC_ACQ_REL);
+
+	char buffer[64];
+	while (read(_wakeReadFd, buffer, sizeof(buffer)) > 0) {
+	}
+}
+
+// Watch a listening socket; its events go to the acceptor
+bool EventLoop::addListener(Socket* listener) {
+	if (!_poller->addListener(listener->getFd())) {
+		return false;
+	}
+	FdSlot& slot = slotFor(listener->getFd());
+	slot.kind = FD_LISTENER;
+	slot.listener = listener;
+	return true;
+}
+
+// Run the loop until stop()
+void EventLoop::run() {
+	__atomic_store_n(&_running, 1, __ATOMIC_RELEASE);
+
+	while (__atomic_load_n(&_running, __ATOMIC_ACQUIRE)) {
+		// Graceful stop: no new clients, leave once the current ones are done
+		if (__atomic_load_n(&_draining, __ATOMIC_ACQUIRE)) {
+			if (!_drainStarted) {
+				closeListeners();
+				closeIdleConnections();
+				_drainStarted = true;
+				Logger::info << "Loop #" << _id << " draining " << load() << " connection(s)" << std::endl;
+			}
+			if (load() == 0) {
+				break;
+			}
+		}
+
+		if (_statsRequested) {
+			_statsRequested = 0;
+			_acceptor->dumpStats();
+		}
+
+		// Sleep until the next timer deadline at most
+		int pollResult = _poller->wait(_readyEvents, _timers.nextTimeout(MAX_WAIT_MS));
+
+		if (pollResult < 0) {
+			if (errno == EINTR) {
+				// Interrupted by signal, continue
+				continue;
+			}
+			Logger::error << _poller->getName() << "() failed: " << std::strerror(errno) << std::endl;
+			break;
+		}
+
+		// One clock read per iteration for the timers, shared by every
+		// connection; phases are timed from one mark to the next
+		unsigned long long wokeUs = LoopStats::monotonicUs();
+		_phaseMark = wokeUs;
+		_timers.advance(wokeUs / 1000);
+
+		// Only the ready file descriptors are visited
+		for (size_t i = 0; i < _readyEvents.size(); ++i) {
+			dispatchEvent(_readyEvents[i]);
+		}
+
+		// New sockets (this loop's accepts and hand-offs) are registered after
+		// the batch: one registered mid-batch could reuse the number of a
+		// socket closed earlier in it, and bytes the backend already received
+		// for the old socket would reach it
+		if (_handoffsPending) {
+			_handoffsPending = false;
+			drainHandoffs();
+			phaseDone(LoopStats::PHASE_ACCEPT);
+		}
+
+		// Close connections whose deadline passed (runs under load too)
+		expireTimers();
+		phaseDone(LoopStats::PHASE_TIMERS);
+		_stats.record(LoopStats::PHASE_LAG, _phaseMark - wokeUs);
+	}
+}
+
+// Account the time since the previous mark to a phase
+unsigned long long EventLoop::phaseDone(LoopStats::Phase phase) {
+	unsigned long long now = LoopStats::monotonicUs();
+	unsigned long long elapsed = now - _phaseMark;
+	_stats.record(phase, elapsed);
+	_phaseMark = now;
+	return elapsed;
+}
+
+// Stop the loop (only a flag and a write, so safe from signal handlers)
+void EventLoop::stop() {
+	__atomic_store_n(&_running, 0, __ATOMIC_RELEASE);
+	wake();
+}
+
+// Graceful stop (only a flag and a write, so safe from signal handlers)
+void EventLoop::drain() {
+	__atomic_store_n(&_draining, 1, __ATOMIC_RELEASE);
+	wake();
+}
+
+// Stop watching and close every listener of this loop
+void EventLoop::closeListeners() {
+	for (size_t fd = 0; fd < _fdTable.size(); ++fd) {
+		if (_fdTable[fd].kind == FD_LISTENER) {
+			_poller->remove(static_cast<int>(fd));
+			_fdTable[fd].listener->close();
+			clearSlot(static_cast<int>(fd));
+		}
+	}
+}
+
+// Graceful stop: idle keep-alive clients are closed, busy ones after their response
+void EventLoop::closeIdleConnections() {
+	for (size_t fd = 0; fd < _fdTable.size(); ++fd) {
+		if (_fdTable[fd].kind == FD_CLIENT) {
+			_fdTable[fd].connection->disableKeepAlive();
+			if (_fdTable[fd].connection->isIdle()) {
+				closeConnection(static_cast<int>(fd));
+			}
+		}
+	}
+}
+
+// Dump request from a signal handler: only a flag and a write
+void EventLoop::requestStats() {
+	_statsRequested = 1;
+	wake();
+}
+
+const LoopStats& EventLoop::getStats() const {
+	return _stats;
+}
+
+// Take ownership of an accepted socket on the owning thread (registered
+// at the end of the current batch, with the hand-offs)
+bool EventLoop::adopt(int fd, const struct sockaddr_in& addr, const Server* server) {
+	__atomic_add_fetch(&_load, 1, __ATOMIC_RELAXED);
+	Handoff handoff;
+	handoff.fd = fd;
+	handoff.addr = addr;
+	handoff.server = server;
+	_adopted.push_back(handoff);
+	_handoffsPending = true;
+	return true;
+}
+
+// Hand an accepted socket over from the acceptor thread
+bool EventLoop::post(const Handoff& handoff) {
+	__atomic_add_fetch(&_load, 1, __ATOMIC_RELAXED);
+	if (!_handoffs.push(handoff)) {
+		__atomic_sub_fetch(&_load, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+	wake();
+	return true;
+}
+
+// Register the sockets accepted by this loop and every socket the acceptor
+// posted since the last wakeup
+void EventLoop::drainHandoffs() {
+	for (size_t i = 0; i < _adopted.size(); ++i) {
+		registerConnection(_adopted[i].fd, _adopted[i].addr, _adopted[i].server);
+	}
+	_adopted.clear();
+
+	Handoff handoff;
+	while (_handoffs.pop(handoff)) {
+		registerConnection(handoff.fd, handoff.addr, handoff.server);
+	}
+}
+
+size_t EventLoop::load() const {
+	return __atomic_load_n(&_load, __ATOMIC_RELAXED);
+}
+
+size_t EventLoop::getId() const {
+	return _id;
+}
+
+const char* EventLoop::getBackendName() const {
+	return _poller->getName();
+}
+
+// Create the Connection and start watching it (load already counted)
+bool EventLoop::registerConnection(int fd, const struct sockaddr_in& addr, const Server* server) {
+	Connection* conn = new Connection(fd, addr, server, &_timers);
+	if (!_poller->addStream(fd, interestFor(conn))) {
+		delete conn;
+		__atomic_sub_fetch(&_load, 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	FdSlot& slot = slotFor(fd);
+	slot.kind = FD_CLIENT;
+	slot.connection = conn;
+
+	// Handed off just before a graceful stop: one response, then close
+	if (_drainStarted) {
+		conn->disableKeepAlive();
+	}
+
+	Logger::debug << "New connection from " << conn->getClientHost() << ":" << conn->getClientPort()
+	              << " (fd: " << fd << ") on loop #" << _id << ", loop connections: " << load() << std::endl;
+	return true;
+}
+
+// Interest mask for a connection, derived from its state
+short EventLoop::interestFor(const Connection* conn) {
+	short events = 0;
+	if (conn->wantsRead()) {
+		events |= POLLIN;         // More (pipelined) requests welcome
+	}
+	if (conn->hasPendingOutput()) {
+		events |= POLLOUT;        // Queued responses
+	}
+	// Neither: the fd stays registered but idle until the state changes or a
+	// timeout closes it. Never POLLOUT with nothing queued: level-triggered,
+	// it would fire on every iteration.
+	return events;
+}
+
+// Update the backend interest after a state transition (no-op if unchanged)
+void EventLoop::updateInterest(Connection* conn) {
+	_poller->modify(conn->getFd(), interestFor(conn));
+}
+
+// Dispatch table slot for fd (grows the table if needed)
+EventLoop::FdSlot& EventLoop::slotFor(int fd) {
+	if (static_cast<size_t>(fd) >= _fdTable.size()) {
+		FdSlot empty;
+		empty.kind = FD_NONE;
+		empty.connection = NULL;
+		_fdTable.resize(fd + 1, empty);
+	}
+	return _fdTable[fd];
+}
+
+void EventLoop::clearSlot(int fd) {
+	if (fd >= 0 && static_cast<size_t>(fd) < _fdTable.size()) {
+		_fdTable[fd].kind = FD_NONE;
+		_fdTable[fd].connection = NULL;
+	}
+}
+
+// Route an event to its handler with a single table lookup
+void EventLoop::dispatchEvent(const Poller::Event& event) {
+	if (event.fd < 0 || static_cast<size_t>(event.fd) >= _fdTable.size()) {
+		return;
+	}
+
+	const FdSlot& slot = _fdTable[event.fd];
+	switch (slot.kind) {
+		case FD_LISTENER:
+			if (event.type == Poller::EVENT_ACCEPTED) {
+				_acceptor->handleAcceptedSocket(slot.listener, event.result);
+			} else {
+				_acceptor->handleListeningSocket(slot.listener);
+			}
+			phaseDone(LoopStats::PHASE_ACCEPT);
+			break;
+		case FD_CLIENT:
+			handleClientSocket(slot.connection, event);
+			break;
+		case FD_WAKEUP:
+			drainWakeup();
+			_handoffsPending = true;
+			break;
+		case FD_NONE:
+			// Stale event for an fd closed earlier in this iteration
+			if (event.type == Poller::EVENT_ACCEPTED) {
+				close(event.result);
+			}
+			break;
+	}
+}
+
+// Handle client socket events
+void EventLoop::handleClientSocket(Connection* conn, const Poller::Event& event) {
+	int fd = conn->getFd();
+	short revents = event.events;
+
+	// Check for errors
+	if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+		Logger::debug << "Connection error/hangup (fd: " << fd << ")" << std::endl;
+		closeConnection(fd);
+		return;
+	}
+
+	// Handle reading
+	if (revents & POLLIN) {
+		// Completion backends already read the bytes
+		bool ok = (event.type == Poller::EVENT_RECEIVED) ? conn->receive(event.data, event.result)
+		                                                 : conn->readRequest();
+		phaseDone(LoopStats::PHASE_READ);
+		if (!ok) {
+			Logger::debug << "Error reading request (fd: " << fd << ")" << std::endl;
+			closeConnection(fd);
+			return;
+		}
+	}
+
+	// Complete requests (just read, pipelined, or left over from the previous
+	// one): run the handler for each (blocks this loop meanwhile), then send
+	// every queued response in one write right away, without waiting for
+	// POLLOUT. A write that frees queue space may let more requests through.
+	// A read may also have queued a 100 Continue, which goes out at once.
+	bool flush = (revents & POLLOUT) != 0 || ((revents & POLLIN) && conn->hasPendingOutput());
+	for (;;) {
+		while (conn->getState() == Connection::PROCESSING) {
+			conn->processRequest();
+			unsigned long long took = phaseDone(LoopStats::PHASE_HANDLE);
+			if (took >= SLOW_HANDLE_US) {
+				Logger::warning << "Loop #" << _id << " blocked " << took / 1000 << " ms handling a request (fd: "
+				                << fd << "), " << load() - 1 << " other connection(s) waited" << std::endl;
+			}
+			flush = true;
+		}
+
+		if (!flush || !conn->hasPendingOutput()) {
+			break;
+		}
+		bool ok = conn->writeResponse();
+		phaseDone(LoopStats::PHASE_WRITE);
+		if (!ok) {
+			Logger::debug << "Error writing response (fd: " << fd << ")" << std::endl;
+			closeConnection(fd);
+			return;
+		}
+		flush = false;
+	}
+
+	// Check if connection should be closed
+	if (conn->shouldClose()) {
+		closeConnection(fd);
+		return;
+	}
+
+	// Re-arm interest only if the state changed
+	updateInterest(conn);
+}
+
+// Close connection
+void EventLoop::closeConnection(int fd) {
+	if (fd < 0 || static_cast<size_t>(fd) >= _fdTable.size() || _fdTable[fd].kind != FD_CLIENT) {
+		return;
+	}
+
+	Logger::debug << "Closing connection (fd: " << fd << ")" << std::endl;
+	_poller->remove(fd);
+	delete _fdTable[fd].connection;
+	clearSlot(fd);
+	__atomic_sub_fetch(&_load, 1, __ATOMIC_RELAXED);
+}
+
+// Close connections whose timers expired
+void EventLoop::expireTimers() {
+	TimerWheel::Timer* timer;
+	while ((timer = _timers.popExpired()) != NULL) {
+		Connection* conn = static_cast<Connection*>(timer->owner);
+
+		if (timer->kind == Connection::TIMER_HEADER) {
+			Logger::warning << "Client header timeout (fd: " << conn->getFd() << ")" << std::endl;
+		} else if (timer->kind == Connection::TIMER_KEEPALIVE) {
+			Logger::debug << "Keep-alive timeout (fd: " << conn->getFd() << ")" << std::endl;
+		} else {
+			Logger::warning << "Connection timed out (fd: " << conn->getFd() << ")" << std::endl;
+		}
+		closeConnection(conn->getFd());
+	}
+}
+
+// Cleanup all connections
+void EventLoop::cleanupAllConnections() {
+	for (size_t fd = 0; fd < _fdTable.size(); ++fd) {
+		if (_fdTable[fd].kind == FD_CLIENT) {
+			closeConnection(static_cast<int>(fd));
+		}
+	}
+}
+
+} // namespace HTTP
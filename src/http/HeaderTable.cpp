@@ -0,0 +1,327 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   HeaderTable.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:18:40 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 22:18:40 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * HeaderTable.cpp
+ * Implementation of the flat header table
+ */
+#include "includes/http/HeaderTable.hpp"
+#include <cctype>
+#include <cstring>
+
+namespace HTTP {
+
+namespace {
+	struct KnownHeader {
+		const char* name;
+		size_t length;
+	};
+
+	// Same order as HeaderTable::Id
+	const KnownHeader KNOWN_HEADERS[HeaderTable::HEADER_COUNT] = {
+		{ "", 0 },
+		{ "Accept-Encoding", 15 },
+		{ "Accept-Ranges", 13 },
+		{ "Allow", 5 },
+		{ "Cache-Control", 13 },
+		{ "Connection", 10 },
+		{ "Content-Encoding", 16 },
+		{ "Content-Length", 14 },
+		{ "Content-Range", 13 },
+		{ "Content-Type", 12 },
+		{ "Cookie", 6 },
+		{ "Date", 4 },
+		{ "ETag", 4 },
+		{ "Expect", 6 },
+		{ "Host", 4 },
+		{ "If-Modified-Since", 17 },
+		{ "If-None-Match", 13 },
+		{ "If-Range", 8 },
+		{ "Keep-Alive", 10 },
+		{ "Last-Modified", 13 },
+		{ "Location", 8 },
+		{ "Range", 5 },
+		{ "Retry-After", 11 },
+		{ "Server", 6 },
+		{ "Transfer-Encoding", 17 },
+		{ "User-Agent", 10 },
+		{ "Vary", 4 }
+	};
+
+	const size_t MAX_KNOWN_LENGTH = 17;
+	const size_t MAX_SAME_LENGTH = 6;
+
+	// Known headers grouped by name length, and a lowercase table:
+	// lookup() only compares names against the few of the same length
+	struct LookupTable {
+		unsigned char lower[256];
+		unsigned char byLength[MAX_KNOWN_LENGTH + 1][MAX_SAME_LENGTH];
+		unsigned char count[MAX_KNOWN_LENGTH + 1];
+
+		LookupTable() {
+			for (int c = 0; c < 256; ++c) {
+				lower[c] = static_cast<unsigned char>(std::tolower(c));
+			}
+			std::memset(count, 0, sizeof(count));
+			for (int id = HeaderTable::HEADER_OTHER + 1; id < HeaderTable::HEADER_COUNT; ++id) {
+				size_t length = KNOWN_HEADERS[id].length;
+				byLength[length][count[length]++] = static_cast<unsigned char>(id);
+			}
+		}
+	};
+
+	const LookupTable g_lookup;
+}
+
+HeaderTable::HeaderTable() : _count(0) {
+	std::memset(_index, 0, sizeof(_index));
+}
+
+void HeaderTable::add(Id id, const char* name, size_t nameLength, const char* value, size_t valueLength) {
+	if (_count >= 0xffff) {
+		return;
+	}
+	Entry added;
+	added.id = id;
+	added.nameOffset = _data.size();
+	added.nameLength = 0;
+	if (id == HEADER_OTHER) {
+		_data.append(name, nameLength);
+		added.nameLength = nameLength;
+	}
+	added.valueOffset = _data.size();
+	added.valueLength = valueLength;
+	_data.append(value, valueLength);
+
+	if (_count < INLINE_ENTRIES) {
+		_inline[_count] = added;
+	} else {
+		_overflow.push_back(added);
+	}
+	++_count;
+	if (id != HEADER_OTHER) {
+		_index[id] = static_cast<unsigned short>(_count);
+	}
+}
+
+void HeaderTable::set(Id id, const std::string& value) {
+	set(id, value.data(), value.size());
+}
+
+void HeaderTable::set(Id id, const char* value, size_t length) {
+	if (id != HEADER_OTHER && _index[id] != 0) {
+		setValue(entry(_index[id] - 1), value, length);
+	} else {
+		add(id, KNOWN_HEADERS[id].name, KNOWN_HEADERS[id].length, value, length);
+	}
+}
+
+void HeaderTable::set(const std::string& name, const std::string& value) {
+	Id known = lookup(name.data(), name.size());
+	if (known != HEADER_OTHER) {
+		set(known, value);
+		return;
+	}
+	size_t existing = find(HEADER_OTHER, name);
+	if (existing < _count) {
+		setValue(entry(existing), value.data(), value.size());
+	} else {
+		add(HEADER_OTHER, name.data(), name.size(), value.data(), value.size());
+	}
+}
+
+void HeaderTable::remove(Id id) {
+	if (id == HEADER_OTHER || _index[id] == 0) {
+		return;
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < _count; ++i) {
+		if (entry(i).id != id) {
+			entry(kept++) = entry(i);
+		}
+	}
+	_count = kept;
+	if (_count <= INLINE_ENTRIES) {
+		_overflow.clear();
+	} else {
+		_overflow.resize(_count - INLINE_ENTRIES);
+	}
+	rebuildIndex();
+}
+
+bool HeaderTable::has(Id id) const {
+	return id != HEADER_OTHER && _index[id] != 0;
+}
+
+bool HeaderTable::has(const std::string& name) const {
+	return find(lookup(name.data(), name.size()), name) < _count;
+}
+
+std::string HeaderTable::get(Id id) const {
+	if (!has(id)) {
+		return "";
+	}
+	const Entry& found = entry(_index[id] - 1);
+	return _data.substr(found.valueOffset, found.valueLength);
+}
+
+std::string HeaderTable::get(const std::string& name) const {
+	size_t found = find(lookup(name.data(), name.size()), name);
+	if (found == _count) {
+		return "";
+	}
+	return _data.substr(entry(found).valueOffset, entry(found).valueLength);
+}
+
+const char* HeaderTable::peek(Id id, size_t& length) const {
+	if (!has(id)) {
+		length = 0;
+		return NULL;
+	}
+	const Entry& found = entry(_index[id] - 1);
+	length = found.valueLength;
+	return _data.data() + found.valueOffset;
+}
+
+bool HeaderTable::valueIs(Id id, const char* value, size_t length) const {
+	size_t found;
+	const char* current = peek(id, found);
+	return current != NULL && found == length && std::memcmp(current, value, length) == 0;
+}
+
+bool HeaderTable::valueEquals(Id id, const char* word) const {
+	if (!has(id)) {
+		return false;
+	}
+	const Entry& found = entry(_index[id] - 1);
+	return found.valueLength == std::strlen(word)
+	    && equalsIgnoreCase(_data.data() + found.valueOffset, word, found.valueLength);
+}
+
+size_t HeaderTable::size() const {
+	return _count;
+}
+
+HeaderTable::Id HeaderTable::id(size_t index) const {
+	return entry(index).id;
+}
+
+std::string HeaderTable::name(size_t index) const {
+	const Entry& found = entry(index);
+	if (found.id != HEADER_OTHER) {
+		return std::string(KNOWN_HEADERS[found.id].name, KNOWN_HEADERS[found.id].length);
+	}
+	return _data.substr(found.nameOffset, found.nameLength);
+}
+
+std::string HeaderTable::value(size_t index) const {
+	const Entry& found = entry(index);
+	return _data.substr(found.valueOffset, found.valueLength);
+}
+
+void HeaderTable::appendTo(std::string& out) const {
+	for (size_t i = 0; i < _count; ++i) {
+		const Entry& current = entry(i);
+		if (current.id != HEADER_OTHER) {
+			out.append(KNOWN_HEADERS[current.id].name, KNOWN_HEADERS[current.id].length);
+		} else {
+			out.append(_data, current.nameOffset, current.nameLength);
+		}
+		out.append(": ", 2);
+		out.append(_data, current.valueOffset, current.valueLength);
+		out.append("\r\n", 2);
+	}
+}
+
+void HeaderTable::reserve(size_t bytes) {
+	_data.reserve(bytes);
+}
+
+void HeaderTable::clear() {
+	_data.clear();
+	_overflow.clear();
+	_count = 0;
+	std::memset(_index, 0, sizeof(_index));
+}
+
+// Bytes are only compared for known names of the same length
+HeaderTable::Id HeaderTable::lookup(const char* name, size_t length) {
+	if (length > MAX_KNOWN_LENGTH) {
+		return HEADER_OTHER;
+	}
+	for (unsigned char i = 0; i < g_lookup.count[length]; ++i) {
+		unsigned char id = g_lookup.byLength[length][i];
+		if (equalsIgnoreCase(name, KNOWN_HEADERS[id].name, length)) {
+			return static_cast<Id>(id);
+		}
+	}
+	return HEADER_OTHER;
+}
+
+const char* HeaderTable::canonicalName(Id id) {
+	return KNOWN_HEADERS[id].name;
+}
+
+HeaderTable::Entry& HeaderTable::entry(size_t index) {
+	return (index < INLINE_ENTRIES) ? _inline[index] : _overflow[index - INLINE_ENTRIES];
+}
+
+const HeaderTable::Entry& HeaderTable::entry(size_t index) const {
+	return (index < INLINE_ENTRIES) ? _inline[index] : _overflow[index - INLINE_ENTRIES];
+}
+
+// Position of the last entry of a header (size() if none): through the
+// index if well-known, by name otherwise
+size_t HeaderTable::find(Id id, const std::string& name) const {
+	if (id != HEADER_OTHER) {
+		return (_index[id] != 0) ? _index[id] - 1 : _count;
+	}
+	for (size_t i = _count; i > 0; --i) {
+		const Entry& current = entry(i - 1);
+		if (current.id == HEADER_OTHER && current.nameLength == name.size()
+		    && equalsIgnoreCase(_data.data() + current.nameOffset, name.data(), name.size())) {
+			return i - 1;
+		}
+	}
+	return _count;
+}
+
+// Overwrite in place when the new value fits, append otherwise
+void HeaderTable::setValue(Entry& target, const char* value, size_t length) {
+	if (length <= target.valueLength) {
+		_data.replace(target.valueOffset, length, value, length);
+	} else {
+		target.valueOffset = _data.size();
+		_data.append(value, length);
+	}
+	target.valueLength = length;
+}
+
+void HeaderTable::rebuildIndex() {
+	std::memset(_index, 0, sizeof(_index));
+	for (size_t i = 0; i < _count; ++i) {
+		if (entry(i).id != HEADER_OTHER) {
+			_index[entry(i).id] = static_cast<unsigned short>(i + 1);
+		}
+	}
+}
+
+bool HeaderTable::equalsIgnoreCase(const char* a, const char* b, size_t length) {
+	for (size_t i = 0; i < length; ++i) {
+		if (g_lookup.lower[static_cast<unsigned char>(a[i])] != g_lookup.lower[static_cast<unsigned char>(b[i])]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace HTTP
@@ -0,0 +1,59 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Method.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:52:06 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 22:52:06 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Method.cpp
+ * Method names and masks
+ */
+#include "includes/http/Method.hpp"
+#include <cstring>
+
+namespace HTTP {
+
+namespace {
+	// Same order as Method::Id
+	const char* const METHOD_NAMES[Method::METHOD_COUNT] = {
+		"", "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS"
+	};
+}
+
+Method::Id Method::lookup(const char* name, size_t length) {
+	for (int id = METHOD_UNKNOWN + 1; id < METHOD_COUNT; ++id) {
+		if (std::strlen(METHOD_NAMES[id]) == length && std::memcmp(METHOD_NAMES[id], name, length) == 0) {
+			return static_cast<Id>(id);
+		}
+	}
+	return METHOD_UNKNOWN;
+}
+
+Method::Id Method::lookup(const std::string& name) {
+	return lookup(name.data(), name.size());
+}
+
+const char* Method::name(Id id) {
+	return METHOD_NAMES[id];
+}
+
+std::string Method::list(unsigned int mask) {
+	std::string result;
+	for (int id = METHOD_UNKNOWN + 1; id < METHOD_COUNT; ++id) {
+		if (mask & bit(static_cast<Id>(id))) {
+			if (!result.empty()) {
+				result += ", ";
+			}
+			result += METHOD_NAMES[id];
+		}
+	}
+	return result;
+}
+
+} // namespace HTTP
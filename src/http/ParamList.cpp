@@ -0,0 +1,148 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ParamList.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:10:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 23:10:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ParamList.cpp
+ * Implementation of the decoded parameter list
+ */
+#include "includes/http/ParamList.hpp"
+#include <cstring>
+
+namespace HTTP {
+
+namespace {
+	const unsigned char NOT_HEX = 0xff;
+
+	// Value of each hex digit, NOT_HEX for every other byte
+	struct HexTable {
+		unsigned char value[256];
+
+		HexTable() {
+			std::memset(value, NOT_HEX, sizeof(value));
+			for (int c = 0; c < 10; ++c) {
+				value['0' + c] = static_cast<unsigned char>(c);
+			}
+			for (int c = 0; c < 6; ++c) {
+				value['a' + c] = static_cast<unsigned char>(10 + c);
+				value['A' + c] = static_cast<unsigned char>(10 + c);
+			}
+		}
+	};
+
+	const HexTable g_hex;
+}
+
+ParamList::ParamList() {}
+
+void ParamList::parse(const char* data, size_t length) {
+	clear();
+	_data.reserve(length);
+
+	size_t pos = 0;
+	while (pos < length) {
+		const char* pairStart = data + pos;
+		const char* amp = static_cast<const char*>(std::memchr(pairStart, '&', length - pos));
+		size_t pairLength = amp ? static_cast<size_t>(amp - pairStart) : length - pos;
+		pos += pairLength + 1;
+		if (pairLength == 0) {
+			continue;
+		}
+
+		const char* eq = static_cast<const char*>(std::memchr(pairStart, '=', pairLength));
+		size_t keyLength = eq ? static_cast<size_t>(eq - pairStart) : pairLength;
+
+		Entry added;
+		added.keyOffset = _data.size();
+		decode(pairStart, keyLength, _data);
+		added.keyLength = _data.size() - added.keyOffset;
+		added.valueOffset = _data.size();
+		if (eq) {
+			decode(eq + 1, pairLength - keyLength - 1, _data);
+		}
+		added.valueLength = _data.size() - added.valueOffset;
+		_entries.push_back(added);
+	}
+}
+
+void ParamList::parse(const std::string& data) {
+	parse(data.data(), data.size());
+}
+
+bool ParamList::has(const std::string& name) const {
+	return find(name) < _entries.size();
+}
+
+std::string ParamList::get(const std::string& name) const {
+	size_t found = find(name);
+	if (found == _entries.size()) {
+		return "";
+	}
+	return _data.substr(_entries[found].valueOffset, _entries[found].valueLength);
+}
+
+size_t ParamList::size() const {
+	return _entries.size();
+}
+
+std::string ParamList::key(size_t index) const {
+	return _data.substr(_entries[index].keyOffset, _entries[index].keyLength);
+}
+
+std::string ParamList::value(size_t index) const {
+	return _data.substr(_entries[index].valueOffset, _entries[index].valueLength);
+}
+
+void ParamList::clear() {
+	_data.clear();
+	_entries.clear();
+}
+
+// Runs without escapes are appended whole; each escape is two table reads
+void ParamList::decode(const char* data, size_t length, std::string& out) {
+	size_t runStart = 0;
+	for (size_t i = 0; i < length; ++i) {
+		char c = data[i];
+		if (c != '%' && c != '+') {
+			continue;
+		}
+		out.append(data + runStart, i - runStart);
+		runStart = i + 1;
+		if (c == '+') {
+			out += ' ';
+			continue;
+		}
+		unsigned char high = (i + 2 < length) ? g_hex.value[static_cast<unsigned char>(data[i + 1])] : NOT_HEX;
+		unsigned char low = (high != NOT_HEX) ? g_hex.value[static_cast<unsigned char>(data[i + 2])] : NOT_HEX;
+		if (low == NOT_HEX) {
+			out += '%';
+			continue;
+		}
+		out += static_cast<char>((high << 4) | low);
+		i += 2;
+		runStart = i + 1;
+	}
+	out.append(data + runStart, length - runStart);
+}
+
+// Last entry with this key, size() if none
+size_t ParamList::find(const std::string& name) const {
+	for (size_t i = _entries.size(); i > 0; --i) {
+		const Entry& current = _entries[i - 1];
+		if (current.keyLength == name.size()
+		    && std::memcmp(_data.data() + current.keyOffset, name.data(), name.size()) == 0) {
+			return i - 1;
+		}
+	}
+	return _entries.size();
+}
+
+} // namespace HTTP
@@ -0,0 +1,185 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RangeSet.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 06:25:09 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 06:25:09 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * RangeSet.cpp
+ * Implementation of the Range header parser
+ */
+#include "includes/http/RangeSet.hpp"
+#include <algorithm>
+#include <strings.h>
+
+namespace HTTP {
+
+namespace {
+	bool isSpace(char c) {
+		return c == ' ' || c == '\t';
+	}
+}
+
+RangeSet::RangeSet() {}
+
+RangeSet::Result RangeSet::parse(const char* header, size_t headerLength, size_t size) {
+	clear();
+
+	const char* pos = header;
+	const char* end = pos + headerLength;
+	if (headerLength < 6 || strncasecmp(pos, "bytes=", 6) != 0) {
+		return RANGES_IGNORED;      // Other units are not supported
+	}
+	pos += 6;
+
+	size_t specs = 0;
+	while (pos < end) {
+		while (pos < end && (isSpace(*pos) || *pos == ',')) {
+			++pos;
+		}
+		if (pos == end) {
+			break;
+		}
+		if (++specs > MAX_RANGES) {
+			clear();
+			return RANGES_IGNORED;
+		}
+
+		Range range;
+		bool satisfiable;
+		if (*pos == '-') {
+			// Suffix: the last n bytes
+			size_t suffix;
+			++pos;
+			if (!parseNumber(pos, end, suffix)) {
+				clear();
+				return RANGES_IGNORED;
+			}
+			satisfiable = suffix > 0 && size > 0;
+			range.first = (suffix < size) ? size - suffix : 0;
+			range.last = size - 1;
+		} else {
+			size_t first;
+			if (!parseNumber(pos, end, first) || pos == end || *pos != '-') {
+				clear();
+				return RANGES_IGNORED;
+			}
+			++pos;
+			size_t last = size - 1;
+			if (pos < end && *pos >= '0' && *pos <= '9') {
+				size_t asked;
+				if (!parseNumber(pos, end, asked) || asked < first) {
+					clear();
+					return RANGES_IGNORED;
+				}
+				if (asked < last) {
+					last = asked;
+				}
+			}
+			satisfiable = first < size;
+			range.first = first;
+			range.last = last;
+		}
+
+		while (pos < end && isSpace(*pos)) {
+			++pos;
+		}
+		if (pos < end && *pos != ',') {
+			clear();
+			return RANGES_IGNORED;
+		}
+		if (satisfiable) {
+			_ranges.push_back(range);
+		}
+	}
+
+	if (specs == 0) {
+		return RANGES_IGNORED;
+	}
+	if (_ranges.empty()) {
+		return RANGES_UNSATISFIABLE;
+	}
+	coalesce();
+	if (totalLength() > size) {
+		clear();
+		return RANGES_IGNORED;
+	}
+	return RANGES_SATISFIABLE;
+}
+
+size_t RangeSet::size() const {
+	return _ranges.size();
+}
+
+size_t RangeSet::first(size_t index) const {
+	return _ranges[index].first;
+}
+
+size_t RangeSet::last(size_t index) const {
+	return _ranges[index].last;
+}
+
+size_t RangeSet::length(size_t index) const {
+	return _ranges[index].last - _ranges[index].first + 1;
+}
+
+size_t RangeSet::totalLength() const {
+	size_t total = 0;
+	for (size_t i = 0; i < _ranges.size(); ++i) {
+		total += length(i);
+	}
+	return total;
+}
+
+void RangeSet::clear() {
+	_ranges.clear();
+}
+
+bool RangeSet::startsBefore(const Range& a, const Range& b) {
+	return a.first < b.first;
+}
+
+// Sort by offset and merge ranges that overlap or touch
+void RangeSet::coalesce() {
+	if (_ranges.size() < 2) {
+		return;
+	}
+	std::sort(_ranges.begin(), _ranges.end(), startsBefore);
+	size_t kept = 0;
+	for (size_t i = 1; i < _ranges.size(); ++i) {
+		Range& current = _ranges[kept];
+		if (_ranges[i].first <= current.last || _ranges[i].first - current.last == 1) {
+			if (_ranges[i].last > current.last) {
+				current.last = _ranges[i].last;
+			}
+		} else {
+			_ranges[++kept] = _ranges[i];
+		}
+	}
+	_ranges.resize(kept + 1);
+}
+
+// Decimal digits at pos; values too large for size_t saturate (they lie
+// past the end of any file anyway)
+bool RangeSet::parseNumber(const char*& pos, const char* end, size_t& value) {
+	const char* start = pos;
+	value = 0;
+	while (pos < end && *pos >= '0' && *pos <= '9') {
+		size_t digit = static_cast<size_t>(*pos - '0');
+		if (value > (static_cast<size_t>(-1) - digit) / 10) {
+			value = static_cast<size_t>(-1);
+		} else {
+			value = value * 10 + digit;
+		}
+		++pos;
+	}
+	return pos != start;
+}
+
+} // namespace HTTP
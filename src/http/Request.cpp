@@ -24,146 +24,84 @@ namespace HTTP {
 // Constructor
 Request::Request()
 	: _method("")
+	, _methodId(Method::METHOD_UNKNOWN)
 	, _uri("")
 	, _path("")
 	, _query("")
 	, _version("")
-	, _body("")
 	, _complete(false)
 	, _contentLength(0)
 	, _hasContentLength(false)
-	, _isChunked(false) {
+	, _isChunked(false)
+	, _queryParsed(false)
+	, _formParsed(false) {
 }
 
 Request::~Request() {}
 
-// Parse HTTP request
+// Parse a complete request held in one string
 bool Request::parse(const std::string& rawRequest) {
-	if (rawRequest.empty()) {
+	RequestParser parser;
+	RequestParser::Result result = parser.feed(rawRequest);
+	if (result != RequestParser::DONE) {
+		Logger::error << "Failed to parse request (" << (result == RequestParser::FAILED ? "malformed" : "incomplete")
+		              << ")" << std::endl;
 		return false;
 	}
+	load(parser, rawRequest);
+	return true;
+}
 
-	// Split into lines
-	std::vector<std::string> lines;
-	std::istringstream stream(rawRequest);
-	std::string line;
-
-	while (std::getline(stream, line)) {
-		// Remove \r if present
-		if (!line.empty() && line[line.length() - 1] == '\r') {
-			line = line.substr(0, line.length() - 1);
-		}
-		lines.push_back(line);
-	}
-
-	if (lines.empty()) {
-		return false;
-	}
-
-	// Parse request line (first line)
-	if (!parseRequestLine(lines[0])) {
-		Logger::error << "Failed to parse request line: " << lines[0] << std::endl;
-		return false;
-	}
-
-	// Check URI length limit
-	if (_uri.length() > MAX_URI_LENGTH) {
-		Logger::error << "URI too long: " << _uri.length() << " bytes (max: " << MAX_URI_LENGTH << ")" << std::endl;
-		return false;
-	}
-
-	// Parse headers
-	size_t i = 1;
-	size_t headerCount = 0;
-	for (; i < lines.size(); ++i) {
-		if (lines[i].empty()) {
-			// Empty line marks end of headers
-			++i;
-			break;
-		}
-
-		// Check header count limit
-		if (headerCount >= MAX_HEADERS_COUNT) {
-			Logger::error << "Too many headers: " << headerCount << " (max: " << MAX_HEADERS_COUNT << ")" << std::endl;
-			return false;
-		}
-
-		// Check header size limit
-		if (lines[i].length() > MAX_HEADER_SIZE) {
-			Logger::error << "Header too long: " << lines[i].length() << " bytes (max: " << MAX_HEADER_SIZE << ")" << std::endl;
-			return false;
-		}
-
-		if (!parseHeader(lines[i])) {
-			Logger::warning << "Failed to parse header: " << lines[i] << std::endl;
-		}
-		++headerCount;
-	}
-
-	// Check for Transfer-Encoding: chunked
-	if (hasHeader("transfer-encoding")) {
-		std::string te = getHeader("transfer-encoding");
-		if (toLowerCase(te).find("chunked") != std::string::npos) {
-			_isChunked = true;
-		}
-	}
-
-	// Check for Content-Length header
-	if (hasHeader("content-length")) {
-		std::string clStr = getHeader("content-length");
-		_contentLength = static_cast<size_t>(atoi(clStr.c_str()));
-		_hasContentLength = true;
-	}
+// Copy what the parser found in the buffer (the only allocations of a request)
+void Request::load(RequestParser& parser, const std::string& buffer) {
+	loadHead(parser, buffer);
 
-	// Rest is body
-	for (; i < lines.size(); ++i) {
-		_body += lines[i];
-		if (i < lines.size() - 1) {
-			_body += "\n";
-		}
+	const char* data = buffer.data() + parser.start();
+	const std::vector<RequestParser::HeaderSpan>& trailers = parser.trailers();
+	for (size_t i = 0; i < trailers.size(); ++i) {
+		const RequestParser::HeaderSpan& trailer = trailers[i];
+		_trailers.add(trailer.id, data + trailer.name.offset, trailer.name.length,
+		              data + trailer.value.offset, trailer.value.length);
 	}
 
-	// If chunked, decode the body
+	// Body as decoded by the parser (chunks joined, binary-safe), moved out
+	// of its sink
+	_body.swap(parser.body());
 	if (_isChunked) {
-		_body = decodeChunkedBody(_body);
-		_complete = true; // Chunked body is complete when we have all chunks
-	} else if (_hasContentLength) {
-		_complete = (_body.length() >= _contentLength);
-	} else {
-		_complete = true; // No body expected
+		_contentLength = _body.size();
 	}
-
-	return true;
+	_complete = true;
 }
 
-// Parse request line (e.g., "GET /path HTTP/1.1")
-bool Request::parseRequestLine(const std::string& line) {
-	std::istringstream iss(line);
-
-	if (!(iss >> _method >> _uri >> _version)) {
-		return false;
-	}
+// Request line and headers only: enough to judge a request before its body
+// is sent (Expect: 100-continue)
+void Request::loadHead(const RequestParser& parser, const std::string& buffer) {
+	clear();
 
-	// Parse URI into path and query
+	_method = parser.str(buffer, parser.method());
+	_methodId = parser.methodId();
+	_uri = parser.str(buffer, parser.target());
+	_version = parser.str(buffer, parser.version());
 	parseUri(_uri);
 
-	return true;
-}
-
-// Parse header line (e.g., "Host: localhost")
-bool Request::parseHeader(const std::string& line) {
-	size_t colonPos = line.find(':');
-	if (colonPos == std::string::npos) {
-		return false;
+	// Header bytes are copied once into the table (one allocation);
+	// well-known names keep the Id the parser gave them
+	const std::vector<RequestParser::HeaderSpan>& headers = parser.headers();
+	const char* data = buffer.data() + parser.start();
+	size_t headerBytes = 0;
+	for (size_t i = 0; i < headers.size(); ++i) {
+		headerBytes += headers[i].name.length + headers[i].value.length;
+	}
+	_headers.reserve(headerBytes);
+	for (size_t i = 0; i < headers.size(); ++i) {
+		const RequestParser::HeaderSpan& header = headers[i];
+		_headers.add(header.id, data + header.name.offset, header.name.length,
+		             data + header.value.offset, header.value.length);
 	}
 
-	std::string name = trim(line.substr(0, colonPos));
-	std::string value = trim(line.substr(colonPos + 1));
-
-	// Store header with lowercase name for case-insensitive lookup
-	_headers[toLowerCase(name)] = value;
-
-	return true;
+	_isChunked = parser.isChunked();
+	_hasContentLength = parser.hasContentLength();
+	_contentLength = _isChunked ? 0 : parser.contentLength();
 }
 
 // Parse URI into path and query
@@ -182,95 +120,14 @@ void Request::parseUri(const std::string& uri) {
 	_path = urlDecode(_path);
 }
 
-// Decode chunked transfer encoding
-std::string Request::decodeChunkedBody(const std::string& chunkedData) {
-	std::string result;
-	std::istringstream stream(chunkedData);
-	std::string line;
-
-	while (std::getline(stream, line)) {
-		// Remove \r if present
-		if (!line.empty() && line[line.length() - 1] == '\r') {
-			line = line.substr(0, line.length() - 1);
-		}
-
-		// Parse chunk size (hex number)
-		if (line.empty()) {
-			continue;
-		}
-
-		// Convert hex string to size
-		size_t chunkSize = 0;
-		std::istringstream hexStream(line);
-		hexStream >> std::hex >> chunkSize;
-
-		if (chunkSize == 0) {
-			// Last chunk, we're done
-			break;
-		}
-
-		// Read chunk data
-		std::vector<char> buffer(chunkSize);
-		stream.read(&buffer[0], chunkSize);
-		result.append(&buffer[0], stream.gcount());
-
-		// Skip trailing \r\n after chunk data
-		std::getline(stream, line);
-	}
-
-	return result;
-}
-
 // URL decode (convert %XX to characters)
 std::string Request::urlDecode(const std::string& str) const {
 	std::string result;
 	result.reserve(str.length());
-
-	for (size_t i = 0; i < str.length(); ++i) {
-		if (str[i] == '%' && i + 2 < str.length()) {
-			// Convert %XX to character
-			std::string hex = str.substr(i + 1, 2);
-			char ch = static_cast<char>(strtol(hex.c_str(), NULL, 16));
-			result += ch;
-			i += 2;
-		} else if (str[i] == '+') {
-			// Convert + to space (for form data)
-			result += ' ';
-		} else {
-			result += str[i];
-		}
-	}
-
+	ParamList::decode(str.data(), str.size(), result);
 	return result;
 }
 
-// Convert string to lowercase
-std::string Request::toLowerCase(const std::string& str) const {
-	std::string result = str;
-	for (size_t i = 0; i < result.length(); ++i) {
-		result[i] = std::tolower(result[i]);
-	}
-	return result;
-}
-
-// Trim whitespace from string
-std::string Request::trim(const std::string& str) const {
-	size_t start = 0;
-	size_t end = str.length();
-
-	// Trim from start
-	while (start < end && std::isspace(str[start])) {
-		++start;
-	}
-
-	// Trim from end
-	while (end > start && std::isspace(str[end - 1])) {
-		--end;
-	}
-
-	return str.substr(start, end - start);
-}
-
 // Check if request is complete
 bool Request::isComplete() const {
 	return _complete;
@@ -278,19 +135,21 @@ bool Request::isComplete() const {
 
 // Getters
 const std::string& Request::getMethod() const { return _method; }
+Method::Id Request::getMethodId() const { return _methodId; }
 const std::string& Request::getUri() const { return _uri; }
 const std::string& Request::getPath() const { return _path; }
 const std::string& Request::getQuery() const { return _query; }
 const std::string& Request::getVersion() const { return _version; }
-const std::map<std::string, std::string>& Request::getHeaders() const { return _headers; }
-const std::string& Request::getBody() const { return _body; }
+const HeaderTable& Request::getHeaders() const { return _headers; }
+const HeaderTable& Request::getTrailers() const { return _trailers; }
+const BodySink& Request::getBody() const { return _body; }
 
 std::string Request::getHeader(const std::string& name) const {
-	std::map<std::string, std::string>::const_iterator it = _headers.find(toLowerCase(name));
-	if (it != _headers.end()) {
-		return it->second;
-	}
-	return "";
+	return _headers.get(name);
+}
+
+std::string Request::getHeader(HeaderTable::Id id) const {
+	return _headers.get(id);
 }
 
 size_t Request::getContentLength() const {
@@ -298,11 +157,15 @@ size_t Request::getContentLength() const {
 }
 
 std::string Request::getContentType() const {
-	return getHeader("content-type");
+	return _headers.get(HeaderTable::HEADER_CONTENT_TYPE);
 }
 
 bool Request::hasHeader(const std::string& name) const {
-	return _headers.find(toLowerCase(name)) != _headers.end();
+	return _headers.has(name);
+}
+
+bool Request::hasHeader(HeaderTable::Id id) const {
+	return _headers.has(id);
 }
 
 bool Request::isChunked() const {
@@ -310,87 +173,44 @@ bool Request::isChunked() const {
 }
 
 bool Request::keepAlive() const {
-	std::string connection = getHeader("connection");
-
 	// HTTP/1.1 defaults to keep-alive
 	if (_version == "HTTP/1.1") {
-		return (toLowerCase(connection) != "close");
+		return !_headers.valueEquals(HeaderTable::HEADER_CONNECTION, "close");
 	}
 
 	// HTTP/1.0 defaults to close
-	return (toLowerCase(connection) == "keep-alive");
+	return _headers.valueEquals(HeaderTable::HEADER_CONNECTION, "keep-alive");
 }
 
-// Parse query string into key-value pairs
-std::map<std::string, std::string> Request::getQueryParams() const {
-	std::map<std::string, std::string> params;
-
-	if (_query.empty()) {
-		return params;
+// Query string pairs, decoded on the first call
+const ParamList& Request::getQueryParams() const {
+	if (!_queryParsed) {
+		_queryParams.parse(_query);
+		_queryParsed = true;
 	}
-
-	// Split by &
-	std::istringstream stream(_query);
-	std::string pair;
-
-	while (std::getline(stream, pair, '&')) {
-		size_t eqPos = pair.find('=');
-		if (eqPos != std::string::npos) {
-			std::string key = urlDecode(pair.substr(0, eqPos));
-			std::string value = urlDecode(pair.substr(eqPos + 1));
-			params[key] = value;
-		} else {
-			// Parameter without value
-			params[urlDecode(pair)] = "";
-		}
-	}
-
-	return params;
+	return _queryParams;
 }
 
 std::string Request::getQueryParam(const std::string& name) const {
-	std::map<std::string, std::string> params = getQueryParams();
-	std::map<std::string, std::string>::const_iterator it = params.find(name);
-	if (it != params.end()) {
-		return it->second;
-	}
-	return "";
+	return getQueryParams().get(name);
 }
 
-// Parse form data (application/x-www-form-urlencoded)
-std::map<std::string, std::string> Request::getFormData() const {
-	std::map<std::string, std::string> formData;
-
-	std::string contentType = getContentType();
-	if (contentType.find("application/x-www-form-urlencoded") == std::string::npos) {
-		return formData;
-	}
-
-	// Parse body as query string
-	std::istringstream stream(_body);
-	std::string pair;
-
-	while (std::getline(stream, pair, '&')) {
-		size_t eqPos = pair.find('=');
-		if (eqPos != std::string::npos) {
-			std::string key = urlDecode(pair.substr(0, eqPos));
-			std::string value = urlDecode(pair.substr(eqPos + 1));
-			formData[key] = value;
-		} else {
-			formData[urlDecode(pair)] = "";
+// Form data (application/x-www-form-urlencoded), decoded on the first call
+const ParamList& Request::getFormData() const {
+	if (!_formParsed) {
+		if (getContentType().find("application/x-www-form-urlencoded") != std::string::npos) {
+			const char* bytes = _body.bytes();
+			if (bytes != NULL) {
+				_formData.parse(bytes, _body.size());
+			}
 		}
+		_formParsed = true;
 	}
-
-	return formData;
+	return _formData;
 }
 
 std::string Request::getFormField(const std::string& name) const {
-	std::map<std::string, std::string> formData = getFormData();
-	std::map<std::string, std::string>::const_iterator it = formData.find(name);
-	if (it != formData.end()) {
-		return it->second;
-	}
-	return "";
+	return getFormData().get(name);
 }
 
 // Check if request is multipart
@@ -434,14 +254,15 @@ void Request::print() const {
 	std::cout << "Version: " << _version << std::endl;
 	std::cout << "Headers:" << std::endl;
 
-	for (std::map<std::string, std::string>::const_iterator it = _headers.begin();
-	     it != _headers.end(); ++it) {
-		std::cout << "  " << it->first << ": " << it->second << std::endl;
+	for (size_t i = 0; i < _headers.size(); ++i) {
+		std::cout << "  " << _headers.name(i) << ": " << _headers.value(i) << std::endl;
 	}
 
-	if (!_body.empty()) {
-		std::cout << "Body (" << _body.length() << " bytes):" << std::endl;
-		std::cout << _body << std::endl;
+	if (_body.isSpooled()) {
+		std::cout << "Body (" << _body.size() << " bytes, in a temp file)" << std::endl;
+	} else if (_body.size() > 0) {
+		std::cout << "Body (" << _body.size() << " bytes):" << std::endl;
+		std::cout << _body.str() << std::endl;
 	}
 	std::cout << "===================" << std::endl;
 }
@@ -449,16 +270,22 @@ void Request::print() const {
 // Clear request
 void Request::clear() {
 	_method.clear();
+	_methodId = Method::METHOD_UNKNOWN;
 	_uri.clear();
 	_path.clear();
 	_query.clear();
 	_version.clear();
 	_headers.clear();
+	_trailers.clear();
 	_body.clear();
 	_complete = false;
 	_contentLength = 0;
 	_hasContentLength = false;
 	_isChunked = false;
+	_queryParams.clear();
+	_formData.clear();
+	_queryParsed = false;
+	_formParsed = false;
 }
 
 } // namespace HTTP
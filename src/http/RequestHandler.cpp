@@ -15,18 +15,24 @@
  * Implementation of HTTP Request Handler
  */
 #include "includes/http/RequestHandler.hpp"
+#include "includes/http/RangeSet.hpp"
+#include "includes/http/Compressor.hpp"
+#include "includes/http/Compression.hpp"
 #include "includes/cgi/CGIExecutor.hpp"
 #include "includes/core/Settings.hpp"
 #include "includes/core/Instance.hpp"
+#include "includes/utils/ByteScan.hpp"
 #include "includes/utils/Logger.hpp"
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <fstream>
 #include <sstream>
 #include <ctime>
 #include <vector>
+#include <cstring>
 
 namespace HTTP {
 
@@ -39,45 +45,205 @@ RequestHandler::~RequestHandler() {}
 
 // Handle request
 Response RequestHandler::handle(const Request& request) {
+	Response response = dispatch(request);
+	compress(request, response);
+
+	// HEAD: everything GET would send except the body
+	if (request.getMethodId() == Method::METHOD_HEAD) {
+		response.omitBody();
+	}
+	return response;
+}
+
+Response RequestHandler::dispatch(const Request& request) {
 	Logger::info << "Handling " << request.getMethod() << " " << request.getPath() << std::endl;
 
-	// First, check if method is recognized (GET, POST, DELETE)
-	std::string method = request.getMethod();
-	if (method != "GET" && method != "POST" && method != "DELETE") {
-		Logger::warning << "Unknown method: " << method << std::endl;
-		return notImplemented(method);
+	Method::Id method = request.getMethodId();
+
+	// OPTIONS *: the server as a whole
+	if (method == Method::METHOD_OPTIONS && request.getPath() == "*") {
+		return handleOptions(Method::ALL);
+	}
+
+	Response early;
+	const Route* route = admit(request, early);
+	if (!route) {
+		return early;
+	}
+
+	// Handle based on method
+	switch (method) {
+		case Method::METHOD_GET:
+		case Method::METHOD_HEAD:
+			return handleGet(request, route);
+		case Method::METHOD_POST:
+			return handlePost(request, route);
+		case Method::METHOD_PUT:
+			return handlePut(request, route);
+		case Method::METHOD_DELETE:
+			return handleDelete(request, route);
+		case Method::METHOD_OPTIONS:
+			return handleOptions(route->getAllowedMethods());
+		default:
+			return notImplemented(request.getMethod());
+	}
+}
+
+// Compression stage, between the handlers and the response writer: the
+// body in the coding the client prefers when the server compresses its
+// type and it is long enough to gain. Static files are compressed once per
+// version into the shared cache, or on the fly while sent when too big to
+// keep; generated bodies (CGI, listings) in one go. HEAD only takes a file
+// already in the cache, and is answered in identity otherwise.
+void RequestHandler::compress(const Request& request, Response& response) {
+	if (!_server->isGzipEnabled() || !Compressor::isAvailable()) {
+		return;
+	}
+	const HeaderTable& headers = response.getHeaders();
+	int status = response.getStatusCode();
+	size_t length = 0;
+	if (status < 200 || status >= 300 || status == 204
+	    || (headers.peek(HeaderTable::HEADER_CONTENT_ENCODING, length) && length > 0)) {
+		return;
+	}
+	// Media type without its parameters, compared in place
+	const char* type = headers.peek(HeaderTable::HEADER_CONTENT_TYPE, length);
+	if (!type) {
+		return;
+	}
+	const char* semicolon = static_cast<const char*>(std::memchr(type, ';', length));
+	if (semicolon) {
+		length = static_cast<size_t>(semicolon - type);
+	}
+	while (length > 0 && type[length - 1] == ' ') {
+		--length;
+	}
+	if (!_server->isGzipType(type, length)) {
+		return;
+	}
+
+	// Whichever coding this response gets, it depended on Accept-Encoding
+	response.setHeader(HeaderTable::HEADER_VARY, "Accept-Encoding");
+	if (status != 200 || response.getBodyLength() < _server->getGzipMinLength()) {
+		return;     // 206 ranges are of the identity body
+	}
+	const char* accepted = request.getHeaders().peek(HeaderTable::HEADER_ACCEPT_ENCODING, length);
+	Compressor::Encoding encoding = Compressor::negotiate(accepted, length);
+	if (encoding == Compressor::ENCODING_IDENTITY) {
+		return;
+	}
+
+	Compression* shared = Instance::Get<Compression>();
+	const char* etag = headers.peek(HeaderTable::HEADER_ETAG, length);
+	std::string key = Compressor::name(encoding);
+	if (etag) {
+		key.append(etag, length);
+	}
+	bool cacheable = response.hasFileBody() && length > 0;
+	std::string compressed;
+	bool streamed = false;
+	bool cached = cacheable && shared->lookup(key, compressed);
+
+	if (!cached) {
+		int level = shared->level(_server->getGzipLevel());
+		if (level == 0) {
+			return;     // CPUs saturated: identity rather than added latency
+		}
+		if (response.hasFileBody() && response.getBodyLength() > shared->maxEntrySize()) {
+			// Too big to keep: compressed chunk by chunk as it is sent
+			if (request.getVersion() == "HTTP/1.0") {
+				return;
+			}
+			response.streamCompressed(encoding, level);
+			streamed = true;
+		} else if (response.hasFileBody() && request.getMethodId() == Method::METHOD_HEAD) {
+			return;     // HEAD: not worth compressing a whole file for its length
+		} else if (response.hasFileBody()) {
+			std::string file;
+			if (!response.readBodyFile(file)
+			    || !Compressor::compress(encoding, level, file.data(), file.size(), compressed)) {
+				return;
+			}
+			if (cacheable) {
+				shared->store(key, compressed);
+			}
+		} else {
+			const std::string& body = response.getBody();
+			if (!Compressor::compress(encoding, level, body.data(), body.size(), compressed)) {
+				return;
+			}
+		}
+	}
+
+	if (!streamed) {
+		Logger::debug << "Compressed body: " << response.getBodyLength() << " -> "
+		              << compressed.size() << " bytes (" << Compressor::name(encoding)
+		              << (cached ? ", cached" : "") << ")" << std::endl;
+		response.swapBody(compressed);
+		response.setHeader(HeaderTable::HEADER_CONTENT_ENCODING, Compressor::name(encoding));
+	}
+	// Not byte-for-byte the identity body any more (the table may have moved)
+	etag = headers.peek(HeaderTable::HEADER_ETAG, length);
+	if (length > 0 && !(length >= 2 && etag[0] == 'W' && etag[1] == '/')) {
+		response.setHeader(HeaderTable::HEADER_ETAG, "W/" + std::string(etag, length));
+	}
+	response.removeHeader(HeaderTable::HEADER_ACCEPT_RANGES);
+}
+
+// Checks shared by dispatch() and checkHead(), in this order: method
+// implemented, route, method allowed there, redirect
+const Route* RequestHandler::admit(const Request& request, Response& early) {
+	// First, check if method is implemented (resolved by the parser)
+	Method::Id method = request.getMethodId();
+	if (method == Method::METHOD_UNKNOWN) {
+		Logger::warning << "Unknown method: " << request.getMethod() << std::endl;
+		early = notImplemented(request.getMethod());
+		return NULL;
 	}
 
 	// Find matching route
 	const Route* route = _server->matchRoute(request.getPath());
 	if (!route) {
 		Logger::warning << "No route found for path: " << request.getPath() << std::endl;
-		return notFound(request.getPath());
+		early = notFound(request.getPath());
+		return NULL;
 	}
 
 	// Check if method is allowed
-	if (!route->isMethodAllowed(request.getMethod())) {
+	if (!route->isMethodAllowed(method)) {
 		Logger::warning << "Method " << request.getMethod() << " not allowed for path: "
 		                << request.getPath() << std::endl;
-		return methodNotAllowed(request.getMethod());
+		early = methodNotAllowed(request.getMethod(), route->getAllowedMethods());
+		return NULL;
 	}
 
 	// Check for redirect
 	if (!route->getRedirect().empty()) {
 		Logger::info << "Redirecting to: " << route->getRedirect() << std::endl;
-		return Response::redirect(route->getRedirect(), 301);
+		early = Response::redirect(route->getRedirect(), 301);
+		return NULL;
 	}
+	return route;
+}
 
-	// Handle based on method
-	if (request.getMethod() == "GET") {
-		return handleGet(request, route);
-	} else if (request.getMethod() == "POST") {
-		return handlePost(request, route);
-	} else if (request.getMethod() == "DELETE") {
-		return handleDelete(request, route);
-	} else {
-		return notImplemented(request.getMethod());
+// Everything that can refuse a request before its body matters; the body
+// size limit was already checked by the parser against Content-Length
+bool RequestHandler::checkHead(const Request& request, Response& rejection) {
+	if (request.getMethodId() == Method::METHOD_OPTIONS && request.getPath() == "*") {
+		return true;
+	}
+	const Route* route = admit(request, rejection);
+	if (!route) {
+		return false;
 	}
+
+	// Uploads need upload_enable, unless a CGI script takes the body
+	if (request.getMethodId() == Method::METHOD_POST && request.isMultipart() && !route->isUploadEnabled()
+	    && !isCgiScript(resolveFilePath(request.getPath(), route), route)) {
+		rejection = Response::errorResponse(403, "File upload is not allowed for this resource");
+		return false;
+	}
+	return true;
 }
 
 // Handle GET request
@@ -87,26 +253,11 @@ Response RequestHandler::handleGet(const Request& request, const Route* route) {
 	Logger::debug << "Resolved file path: " << filePath << std::endl;
 
 	// Check if CGI is enabled and file extension matches
-	if (route->isCgiEnabled()) {
-		std::string ext = getFileExtension(filePath);
-		std::string cgiExt = route->getCgiExtension();
-
-		// Normalize extensions (add dot if missing)
-		if (!ext.empty() && ext[0] != '.') {
-			ext = "." + ext;
-		}
-		if (!cgiExt.empty() && cgiExt[0] != '.') {
-			cgiExt = "." + cgiExt;
-		}
-
-		if (ext == cgiExt) {
-			// This is a CGI script
-			if (fileExists(filePath)) {
-				return handleCGI(request, route, filePath);
-			} else {
-				return notFound(request.getPath());
-			}
+	if (isCgiScript(filePath, route)) {
+		if (fileExists(filePath)) {
+			return handleCGI(request, route, filePath);
 		}
+		return notFound(request.getPath());
 	}
 
 	// Check if file exists
@@ -146,9 +297,14 @@ Response RequestHandler::handleGet(const Request& request, const Route* route) {
 		}
 	}
 
-	// Read file
-	std::string content = readFile(filePath);
-	if (content.empty() && !fileExists(filePath)) {
+	// Open the file: its body is sent from the fd as the socket drains,
+	// never read into memory here (held that long, so not inherited by CGIs)
+	int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+	struct stat fileStat;
+	if (fd < 0 || fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+		if (fd >= 0) {
+			close(fd);
+		}
 		return internalServerError("Failed to read file");
 	}
 
@@ -162,77 +318,148 @@ Response RequestHandler::handleGet(const Request& request, const Route* route) {
 	response.setContentType(settings->httpMimeType(extension));
 
 	// Add cache headers
-	struct stat fileStat;
-	if (stat(filePath.c_str(), &fileStat) == 0) {
-		// Set Last-Modified header
-		response.setLastModified(fileStat.st_mtime);
-
-		// Generate and set ETag (based on inode, mtime, and size)
-		response.setETag(generateETag(filePath));
-
-		// Check If-None-Match (ETag validation)
-		if (request.hasHeader("if-none-match")) {
-			std::string clientETag = request.getHeader("if-none-match");
-			std::string serverETag = "\"" + generateETag(filePath) + "\"";
-			if (clientETag == serverETag) {
-				// File hasn't changed, return 304 Not Modified
-				Response notModified;
-				notModified.setStatus(304);
-				notModified.setKeepAlive(false);
-				return notModified;
-			}
+	// Set Last-Modified header
+	response.setLastModified(fileStat.st_mtime);
+
+	// Generate and set ETag (based on inode, mtime, and size)
+	std::string etag = generateETag(fileStat);
+	response.setETag(etag);
+
+	// Check If-None-Match (ETag validation)
+	size_t length;
+	const char* clientETag = request.getHeaders().peek(HeaderTable::HEADER_IF_NONE_MATCH, length);
+	if (clientETag) {
+		// A compressed variant carries the weak form of the same tag
+		if (length >= 2 && clientETag[0] == 'W' && clientETag[1] == '/') {
+			clientETag += 2;
+			length -= 2;
 		}
-
-		// Check If-Modified-Since
-		if (request.hasHeader("if-modified-since")) {
-			// For simplicity, we'll skip date parsing
-			// In production, you'd parse the date and compare with fileStat.st_mtime
+		if (length == etag.size() + 2 && clientETag[0] == '"' && clientETag[length - 1] == '"'
+		    && etag.compare(0, std::string::npos, clientETag + 1, length - 2) == 0) {
+			// File hasn't changed, return 304 Not Modified
+			close(fd);
+			Response notModified;
+			notModified.setStatus(304);
+			return notModified;
 		}
+	}
+
+	// Check If-Modified-Since
+	if (request.hasHeader(HeaderTable::HEADER_IF_MODIFIED_SINCE)) {
+		// For simplicity, we'll skip date parsing
+		// In production, you'd parse the date and compare with fileStat.st_mtime
+	}
+
+	// Set Cache-Control header
+	response.setCacheControl("public, max-age=3600");
+
+	// Byte ranges (GET only), unless If-Range says the client's copy is stale
+	size_t size = static_cast<size_t>(fileStat.st_size);
+	response.setHeader(HeaderTable::HEADER_ACCEPT_RANGES, "bytes");
+	RangeSet ranges;
+	RangeSet::Result wanted = RangeSet::RANGES_IGNORED;
+	if (request.getMethodId() == Method::METHOD_GET && request.hasHeader(HeaderTable::HEADER_RANGE)
+	    && ifRangeHolds(request, response)) {
+		const char* range = request.getHeaders().peek(HeaderTable::HEADER_RANGE, length);
+		wanted = ranges.parse(range, length, size);
+	}
 
-		// Set Cache-Control header
-		response.setCacheControl("public, max-age=3600");
+	if (wanted == RangeSet::RANGES_UNSATISFIABLE) {
+		close(fd);
+		return rangeNotSatisfiable(size);
+	}
+	if (wanted == RangeSet::RANGES_SATISFIABLE && setRangeBody(response, fd, ranges, size, route->isSendfileEnabled())) {
+		Logger::success << "Served " << ranges.size() << " range(s) of file: " << filePath << std::endl;
+		return response;
 	}
 
-	response.setBody(content);
-	response.setKeepAlive(false); // For now, always close connection
+	response.setBodyFile(fd, 0, size, route->isSendfileEnabled());
 
-	Logger::success << "Served file: " << filePath << " (" << content.length() << " bytes)" << std::endl;
+	Logger::success << "Served file: " << filePath << " (" << fileStat.st_size << " bytes)" << std::endl;
 
 	return response;
 }
 
+// If-Range: a strong ETag or the exact Last-Modified date of the file
+bool RequestHandler::ifRangeHolds(const Request& request, const Response& response) {
+	size_t length;
+	const char* validator = request.getHeaders().peek(HeaderTable::HEADER_IF_RANGE, length);
+	if (!validator) {
+		return true;
+	}
+	if (length > 0 && (validator[0] == '"' || (length >= 2 && validator[0] == 'W' && validator[1] == '/'))) {
+		// Entity tag: a weak one never matches
+		return response.getHeaders().valueIs(HeaderTable::HEADER_ETAG, validator, length);
+	}
+	return response.getHeaders().valueIs(HeaderTable::HEADER_LAST_MODIFIED, validator, length);
+}
+
+// 206: one range as the body, several as multipart/byteranges; either way
+// every range is sent from the file fd. False (response untouched) when the
+// multipart body would be bigger than the file: the whole file is sent instead
+bool RequestHandler::setRangeBody(Response& response, int fd, const RangeSet& ranges, size_t size, bool zeroCopy) {
+	if (ranges.size() == 1) {
+		response.setStatus(206);
+		response.setHeader(HeaderTable::HEADER_CONTENT_RANGE, contentRange(ranges.first(0), ranges.last(0), size));
+		response.setBodyFile(fd, static_cast<off_t>(ranges.first(0)), ranges.length(0), zeroCopy);
+		return true;
+	}
+
+	// The quoted ETag of the file, without its quotes
+	size_t length;
+	const char* etag = response.getHeaders().peek(HeaderTable::HEADER_ETAG, length);
+	std::string boundary = "webserv-";
+	boundary.append(etag + 1, length - 2);
+	const char* type = response.getHeaders().peek(HeaderTable::HEADER_CONTENT_TYPE, length);
+	std::string partType = "\r\nContent-Type: ";
+	partType.append(type ? type : "", length);
+
+	std::vector<Response::FilePart> parts(ranges.size() + 1);
+	for (size_t i = 0; i < ranges.size(); ++i) {
+		parts[i].text = "\r\n--" + boundary + partType
+		              + "\r\nContent-Range: " + contentRange(ranges.first(i), ranges.last(i), size) + "\r\n\r\n";
+		parts[i].offset = static_cast<off_t>(ranges.first(i));
+		parts[i].length = ranges.length(i);
+	}
+	parts.back().text = "\r\n--" + boundary + "--\r\n";
+	parts.back().offset = 0;
+	parts.back().length = 0;
+
+	size_t total = 0;
+	for (size_t i = 0; i < parts.size(); ++i) {
+		total += parts[i].text.size() + parts[i].length;
+	}
+	if (total > size) {
+		return false;
+	}
+
+	response.setStatus(206);
+	response.setContentType("multipart/byteranges; boundary=" + boundary);
+	response.setBodyFile(fd, parts, zeroCopy);
+	return true;
+}
+
+std::string RequestHandler::contentRange(size_t first, size_t last, size_t size) {
+	std::ostringstream range;
+	range << "bytes " << first << "-" << last << "/" << size;
+	return range.str();
+}
+
 // Handle POST request
 Response RequestHandler::handlePost(const Request& request, const Route* route) {
 	Logger::info << "POST request - Content-Type: " << request.getContentType() << std::endl;
 
 	// Check if this is a CGI request (before other handlers)
-	if (route->isCgiEnabled()) {
-		// Check if file extension matches CGI extension
-		std::string path = resolveFilePath(request.getPath(), route);
-		std::string ext = getFileExtension(path);
-		std::string cgiExt = route->getCgiExtension();
-
-		// Normalize extensions (add dot if missing)
-		if (!ext.empty() && ext[0] != '.') {
-			ext = "." + ext;
-		}
-		if (!cgiExt.empty() && cgiExt[0] != '.') {
-			cgiExt = "." + cgiExt;
-		}
-
-		if (ext == cgiExt) {
-			// This is a CGI script
-			if (fileExists(path)) {
-				return handleCGI(request, route, path);
-			} else {
-				return notFound(request.getPath());
-			}
+	std::string resolvedPath = resolveFilePath(request.getPath(), route);
+	if (isCgiScript(resolvedPath, route)) {
+		if (fileExists(resolvedPath)) {
+			return handleCGI(request, route, resolvedPath);
 		}
+		return notFound(request.getPath());
 	}
 
 	// Check if this is a POST to a static file (should return 405)
 	// Do this check BEFORE handling form data or other generic handlers
-	std::string resolvedPath = resolveFilePath(request.getPath(), route);
 	if (fileExists(resolvedPath) && !isDirectory(resolvedPath)) {
 		// This is an existing file - check if it's a static file
 		std::string ext = getFileExtension(resolvedPath);
@@ -241,7 +468,8 @@ Response RequestHandler::handlePost(const Request& request, const Route* route)
 		    ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "gif" ||
 		    ext == "txt" || ext == "pdf" || ext == "ico") {
 			// This is a static file with no POST handler (not CGI, not upload)
-			return methodNotAllowed(request.getMethod());
+			return methodNotAllowed(request.getMethod(),
+			                        route->getAllowedMethods() & ~Method::bit(Method::METHOD_POST));
 		}
 	}
 
@@ -271,7 +499,7 @@ Response RequestHandler::handlePost(const Request& request, const Route* route)
 	     << "<body>\n"
 	     << "<h1>POST Request Received</h1>\n"
 	     << "<p>Content-Type: " << request.getContentType() << "</p>\n"
-	     << "<p>Body size: " << request.getBody().length() << " bytes</p>\n";
+	     << "<p>Body size: " << request.getBody().size() << " bytes</p>\n";
 
 	if (request.isChunked()) {
 		body << "<p>Transfer-Encoding: chunked</p>\n";
@@ -281,14 +509,13 @@ Response RequestHandler::handlePost(const Request& request, const Route* route)
 	     << "</html>\n";
 
 	response.setBody(body.str());
-	response.setKeepAlive(false);
 
 	return response;
 }
 
 // Handle form data (application/x-www-form-urlencoded)
 Response RequestHandler::handleFormData(const Request& request, const Route* /* route */) {
-	std::map<std::string, std::string> formData = request.getFormData();
+	const ParamList& formData = request.getFormData();
 
 	Logger::info << "Form data received with " << formData.size() << " fields" << std::endl;
 
@@ -305,10 +532,9 @@ Response RequestHandler::handleFormData(const Request& request, const Route* /*
 	     << "<table border='1'>\n"
 	     << "<tr><th>Field</th><th>Value</th></tr>\n";
 
-	for (std::map<std::string, std::string>::const_iterator it = formData.begin();
-	     it != formData.end(); ++it) {
-		body << "<tr><td>" << it->first << "</td><td>" << it->second << "</td></tr>\n";
-		Logger::debug << "  " << it->first << " = " << it->second << std::endl;
+	for (size_t i = 0; i < formData.size(); ++i) {
+		body << "<tr><td>" << formData.key(i) << "</td><td>" << formData.value(i) << "</td></tr>\n";
+		Logger::debug << "  " << formData.key(i) << " = " << formData.value(i) << std::endl;
 	}
 
 	body << "</table>\n"
@@ -316,7 +542,6 @@ Response RequestHandler::handleFormData(const Request& request, const Route* /*
 	     << "</html>\n";
 
 	response.setBody(body.str());
-	response.setKeepAlive(false);
 
 	return response;
 }
@@ -330,8 +555,12 @@ Response RequestHandler::handleFileUpload(const Request& request, const Route* r
 
 	Logger::info << "File upload - boundary: " << boundary << std::endl;
 
-	// Parse multipart data
-	std::vector<UploadedFile> files = parseMultipartData(request.getBody(), boundary);
+	// Parse multipart data (a spooled body is read through a mapping)
+	const char* bodyBytes = request.getBody().bytes();
+	if (bodyBytes == NULL) {
+		return Response::errorResponse(500, "Failed to read the request body");
+	}
+	std::vector<UploadedFile> files = parseMultipartData(bodyBytes, request.getBody().size(), boundary);
 
 	if (files.empty()) {
 		return Response::errorResponse(400, "No files found in upload");
@@ -346,7 +575,7 @@ Response RequestHandler::handleFileUpload(const Request& request, const Route* r
 	// Save files
 	std::vector<std::string> savedPaths;
 	for (size_t i = 0; i < files.size(); ++i) {
-		std::string savedPath = saveUploadedFile(files[i].content, files[i].filename, uploadDir);
+		std::string savedPath = saveUploadedFile(files[i].content, files[i].contentLength, files[i].filename, uploadDir);
 		if (!savedPath.empty()) {
 			savedPaths.push_back(savedPath);
 			Logger::success << "Saved uploaded file: " << savedPath << std::endl;
@@ -376,7 +605,6 @@ Response RequestHandler::handleFileUpload(const Request& request, const Route* r
 	     << "</html>\n";
 
 	response.setBody(body.str());
-	response.setKeepAlive(false);
 
 	return response;
 }
@@ -409,7 +637,6 @@ Response RequestHandler::handleDelete(const Request& request, const Route* route
 		// Return 204 No Content (preferred for DELETE)
 		Response response;
 		response.setStatus(204);
-		response.setKeepAlive(false);
 		return response;
 	} else {
 		Logger::error << "Failed to delete file: " << filePath << std::endl;
@@ -417,6 +644,95 @@ Response RequestHandler::handleDelete(const Request& request, const Route* route
 	}
 }
 
+// Handle PUT request: store the body at the target path
+Response RequestHandler::handlePut(const Request& request, const Route* route) {
+	const std::string& path = request.getPath();
+	std::string filePath = resolveFilePath(path, route);
+
+	Logger::debug << "Storing PUT body at: " << filePath << std::endl;
+
+	// Writes stay under the route's root
+	if (path.find("/../") != std::string::npos
+	    || (path.length() >= 3 && path.compare(path.length() - 3, 3, "/..") == 0)) {
+		return forbidden("Path traversal is not allowed");
+	}
+
+	// Check if it's a directory
+	if (isDirectory(filePath) || filePath[filePath.length() - 1] == '/') {
+		return forbidden("Cannot PUT to a directory");
+	}
+
+	bool existed = fileExists(filePath);
+	if (existed && !hasWritePermission(filePath)) {
+		return Response::errorResponse(403, "Permission denied: cannot replace file");
+	}
+
+	// A spooled body is written from a mapping of its temp file
+	const BodySink& body = request.getBody();
+	const char* bytes = body.bytes();
+	if (bytes == NULL) {
+		return Response::errorResponse(500, "Failed to read the request body");
+	}
+
+	std::ofstream file(filePath.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		// Missing parent directory
+		std::string parent = filePath.substr(0, filePath.rfind('/') + 1);
+		if (!parent.empty() && !isDirectory(parent)) {
+			return Response::errorResponse(409, "Parent directory does not exist");
+		}
+		Logger::error << "Failed to open for writing: " << filePath << std::endl;
+		return Response::errorResponse(403, "Permission denied: cannot create file");
+	}
+
+	file.write(bytes, body.size());
+	file.close();
+	if (file.fail()) {
+		Logger::error << "Failed to write file: " << filePath << std::endl;
+		return Response::errorResponse(500, "Failed to write file");
+	}
+
+	Logger::success << (existed ? "Replaced" : "Created") << " file: " << filePath
+	                << " (" << body.size() << " bytes)" << std::endl;
+
+	// 201 Created with its location, or 204 No Content for a replacement
+	Response response;
+	if (existed) {
+		response.setStatus(204);
+	} else {
+		response.setStatus(201);
+		response.setHeader(HeaderTable::HEADER_LOCATION, path);
+		response.setContentLength(0);
+	}
+	return response;
+}
+
+// Handle OPTIONS request: the methods the resource accepts
+Response RequestHandler::handleOptions(unsigned int allowed) {
+	Response response;
+	response.setStatus(204);
+	response.setHeader(HeaderTable::HEADER_ALLOW, Method::list(allowed));
+	return response;
+}
+
+// Does the route run this file as a CGI script (by extension)?
+bool RequestHandler::isCgiScript(const std::string& filePath, const Route* route) {
+	if (!route->isCgiEnabled()) {
+		return false;
+	}
+	std::string ext = getFileExtension(filePath);
+	std::string cgiExt = route->getCgiExtension();
+
+	// Normalize extensions (add dot if missing)
+	if (!ext.empty() && ext[0] != '.') {
+		ext = "." + ext;
+	}
+	if (!cgiExt.empty() && cgiExt[0] != '.') {
+		cgiExt = "." + cgiExt;
+	}
+	return ext == cgiExt;
+}
+
 // Resolve file path
 std::string RequestHandler::resolveFilePath(const std::string& requestPath, const Route* route) {
 	std::string root = route->getRoot();
@@ -549,12 +865,7 @@ bool RequestHandler::hasReadPermission(const std::string& path) {
 }
 
 // Generate ETag based on file metadata
-std::string RequestHandler::generateETag(const std::string& filePath) {
-	struct stat fileStat;
-	if (stat(filePath.c_str(), &fileStat) != 0) {
-		return "";
-	}
-
+std::string RequestHandler::generateETag(const struct stat& fileStat) {
 	// Simple ETag: inode-mtime-size
 	std::ostringstream etag;
 	etag << std::hex << fileStat.st_ino << "-" << fileStat.st_mtime << "-" << fileStat.st_size;
@@ -562,7 +873,7 @@ std::string RequestHandler::generateETag(const std::string& filePath) {
 }
 
 // Save uploaded file
-std::string RequestHandler::saveUploadedFile(const std::string& content, const std::string& filename, const std::string& uploadDir) {
+std::string RequestHandler::saveUploadedFile(const char* content, size_t length, const std::string& filename, const std::string& uploadDir) {
 	// Create upload directory if it doesn't exist
 	mkdir(uploadDir.c_str(), 0755);
 
@@ -584,41 +895,41 @@ std::string RequestHandler::saveUploadedFile(const std::string& content, const s
 		return "";
 	}
 
-	file.write(content.c_str(), content.length());
+	file.write(content, length);
 	file.close();
+	if (file.fail()) {
+		Logger::error << "Failed to write file: " << fullPath << std::endl;
+		return "";
+	}
 
 	return fullPath;
 }
 
 // Parse multipart/form-data
-std::vector<RequestHandler::UploadedFile> RequestHandler::parseMultipartData(const std::string& body, const std::string& boundary) {
+std::vector<RequestHandler::UploadedFile> RequestHandler::parseMultipartData(const char* data, size_t size, const std::string& boundary) {
 	std::vector<UploadedFile> files;
 
 	std::string delimiter = "--" + boundary;
-	std::string endDelimiter = "--" + boundary + "--";
 
 	size_t pos = 0;
-	while ((pos = body.find(delimiter, pos)) != std::string::npos) {
+	while ((pos = ByteScan::find(data, pos, size, delimiter.data(), delimiter.length())) != std::string::npos) {
 		// Skip the delimiter
 		pos += delimiter.length();
 
 		// Skip \r\n after delimiter
-		if (pos < body.length() && body[pos] == '\r') pos++;
-		if (pos < body.length() && body[pos] == '\n') pos++;
+		if (pos < size && data[pos] == '\r') pos++;
+		if (pos < size && data[pos] == '\n') pos++;
 
-		// Find next delimiter
-		size_t nextPos = body.find(delimiter, pos);
+		// Find next delimiter (the part is [pos, nextPos))
+		size_t nextPos = ByteScan::find(data, pos, size, delimiter.data(), delimiter.length());
 		if (nextPos == std::string::npos) {
 			break;
 		}
 
-		// Extract part
-		std::string part = body.substr(pos, nextPos - pos);
-
 		// Split headers and content
-		size_t headerEnd = part.find("\r\n\r\n");
+		size_t headerEnd = ByteScan::find(data, pos, nextPos, "\r\n\r\n", 4);
 		if (headerEnd == std::string::npos) {
-			headerEnd = part.find("\n\n");
+			headerEnd = ByteScan::find(data, pos, nextPos, "\n\n", 2);
 			if (headerEnd == std::string::npos) {
 				continue;
 			}
@@ -627,27 +938,23 @@ std::vector<RequestHandler::UploadedFile> RequestHandler::parseMultipartData(con
 			headerEnd += 4;
 		}
 
-		std::string headers = part.substr(0, headerEnd);
-		std::string content = part.substr(headerEnd);
-
 		// Remove trailing \r\n from content
-		if (content.length() >= 2 && content[content.length() - 2] == '\r') {
-			content = content.substr(0, content.length() - 2);
-		} else if (content.length() >= 1 && content[content.length() - 1] == '\n') {
-			content = content.substr(0, content.length() - 1);
+		size_t contentEnd = nextPos;
+		if (contentEnd - headerEnd >= 2 && data[contentEnd - 2] == '\r') {
+			contentEnd -= 2;
+		} else if (contentEnd - headerEnd >= 1 && data[contentEnd - 1] == '\n') {
+			contentEnd -= 1;
 		}
 
 		// Parse headers to extract filename and content-type
 		std::string filename;
 		std::string contentType = "application/octet-stream";
 
-		std::istringstream headerStream(headers);
-		std::string headerLine;
-		while (std::getline(headerStream, headerLine)) {
-			// Remove \r
-			if (!headerLine.empty() && headerLine[headerLine.length() - 1] == '\r') {
-				headerLine = headerLine.substr(0, headerLine.length() - 1);
-			}
+		size_t lineStart = pos;
+		while (lineStart < headerEnd) {
+			size_t lineEnd = ByteScan::findLineEnd(data, lineStart, headerEnd);
+			std::string headerLine(data + lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1;
 
 			// Look for Content-Disposition
 			if (headerLine.find("Content-Disposition") != std::string::npos) {
@@ -677,10 +984,11 @@ std::vector<RequestHandler::UploadedFile> RequestHandler::parseMultipartData(con
 			UploadedFile file;
 			file.filename = filename;
 			file.contentType = contentType;
-			file.content = content;
+			file.content = data + headerEnd;
+			file.contentLength = contentEnd - headerEnd;
 			files.push_back(file);
 
-			Logger::debug << "Parsed file: " << filename << " (" << content.length() << " bytes)" << std::endl;
+			Logger::debug << "Parsed file: " << filename << " (" << file.contentLength << " bytes)" << std::endl;
 		}
 
 		pos = nextPos;
@@ -716,7 +1024,6 @@ Response RequestHandler::notFound(const std::string& path) {
 					response.setStatus(404);
 					response.setContentType("text/html");
 					response.setBody(content);
-					response.setKeepAlive(false);
 					Logger::info << "Serving custom 404 page: " << errorFilePath << std::endl;
 					return response;
 				}
@@ -727,6 +1034,14 @@ Response RequestHandler::notFound(const std::string& path) {
 	return Response::errorResponse(404, "The requested URL " + path + " was not found on this server.");
 }
 
+Response RequestHandler::rangeNotSatisfiable(size_t size) {
+	Response response = Response::errorResponse(416, "The requested range is not satisfiable.");
+	std::ostringstream range;
+	range << "bytes */" << size;
+	response.setHeader(HeaderTable::HEADER_CONTENT_RANGE, range.str());
+	return response;
+}
+
 Response RequestHandler::forbidden(const std::string& message) {
 	// Check if custom error page is configured
 	std::string errorPage = _server->getErrorPage(403);
@@ -741,7 +1056,6 @@ Response RequestHandler::forbidden(const std::string& message) {
 					response.setStatus(403);
 					response.setContentType("text/html");
 					response.setBody(content);
-					response.setKeepAlive(false);
 					Logger::info << "Serving custom 403 page: " << errorFilePath << std::endl;
 					return response;
 				}
@@ -752,7 +1066,7 @@ Response RequestHandler::forbidden(const std::string& message) {
 	return Response::errorResponse(403, message);
 }
 
-Response RequestHandler::methodNotAllowed(const std::string& method) {
+Response RequestHandler::methodNotAllowed(const std::string& method, unsigned int allowed) {
 	// Check if custom error page is configured
 	std::string errorPage = _server->getErrorPage(405);
 	if (!errorPage.empty()) {
@@ -765,8 +1079,8 @@ Response RequestHandler::methodNotAllowed(const std::string& method) {
 					Response response;
 					response.setStatus(405);
 					response.setContentType("text/html");
+					response.setHeader(HeaderTable::HEADER_ALLOW, Method::list(allowed));
 					response.setBody(content);
-					response.setKeepAlive(false);
 					Logger::info << "Serving custom 405 page: " << errorFilePath << std::endl;
 					return response;
 				}
@@ -774,7 +1088,9 @@ Response RequestHandler::methodNotAllowed(const std::string& method) {
 		}
 	}
 	// Fallback to generic error page
-	return Response::errorResponse(405, "Method " + method + " is not allowed for this resource.");
+	Response response = Response::errorResponse(405, "Method " + method + " is not allowed for this resource.");
+	response.setHeader(HeaderTable::HEADER_ALLOW, Method::list(allowed));
+	return response;
 }
 
 Response RequestHandler::notImplemented(const std::string& method) {
@@ -791,7 +1107,6 @@ Response RequestHandler::notImplemented(const std::string& method) {
 					response.setStatus(501);
 					response.setContentType("text/html");
 					response.setBody(content);
-					response.setKeepAlive(false);
 					Logger::info << "Serving custom 501 page: " << errorFilePath << std::endl;
 					return response;
 				}
@@ -816,7 +1131,6 @@ Response RequestHandler::internalServerError(const std::string& message) {
 					response.setStatus(500);
 					response.setContentType("text/html");
 					response.setBody(content);
-					response.setKeepAlive(false);
 					Logger::info << "Serving custom 500 page: " << errorFilePath << std::endl;
 					return response;
 				}
@@ -0,0 +1,542 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RequestParser.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:41:08 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 20:41:08 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * RequestParser.cpp
+ * Implementation of the incremental request parser
+ */
+#include "includes/http/RequestParser.hpp"
+#include "includes/utils/ByteScan.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cctype>
+#include <cstring>
+
+namespace HTTP {
+
+namespace {
+	// Byte classes (ByteScan tables)
+	enum CharClass {
+		C_TOKEN,         // tchar (RFC 7230 3.2.6): methods and header names
+		C_TARGET,        // Visible bytes allowed in the request target
+		C_VALUE          // Visible bytes of a header value (obs-text included)
+	};
+
+	inline bool isClass(unsigned char c, CharClass cls) {
+		return (cls == C_TOKEN) ? ByteScan::isToken(c) : ByteScan::isVisible(c);
+	}
+
+	inline bool isWhitespace(char c) {
+		return c == ' ' || c == '\t';
+	}
+}
+
+RequestParser::RequestParser() : _maxBodySize(0) {
+	reset(0);
+}
+
+void RequestParser::setMaxBodySize(size_t size) {
+	_maxBodySize = size;
+}
+
+void RequestParser::setBodyBufferSize(size_t size) {
+	_body.setBufferSize(size);
+}
+
+void RequestParser::reset(size_t start) {
+	_state = S_START;
+	_start = start;
+	_pos = 0;
+	_mark = 0;
+	_lineStart = 0;
+	_valueEnd = 0;
+	_sawCr = false;
+	_inTrailer = false;
+	_headEnd = 0;
+	_errorStatus = 0;
+	_method = makeSpan(0, 0);
+	_methodId = Method::METHOD_UNKNOWN;
+	_target = makeSpan(0, 0);
+	_version = makeSpan(0, 0);
+	_headers.clear();           // Keeps the capacity for the next request
+	_trailers.clear();
+	_body.clear();
+	_bodyLength = 0;
+	_remaining = 0;
+	_hasContentLength = false;
+	_contentLength = 0;
+	_chunked = false;
+	_expectContinue = false;
+	_chunkDigits = false;
+}
+
+// Spans are relative to _start, so only the start moves
+void RequestParser::rebase() {
+	_start = 0;
+}
+
+// Only while the body is being received: the trailer fields that follow
+// it are spans like the headers
+void RequestParser::dropBody(std::string& buffer) {
+	if (_state < S_BODY || _state > S_CHUNK_DATA_END || _pos <= _headEnd) {
+		return;
+	}
+	size_t dropped = _pos - _headEnd;
+	buffer.erase(_start + _headEnd, dropped);
+	_lineStart = (_lineStart > _headEnd + dropped) ? _lineStart - dropped : _headEnd;
+	_pos = _headEnd;
+}
+
+RequestParser::Result RequestParser::feed(const std::string& buffer) {
+	if (_state == S_DONE) {
+		return DONE;
+	}
+	if (_state == S_ERROR) {
+		return FAILED;
+	}
+
+	const char* data = buffer.data() + _start;
+	size_t size = buffer.size() - _start;
+
+	while (_pos < size) {
+		// Body bytes are taken in one step, never looked at one by one
+		if (_state == S_BODY || _state == S_CHUNK_DATA) {
+			if (!takeBytes(data, size - _pos)) {
+				return FAILED;
+			}
+			if (_state == S_DONE) {
+				return DONE;
+			}
+			continue;
+		}
+
+		unsigned char c = static_cast<unsigned char>(data[_pos]);
+
+		// Lines end with CRLF (a bare LF is accepted); a CR is only valid
+		// right before the LF, so the states only ever see the LF
+		size_t lineEnd = _pos;
+		if (_sawCr) {
+			if (c != '\n') {
+				return fail(400);
+			}
+			_sawCr = false;
+			lineEnd = _pos - 1;
+		} else if (c == '\r') {
+			_sawCr = true;
+			++_pos;
+			continue;
+		}
+
+		switch (_state) {
+			case S_START:
+				// Blank lines before the request are skipped, but stay in the
+				// buffer: bounded like a header line
+				if (_pos - _lineStart >= MAX_HEADER_SIZE) {
+					return fail(400);
+				}
+				if (c != '\n') {
+					if (!isClass(c, C_TOKEN)) {
+						return fail(400);
+					}
+					_mark = _pos;
+					_state = S_METHOD;
+				}
+				break;
+
+			case S_METHOD:
+				if (c == ' ') {
+					_method = makeSpan(_mark, _pos);
+					_methodId = Method::lookup(data + _mark, _pos - _mark);
+					_state = S_BEFORE_TARGET;
+				} else if (!isClass(c, C_TOKEN) || _pos - _mark >= MAX_METHOD_LENGTH) {
+					return fail(400);
+				}
+				break;
+
+			case S_BEFORE_TARGET:
+				if (_pos - _lineStart >= MAX_HEADER_SIZE) {
+					return fail(400);
+				}
+				if (c != ' ') {
+					if (c <= ' ' || c == 0x7f) {
+						return fail(400);
+					}
+					_mark = _pos;
+					_state = S_TARGET;
+				}
+				break;
+
+			case S_TARGET:
+				if (isClass(c, C_TARGET)) {
+					_pos = ByteScan::skipVisible(data, _pos, size);
+					if (_pos - _mark > MAX_URI_LENGTH) {
+						return fail(414);
+					}
+					continue;
+				}
+				if (c != ' ') {
+					return fail(400);     // Includes the line end: no HTTP/0.9
+				}
+				_target = makeSpan(_mark, _pos);
+				_state = S_BEFORE_VERSION;
+				break;
+
+			case S_BEFORE_VERSION:
+				if (_pos - _lineStart >= MAX_HEADER_SIZE) {
+					return fail(400);
+				}
+				if (c != ' ') {
+					if (c == '\n') {
+						return fail(400);
+					}
+					_mark = _pos;
+					_state = S_VERSION;
+				}
+				break;
+
+			case S_VERSION:
+				if (c == '\n') {
+					_version = makeSpan(_mark, lineEnd);
+					// HTTP/d.d
+					if (_version.length != 8 || std::memcmp(data + _mark, "HTTP/", 5) != 0
+					    || !std::isdigit(static_cast<unsigned char>(data[_mark + 5]))
+					    || data[_mark + 6] != '.'
+					    || !std::isdigit(static_cast<unsigned char>(data[_mark + 7]))) {
+						return fail(400);
+					}
+					_lineStart = _pos + 1;
+					_state = S_HEADER_START;
+				} else if (_pos - _mark >= 8) {
+					return fail(400);
+				}
+				break;
+
+			case S_HEADER_START:
+				if (c == '\n') {
+					if (_inTrailer) {
+						_state = S_DONE;
+					} else if (!endHeaders()) {
+						return FAILED;
+					}
+				} else if (!isClass(c, C_TOKEN)) {
+					return fail(400);     // Also obsolete line folding
+				} else if (fields().size() >= MAX_HEADERS_COUNT) {
+					return fail(431);
+				} else {
+					_mark = _pos;
+					_state = S_HEADER_NAME;
+				}
+				break;
+
+			case S_HEADER_NAME:
+				if (isClass(c, C_TOKEN)) {
+					_pos = ByteScan::skipToken(data, _pos, size);
+					if (_pos - _lineStart > MAX_HEADER_SIZE) {
+						return fail(431);
+					}
+					continue;
+				}
+				if (c != ':') {
+					return fail(400);
+				}
+				{
+					HeaderSpan header;
+					header.name = makeSpan(_mark, _pos);
+					header.id = HeaderTable::lookup(data + _mark, _pos - _mark);
+					header.value = makeSpan(_pos + 1, _pos + 1);
+					fields().push_back(header);
+				}
+				_state = S_BEFORE_VALUE;
+				break;
+
+			case S_BEFORE_VALUE:
+			case S_HEADER_VALUE:
+				if (isClass(c, C_VALUE) || (_state == S_HEADER_VALUE && isWhitespace(c))) {
+					if (_state == S_BEFORE_VALUE) {
+						_mark = _pos;
+						_state = S_HEADER_VALUE;
+					}
+					// Inner whitespace is taken in the same run; the value
+					// ends after the last visible byte seen so far
+					size_t from = _pos;
+					_pos = ByteScan::skipText(data, _pos, size);
+					size_t end = _pos;
+					while (end > from && isWhitespace(data[end - 1])) {
+						--end;
+					}
+					if (end > from) {
+						_valueEnd = end;
+					}
+					if (_pos - _lineStart > MAX_HEADER_SIZE) {
+						return fail(431);
+					}
+					continue;
+				}
+				if (c == '\n') {
+					if (_state == S_HEADER_VALUE) {
+						fields().back().value = makeSpan(_mark, _valueEnd);
+					}
+					if (!endHeader(data)) {
+						return FAILED;
+					}
+					_lineStart = _pos + 1;
+					_state = S_HEADER_START;
+				} else if ((c < ' ' && c != '\t') || c == 0x7f) {
+					return fail(400);
+				} else if (_pos - _lineStart >= MAX_HEADER_SIZE) {
+					return fail(431);
+				}
+				break;                    // Whitespace before the value
+
+			case S_CHUNK_SIZE:
+				if (std::isxdigit(c)) {
+					int digit = std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10;
+					if (_remaining > (static_cast<size_t>(-1) >> 4)) {
+						return fail(400);
+					}
+					_remaining = (_remaining << 4) | static_cast<size_t>(digit);
+					_chunkDigits = true;
+					break;
+				}
+				if (!_chunkDigits) {
+					return fail(400);
+				}
+				if (c == ';' || c == ' ' || c == '\t') {
+					_state = S_CHUNK_EXTENSION;
+				} else if (c == '\n') {
+					if (!endChunkSize()) {
+						return FAILED;
+					}
+				} else {
+					return fail(400);
+				}
+				break;
+
+			case S_CHUNK_EXTENSION:
+				// Extensions are skipped
+				if (c == '\n') {
+					if (!endChunkSize()) {
+						return FAILED;
+					}
+				} else if (_pos - _lineStart >= MAX_HEADER_SIZE) {
+					return fail(400);
+				}
+				break;
+
+			case S_CHUNK_DATA_END:
+				if (c != '\n') {
+					return fail(400);
+				}
+				_lineStart = _pos + 1;
+				_state = S_CHUNK_SIZE;
+				break;
+
+			default:
+				break;
+		}
+
+		++_pos;
+		if (_state == S_DONE) {
+			return DONE;
+		}
+	}
+
+	return NEED_MORE;
+}
+
+// Chunk size line complete: data follows, or the trailer fields after the
+// last one (read by the header states). The limit is checked before any of
+// the chunk's data is taken.
+bool RequestParser::endChunkSize() {
+	_chunkDigits = false;
+	_lineStart = _pos + 1;
+	if (_remaining == 0) {
+		_inTrailer = true;
+		_state = S_HEADER_START;
+	} else if (_maxBodySize > 0 && _remaining > _maxBodySize - _bodyLength) {
+		fail(413);
+		return false;
+	} else {
+		_state = S_CHUNK_DATA;
+	}
+	return true;
+}
+
+// Content-Length body or chunk data: as many bytes as are there, straight
+// into the sink
+bool RequestParser::takeBytes(const char* data, size_t available) {
+	size_t take = (available < _remaining) ? available : _remaining;
+	if (!_body.write(data + _pos, take)) {
+		fail(500);
+		return false;
+	}
+	_bodyLength += take;
+	_pos += take;
+	_remaining -= take;
+	if (_remaining == 0) {
+		_state = (_state == S_BODY) ? S_DONE : S_CHUNK_DATA_END;
+	}
+	return true;
+}
+
+// Fields being read: the headers, or the trailer after a chunked body
+std::vector<RequestParser::HeaderSpan>& RequestParser::fields() {
+	return _inTrailer ? _trailers : _headers;
+}
+
+// A header line is complete: note the framing headers
+bool RequestParser::endHeader(const char* data) {
+	const HeaderSpan& header = fields().back();
+
+	// Framing and routing fields are not allowed in a trailer (RFC 7230 4.1.2)
+	if (_inTrailer) {
+		if (header.id == HeaderTable::HEADER_CONTENT_LENGTH || header.id == HeaderTable::HEADER_TRANSFER_ENCODING
+		    || header.id == HeaderTable::HEADER_HOST) {
+			_trailers.pop_back();
+		}
+		return true;
+	}
+
+	if (header.id == HeaderTable::HEADER_CONTENT_LENGTH) {
+		if (header.value.length == 0 || header.value.length > 18) {
+			fail(400);
+			return false;
+		}
+		size_t length = 0;
+		for (size_t i = 0; i < header.value.length; ++i) {
+			char c = data[header.value.offset + i];
+			if (!std::isdigit(static_cast<unsigned char>(c))) {
+				fail(400);
+				return false;
+			}
+			length = length * 10 + static_cast<size_t>(c - '0');
+		}
+		// Repeated with another value: ambiguous framing
+		if (_hasContentLength && length != _contentLength) {
+			fail(400);
+			return false;
+		}
+		_hasContentLength = true;
+		_contentLength = length;
+	} else if (header.id == HeaderTable::HEADER_TRANSFER_ENCODING) {
+		// Only chunked is supported: the coding list, over all the
+		// Transfer-Encoding lines, must be exactly one "chunked" token
+		size_t end = header.value.offset + header.value.length;
+		size_t tokens = 0;
+		for (size_t pos = header.value.offset; pos <= end; ) {
+			size_t comma = pos;
+			while (comma < end && data[comma] != ',') {
+				++comma;
+			}
+			size_t first = pos;
+			size_t last = comma;
+			while (first < last && (data[first] == ' ' || data[first] == '\t')) {
+				++first;
+			}
+			while (last > first && (data[last - 1] == ' ' || data[last - 1] == '\t')) {
+				--last;
+			}
+			if (first < last) {     // Empty list elements are allowed
+				if (!equalsIgnoreCase(data, makeSpan(first, last), "chunked") || _chunked || ++tokens > 1) {
+					fail(501);
+					return false;
+				}
+			}
+			pos = comma + 1;
+		}
+		if (tokens == 0) {
+			fail(501);
+			return false;
+		}
+		_chunked = true;
+	} else if (header.id == HeaderTable::HEADER_EXPECT) {
+		// Ignored from HTTP/1.0 clients (RFC 7231 5.1.1)
+		_expectContinue = equalsIgnoreCase(data, header.value, "100-continue")
+		                  && std::memcmp(data + _version.offset, "HTTP/1.0", 8) != 0;
+	}
+	return true;
+}
+
+// Empty line after the headers: how is the body framed? A declared
+// length over the limit is refused before any of the body is read.
+bool RequestParser::endHeaders() {
+	_headEnd = _pos + 1;
+	if (_chunked) {
+		// Transfer-Encoding overrides Content-Length (RFC 7230 3.3.3)
+		_lineStart = _pos + 1;
+		_state = S_CHUNK_SIZE;
+		_remaining = 0;
+		_chunkDigits = false;
+	} else if (_maxBodySize > 0 && _contentLength > _maxBodySize) {
+		fail(413);
+		return false;
+	} else if (_contentLength > 0) {
+		_state = S_BODY;
+		_remaining = _contentLength;
+	} else {
+		_state = S_DONE;
+	}
+	return true;
+}
+
+RequestParser::Result RequestParser::fail(int status) {
+	_state = S_ERROR;
+	_errorStatus = status;
+	Logger::debug << "Malformed request at byte " << _pos << " (" << status << ")" << std::endl;
+	return FAILED;
+}
+
+// Position in the buffer
+size_t RequestParser::start() const { return _start; }
+size_t RequestParser::end() const { return _start + _pos; }
+bool RequestParser::headComplete() const { return _headEnd > 0; }
+
+// Parsed request
+const RequestParser::Span& RequestParser::method() const { return _method; }
+Method::Id RequestParser::methodId() const { return _methodId; }
+const RequestParser::Span& RequestParser::target() const { return _target; }
+const RequestParser::Span& RequestParser::version() const { return _version; }
+const std::vector<RequestParser::HeaderSpan>& RequestParser::headers() const { return _headers; }
+const std::vector<RequestParser::HeaderSpan>& RequestParser::trailers() const { return _trailers; }
+BodySink& RequestParser::body() { return _body; }
+const BodySink& RequestParser::body() const { return _body; }
+size_t RequestParser::bodyLength() const { return _bodyLength; }
+bool RequestParser::hasContentLength() const { return _hasContentLength; }
+size_t RequestParser::contentLength() const { return _contentLength; }
+bool RequestParser::isChunked() const { return _chunked; }
+bool RequestParser::expectsContinue() const { return _expectContinue; }
+int RequestParser::errorStatus() const { return _errorStatus; }
+
+std::string RequestParser::str(const std::string& buffer, const Span& span) const {
+	return buffer.substr(_start + span.offset, span.length);
+}
+
+bool RequestParser::equalsIgnoreCase(const char* data, const Span& span, const char* word) {
+	size_t length = std::strlen(word);
+	if (span.length != length) {
+		return false;
+	}
+	for (size_t i = 0; i < length; ++i) {
+		if (std::tolower(static_cast<unsigned char>(data[span.offset + i])) != word[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+RequestParser::Span RequestParser::makeSpan(size_t from, size_t to) {
+	Span span;
+	span.offset = from;
+	span.length = to - from;
+	return span;
+}
+
+} // namespace HTTP
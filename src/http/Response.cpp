@@ -17,26 +17,93 @@
 #include "includes/http/Response.hpp"
 #include "includes/core/Settings.hpp"
 #include "includes/core/Instance.hpp"
+#include "includes/network/OutputQueue.hpp"
+#include "includes/http/CompressedStream.hpp"
 #include <sstream>
 #include <ctime>
-#include <iomanip>
+#include <unistd.h>
+#include <fcntl.h>
 
 namespace HTTP {
 
-// Constructor
+namespace {
+	// Decimal or hex digits of value, no iostreams or temporaries
+	size_t formatNumber(size_t value, unsigned base, char* end) {
+		static const char DIGITS[] = "0123456789abcdef";
+		char* pos = end;
+		do {
+			*--pos = DIGITS[value % base];
+			value /= base;
+		} while (value != 0);
+		return static_cast<size_t>(end - pos);
+	}
+
+	void appendNumber(std::string& out, size_t value, unsigned base) {
+		char digits[32];
+		size_t length = formatNumber(value, base, digits + sizeof(digits));
+		out.append(digits + sizeof(digits) - length, length);
+	}
+
+	// Another reference to a body file; plain dup() drops close-on-exec,
+	// and CGI children forked by other loop threads would inherit it
+	int dupBodyFd(int fd) {
+		return fcntl(fd, F_DUPFD_CLOEXEC, 0);
+	}
+}
+
+// Constructor (an empty _statusMessage means the standard reason phrase)
 Response::Response()
 	: _statusCode(200)
-	, _statusMessage("OK")
+	, _statusMessage("")
 	, _body("")
-	, _chunked(false) {
+	, _bodyFd(-1)
+	, _bodyZeroCopy(true)
+	, _bodyEncoding(Compressor::ENCODING_IDENTITY)
+	, _bodyLevel(0)
+	, _chunked(false)
+	, _bodyOmitted(false) {
+}
+
+Response::Response(const Response& other)
+	: _statusCode(other._statusCode)
+	, _statusMessage(other._statusMessage)
+	, _headers(other._headers)
+	, _body(other._body)
+	, _bodyFd(other._bodyFd >= 0 ? dupBodyFd(other._bodyFd) : -1)
+	, _bodyParts(other._bodyParts)
+	, _bodyZeroCopy(other._bodyZeroCopy)
+	, _bodyEncoding(other._bodyEncoding)
+	, _bodyLevel(other._bodyLevel)
+	, _chunked(other._chunked)
+	, _bodyOmitted(other._bodyOmitted) {
 }
 
-Response::~Response() {}
+Response& Response::operator=(const Response& other) {
+	if (this != &other) {
+		closeBodyFile();
+		_statusCode = other._statusCode;
+		_statusMessage = other._statusMessage;
+		_headers = other._headers;
+		_body = other._body;
+		_bodyFd = (other._bodyFd >= 0) ? dupBodyFd(other._bodyFd) : -1;
+		_bodyParts = other._bodyParts;
+		_bodyZeroCopy = other._bodyZeroCopy;
+		_bodyEncoding = other._bodyEncoding;
+		_bodyLevel = other._bodyLevel;
+		_chunked = other._chunked;
+		_bodyOmitted = other._bodyOmitted;
+	}
+	return *this;
+}
+
+Response::~Response() {
+	closeBodyFile();
+}
 
 // Set status
 void Response::setStatus(int code) {
 	_statusCode = code;
-	_statusMessage = getStatusMessage(code);
+	_statusMessage.clear();
 }
 
 void Response::setStatus(int code, const std::string& message) {
@@ -46,33 +113,42 @@ void Response::setStatus(int code, const std::string& message) {
 
 // Set header
 void Response::setHeader(const std::string& name, const std::string& value) {
-	_headers[name] = value;
+	_headers.set(name, value);
+}
+
+void Response::setHeader(HeaderTable::Id id, const std::string& value) {
+	_headers.set(id, value);
+}
+
+void Response::removeHeader(HeaderTable::Id id) {
+	_headers.remove(id);
 }
 
 void Response::setContentType(const std::string& contentType) {
-	setHeader("Content-Type", contentType);
+	setHeader(HeaderTable::HEADER_CONTENT_TYPE, contentType);
 }
 
 void Response::setContentLength(size_t length) {
-	std::ostringstream oss;
-	oss << length;
-	setHeader("Content-Length", oss.str());
+	char digits[32];
+	size_t digitCount = formatNumber(length, 10, digits + sizeof(digits));
+	_headers.set(HeaderTable::HEADER_CONTENT_LENGTH, digits + sizeof(digits) - digitCount, digitCount);
 }
 
 void Response::setLastModified(time_t mtime) {
-	setHeader("Last-Modified", formatHttpDate(mtime));
+	setHeader(HeaderTable::HEADER_LAST_MODIFIED, formatHttpDate(mtime));
 }
 
 void Response::setETag(const std::string& etag) {
-	setHeader("ETag", "\"" + etag + "\"");
+	setHeader(HeaderTable::HEADER_ETAG, "\"" + etag + "\"");
 }
 
 void Response::setCacheControl(const std::string& cacheControl) {
-	setHeader("Cache-Control", cacheControl);
+	setHeader(HeaderTable::HEADER_CACHE_CONTROL, cacheControl);
 }
 
 // Set body
 void Response::setBody(const std::string& body) {
+	closeBodyFile();
 	_body = body;
 	if (!_chunked) {
 		setContentLength(_body.length());
@@ -80,85 +156,219 @@ void Response::setBody(const std::string& body) {
 }
 
 void Response::appendBody(const std::string& chunk) {
+	closeBodyFile();
 	_body += chunk;
 	if (!_chunked) {
 		setContentLength(_body.length());
 	}
 }
 
+void Response::swapBody(std::string& body) {
+	closeBodyFile();
+	_body.swap(body);
+	if (!_chunked) {
+		setContentLength(_body.length());
+	}
+}
+
+void Response::omitBody() {
+	_body.clear();
+	closeBodyFile();
+	_bodyOmitted = true;
+}
+
+void Response::setBodyFile(int fd, off_t offset, size_t length, bool zeroCopy) {
+	std::vector<FilePart> parts(1);
+	parts[0].offset = offset;
+	parts[0].length = length;
+	setBodyFile(fd, parts, zeroCopy);
+}
+
+void Response::setBodyFile(int fd, const std::vector<FilePart>& parts, bool zeroCopy) {
+	closeBodyFile();
+	_body.clear();
+	_bodyFd = fd;
+	_bodyParts = parts;
+	_bodyZeroCopy = zeroCopy;
+	if (!_chunked) {
+		setContentLength(bodyLength());
+	}
+}
+
+bool Response::readBodyFile(std::string& out) const {
+	for (size_t i = 0; i < _bodyParts.size(); ++i) {
+		const FilePart& part = _bodyParts[i];
+		out += part.text;
+		size_t start = out.size();
+		out.resize(start + part.length);
+		ssize_t got = (part.length > 0) ? pread(_bodyFd, &out[start], part.length, part.offset) : 0;
+		out.resize(start + (got > 0 ? static_cast<size_t>(got) : 0));
+		if (static_cast<size_t>(got > 0 ? got : 0) != part.length) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// The chunk framing comes from the stream itself, so _chunked stays off
+void Response::streamCompressed(Compressor::Encoding encoding, int level) {
+	_bodyEncoding = encoding;
+	_bodyLevel = level;
+	_headers.remove(HeaderTable::HEADER_CONTENT_LENGTH);
+	setHeader(HeaderTable::HEADER_TRANSFER_ENCODING, "chunked");
+	setHeader(HeaderTable::HEADER_CONTENT_ENCODING, Compressor::name(encoding));
+}
+
 void Response::setChunked(bool chunked) {
 	_chunked = chunked;
 	if (_chunked) {
-		setHeader("Transfer-Encoding", "chunked");
+		setHeader(HeaderTable::HEADER_TRANSFER_ENCODING, "chunked");
 		// Remove Content-Length if present (incompatible with chunked)
-		_headers.erase("Content-Length");
+		_headers.remove(HeaderTable::HEADER_CONTENT_LENGTH);
 	}
 }
 
 // Set keep-alive
 void Response::setKeepAlive(bool keepAlive) {
 	if (keepAlive) {
-		setHeader("Connection", "keep-alive");
+		setHeader(HeaderTable::HEADER_CONNECTION, "keep-alive");
 	} else {
-		setHeader("Connection", "close");
+		setHeader(HeaderTable::HEADER_CONNECTION, "close");
 	}
 }
 
-// Build response string
-std::string Response::build() const {
-	if (_chunked) {
-		return buildChunkedResponse();
+// Queue for sending
+void Response::serialize(OutputQueue& out) {
+	writeHead(out.beginText());
+	out.endText();
+	size_t length = bodyLength();
+	if (!_bodyOmitted) {
+		if (_bodyFd >= 0 && _bodyEncoding != Compressor::ENCODING_IDENTITY) {
+			out.addSource(new CompressedStream(_bodyFd, _bodyParts[0].offset, _bodyParts[0].length,
+			                                   _bodyEncoding, _bodyLevel));
+			_bodyFd = -1;
+		} else if (_bodyFd >= 0) {
+			queueFileParts(out);
+		} else {
+			out.addString(_body);
+		}
+		if (_chunked) {
+			writeTail(out.beginText(), length);
+			out.endText();
+		}
 	}
+	_body.clear();
+	closeBodyFile();
+	out.endMessage();
+}
 
-	std::ostringstream response;
-
-	// Status line
-	response << "HTTP/1.1 " << _statusCode << " " << _statusMessage << "\r\n";
+// Build response string (a file body is read in)
+std::string Response::build() const {
+	std::string response;
+	writeHead(response);
+	if (!_bodyOmitted) {
+		if (_bodyFd >= 0 && _bodyEncoding != Compressor::ENCODING_IDENTITY) {
+			// What the stream would send, as a single chunk
+			std::string file;
+			std::string compressed;
+			readBodyFile(file);
+			Compressor::compress(_bodyEncoding, _bodyLevel, file.data(), file.size(), compressed);
+			if (!compressed.empty()) {
+				appendNumber(response, compressed.size(), 16);
+				response.append("\r\n", 2);
+				response += compressed;
+				response.append("\r\n", 2);
+			}
+			response.append("0\r\n\r\n", 5);
+		} else if (_bodyFd >= 0) {
+			readBodyFile(response);
+		} else {
+			response += _body;
+		}
+		writeTail(response, bodyLength());
+	}
+	return response;
+}
 
-	// Headers
-	for (std::map<std::string, std::string>::const_iterator it = _headers.begin();
-	     it != _headers.end(); ++it) {
-		response << it->first << ": " << it->second << "\r\n";
+void Response::writeHead(std::string& out) const {
+	const std::string* statusLine = NULL;
+	if (_statusMessage.empty()) {
+		statusLine = &Instance::Get<Settings>()->httpStatusLine(_statusCode);
+	}
+	if (statusLine && !statusLine->empty()) {
+		out += *statusLine;
+	} else {
+		// Custom reason phrase, or a code outside the table
+		out.append("HTTP/1.1 ", 9);
+		appendNumber(out, static_cast<size_t>(_statusCode), 10);
+		out += ' ';
+		out += _statusMessage.empty() ? getStatusMessage(_statusCode) : _statusMessage;
+		out.append("\r\n", 2);
 	}
 
-	// Empty line separating headers from body
-	response << "\r\n";
+	_headers.appendTo(out);
+	out.append("\r\n", 2);
 
-	// Body
-	if (!_body.empty()) {
-		response << _body;
+	// Whole body as a single chunk
+	if (_chunked && !_bodyOmitted && bodyLength() > 0) {
+		appendNumber(out, bodyLength(), 16);
+		out.append("\r\n", 2);
 	}
-
-	return response.str();
 }
 
-// Build chunked response
-std::string Response::buildChunkedResponse() const {
-	std::ostringstream response;
-
-	// Status line
-	response << "HTTP/1.1 " << _statusCode << " " << _statusMessage << "\r\n";
-
-	// Headers (Transfer-Encoding: chunked already set)
-	for (std::map<std::string, std::string>::const_iterator it = _headers.begin();
-	     it != _headers.end(); ++it) {
-		response << it->first << ": " << it->second << "\r\n";
+void Response::writeTail(std::string& out, size_t length) const {
+	if (!_chunked) {
+		return;
 	}
+	if (length > 0) {
+		out.append("\r\n", 2);
+	}
+	out.append("0\r\n\r\n", 5);
+}
 
-	// Empty line separating headers from body
-	response << "\r\n";
-
-	// Chunked body
-	if (!_body.empty()) {
-		// Send body in chunks (we'll send it all as one chunk for simplicity)
-		response << std::hex << _body.length() << "\r\n";
-		response << _body << "\r\n";
+size_t Response::bodyLength() const {
+	if (_bodyFd < 0) {
+		return _body.length();
 	}
+	size_t length = 0;
+	for (size_t i = 0; i < _bodyParts.size(); ++i) {
+		length += _bodyParts[i].text.size() + _bodyParts[i].length;
+	}
+	return length;
+}
 
-	// Last chunk (size 0)
-	response << "0\r\n\r\n";
+// Each range gets its own fd (the queue closes them one by one); the last
+// one takes ours
+void Response::queueFileParts(OutputQueue& out) {
+	size_t lastRange = _bodyParts.size();
+	for (size_t i = 0; i < _bodyParts.size(); ++i) {
+		if (_bodyParts[i].length > 0) {
+			lastRange = i;
+		}
+	}
+	for (size_t i = 0; i < _bodyParts.size(); ++i) {
+		FilePart& part = _bodyParts[i];
+		out.addText(part.text.data(), part.text.size());
+		if (part.length == 0) {
+			continue;
+		}
+		int fd = _bodyFd;
+		if (i == lastRange) {
+			_bodyFd = -1;
+		} else {
+			fd = dupBodyFd(_bodyFd);
+		}
+		out.addFile(fd, part.offset, part.length, _bodyZeroCopy);
+	}
+}
 
-	return response.str();
+void Response::closeBodyFile() {
+	if (_bodyFd >= 0) {
+		close(_bodyFd);
+		_bodyFd = -1;
+	}
+	_bodyParts.clear();
+	_bodyEncoding = Compressor::ENCODING_IDENTITY;
 }
 
 // Getters
@@ -166,12 +376,28 @@ int Response::getStatusCode() const {
 	return _statusCode;
 }
 
+const HeaderTable& Response::getHeaders() const {
+	return _headers;
+}
+
+std::string Response::getHeader(HeaderTable::Id id) const {
+	return _headers.get(id);
+}
+
 const std::string& Response::getBody() const {
 	return _body;
 }
 
+size_t Response::getBodyLength() const {
+	return bodyLength();
+}
+
+bool Response::hasFileBody() const {
+	return _bodyFd >= 0;
+}
+
 // Get status message for code
-std::string Response::getStatusMessage(int code) const {
+const std::string& Response::getStatusMessage(int code) const {
 	Settings* settings = Instance::Get<Settings>();
 	return settings->httpStatusCode(code);
 }
@@ -179,8 +405,9 @@ std::string Response::getStatusMessage(int code) const {
 // Format time as HTTP date (RFC 7231)
 std::string Response::formatHttpDate(time_t time) const {
 	char buffer[128];
-	struct tm* tm_info = gmtime(&time);
-	strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", tm_info);
+	struct tm tm_info;
+	gmtime_r(&time, &tm_info); // Reentrant: responses are built on every loop thread
+	strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm_info);
 	return std::string(buffer);
 }
 
@@ -207,7 +434,6 @@ Response Response::errorResponse(int code, const std::string& message) {
 	     << "</html>\n";
 
 	response.setBody(body.str());
-	response.setKeepAlive(false);
 
 	return response;
 }
@@ -215,7 +441,7 @@ Response Response::errorResponse(int code, const std::string& message) {
 Response Response::redirect(const std::string& location, int code) {
 	Response response;
 	response.setStatus(code);
-	response.setHeader("Location", location);
+	response.setHeader(HeaderTable::HEADER_LOCATION, location);
 	response.setContentType("text/html");
 
 	std::ostringstream body;
@@ -236,10 +462,12 @@ Response Response::redirect(const std::string& location, int code) {
 // Clear response
 void Response::clear() {
 	_statusCode = 200;
-	_statusMessage = "OK";
+	_statusMessage.clear();
 	_headers.clear();
 	_body.clear();
+	closeBodyFile();
 	_chunked = false;
+	_bodyOmitted = false;
 }
 
 } // namespace HTTP
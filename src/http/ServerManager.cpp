@@ -15,42 +15,49 @@
  * Implementation of HTTP Server Manager
  */
 #include "includes/http/ServerManager.hpp"
+#include "includes/utils/ByteScan.hpp"
 #include "includes/utils/Logger.hpp"
 #include <cstring>
 #include <cerrno>
 #include <algorithm>
 #include <sstream>
 #include <signal.h>
-#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace HTTP {
 
 // Constructor
 ServerManager::ServerManager()
-	: _running(false)
-	, _timeout(60) {
+	: _nextLoop(0)
+	, _overloaded(false)
+	, _running(0)
+	, _draining(0) {
 	// Ignore SIGPIPE (broken pipe) - we'll handle write errors instead
 	signal(SIGPIPE, SIG_IGN);
 }
 
 // Destructor
 ServerManager::~ServerManager() {
-	cleanupAllConnections();
-
-	// Close listening sockets
-	for (size_t i = 0; i < _listeningSockets.size(); ++i) {
-		delete _listeningSockets[i];
+	// Loops close their connections; listeners belong to the ListenerPool
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		delete _loops[i];
 	}
-	_listeningSockets.clear();
+	_loops.clear();
 }
 
 // Initialize with configuration
-bool ServerManager::init(const Config& config) {
+bool ServerManager::init(const Config& config, const std::vector<Socket*>& listeners) {
 	Logger::info << "Initializing server manager..." << std::endl;
 
 	_config = config;
 
-	if (!setupListeningSockets()) {
+	if (!setupLoops()) {
+		Logger::error << "Failed to setup event loops" << std::endl;
+		return false;
+	}
+
+	if (!setupListeningSockets(listeners)) {
 		Logger::error << "Failed to setup listening sockets" << std::endl;
 		return false;
 	}
@@ -59,44 +66,42 @@ bool ServerManager::init(const Config& config) {
 	return true;
 }
 
-// Setup listening sockets
-bool ServerManager::setupListeningSockets() {
-	const std::vector<Server>& servers = _config.getServers();
-
-	// Create listening sockets for each unique host:port combination
-	std::map<std::string, bool> uniqueBindings;
-
-	for (size_t i = 0; i < servers.size(); ++i) {
-		const Server& server = servers[i];
-		const std::string& host = server.getHost();
-		const std::vector<int>& ports = server.getPorts();
+// Create one event loop per worker thread
+bool ServerManager::setupLoops() {
+	size_t count = static_cast<size_t>(_config.getWorkerThreads());
 
-		for (size_t j = 0; j < ports.size(); ++j) {
-			int port = ports[j];
+	for (size_t i = 0; i < count; ++i) {
+		EventLoop* loop = new EventLoop(this, i);
+		_loops.push_back(loop);
+		if (!loop->init(_config.getEventBackend())) {
+			return false;
+		}
+	}
 
-			// Create unique key for this binding
-			std::ostringstream key;
-			key << host << ":" << port;
-			std::string bindingKey = key.str();
+	Logger::info << "Using " << Logger::param(_loops[0]->getBackendName()) << " event backend, "
+	             << Logger::param(count) << " event loop thread(s), "
+	             << Logger::param(ByteScan::levelName(ByteScan::level())) << " byte scanning" << std::endl;
+	return true;
+}
 
-			// Skip if we already have a socket for this binding
-			if (uniqueBindings.find(bindingKey) != uniqueBindings.end()) {
-				Logger::debug << "Socket already exists for " << bindingKey << std::endl;
-				continue;
-			}
+// Watch the listening sockets handed over by the process owner
+bool ServerManager::setupListeningSockets(const std::vector<Socket*>& listeners) {
+	for (size_t i = 0; i < listeners.size(); ++i) {
+		Socket* sock = listeners[i];
 
-			// Create listening socket
-			Socket* sock = createListeningSocket(host, port);
-			if (!sock) {
-				Logger::error << "Failed to create listening socket for " << host << ":" << port << std::endl;
-				return false;
-			}
-
-			_listeningSockets.push_back(sock);
-			uniqueBindings[bindingKey] = true;
+		// Resolve the default server once, not on every accept
+		const Server* defaultServer = _config.getDefaultServer(sock->getHost(), sock->getPort());
+		if (!defaultServer) {
+			Logger::error << "No server configuration found for " << sock->getHost() << ":" << sock->getPort() << std::endl;
+			return false;
+		}
+		sock->setServer(defaultServer);
 
-			Logger::success << "Listening on " << host << ":" << port << std::endl;
+		// Listeners are watched by loop #0, which accepts for all loops
+		if (!_loops[0]->addListener(sock)) {
+			return false;
 		}
+		_listeningSockets.push_back(sock);
 	}
 
 	if (_listeningSockets.empty()) {
@@ -107,51 +112,10 @@ bool ServerManager::setupListeningSockets() {
 	return true;
 }
 
-// Create listening socket
-Socket* ServerManager::createListeningSocket(const std::string& host, int port) {
-	Socket* sock = new Socket();
-
-	// Create socket
-	if (!sock->create()) {
-		delete sock;
-		return NULL;
-	}
-
-	// Configure socket
-	if (!sock->setReuseAddr()) {
-		Logger::warning << "Failed to set SO_REUSEADDR" << std::endl;
-	}
-
-	sock->setReusePort(); // May not be available on all systems
-
-	// Bind
-	if (!sock->bind(host, port)) {
-		delete sock;
-		return NULL;
-	}
-
-	// Set non-blocking
-	if (!sock->setNonBlocking()) {
-		delete sock;
-		return NULL;
-	}
-
-	// Listen
-	if (!sock->listen(128)) {
-		delete sock;
-		return NULL;
-	}
-
-	return sock;
-}
-
 // Start the server (blocking loop)
 bool ServerManager::run() {
 	Logger::info << "Starting server..." << std::endl;
-	_running = true;
-
-	// Build initial poll fds
-	rebuildPollFds();
+	_running = 1;
 
 	Logger::success << "Server running! Press Ctrl+C to stop." << std::endl;
 	std::cout << std::endl;
@@ -171,238 +135,242 @@ bool ServerManager::run() {
 	}
 	std::cout << std::endl;
 
-	// Main event loop
-	while (_running) {
-		// Poll with 1 second timeout
-		int pollResult = poll(&_pollFds[0], _pollFds.size(), 1000);
-
-		if (pollResult < 0) {
-			if (errno == EINTR) {
-				// Interrupted by signal, continue
-				continue;
-			}
-			Logger::error << "poll() failed: " << std::strerror(errno) << std::endl;
-			break;
-		}
-
-		if (pollResult == 0) {
-			// Timeout - check for timed out connections
-			cleanupTimedOutConnections();
-			continue;
-		}
-
-		// Check which file descriptors have events
-		for (size_t i = 0; i < _pollFds.size() && pollResult > 0; ++i) {
-			struct pollfd& pfd = _pollFds[i];
-
-			if (pfd.revents == 0) {
-				continue; // No events for this fd
-			}
-
-			--pollResult; // Count down events processed
-
-			// Check if this is a listening socket
-			bool isListening = false;
-			for (size_t j = 0; j < _listeningSockets.size(); ++j) {
-				if (_listeningSockets[j]->getFd() == pfd.fd) {
-					isListening = true;
-					handleListeningSocket(pfd.fd);
-					break;
-				}
-			}
-
-			// If not listening socket, it's a client connection
-			if (!isListening) {
-				handleClientSocket(pfd.fd, pfd.revents);
-			}
-		}
+	// Loops #1..N-1 get their own threads; loop #0 runs here
+	if (!startThreads()) {
+		stop();
+	} else {
+		_loops[0]->run();
+	}
 
-		// Rebuild poll fds if connections changed
-		// (we could optimize this to only rebuild when needed)
-		rebuildPollFds();
+	// Loop #0 returned: on stop() or a fatal error bring the others down
+	// too; when draining, let them finish their own connections
+	if (!_draining) {
+		stop();
 	}
+	joinThreads();
 
 	Logger::info << "Server stopped." << std::endl;
 	return true;
 }
 
-// Stop the server
+// Stop the server (called from signal handlers, so no logging here)
 void ServerManager::stop() {
-	Logger::info << "Stopping server..." << std::endl;
-	_running = false;
+	_running = 0;
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		_loops[i]->stop();
+	}
 }
 
-// Check if server is running
-bool ServerManager::isRunning() const {
-	return _running;
+// Stop accepting and exit once every connection is done (async-signal-safe)
+void ServerManager::drain() {
+	_draining = 1;
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		_loops[i]->drain();
+	}
 }
 
-// Rebuild poll fds array
-void ServerManager::rebuildPollFds() {
-	_pollFds.clear();
-
-	// Add listening sockets (monitor for POLLIN - new connections)
-	for (size_t i = 0; i < _listeningSockets.size(); ++i) {
-		struct pollfd pfd;
-		pfd.fd = _listeningSockets[i]->getFd();
-		pfd.events = POLLIN;
-		pfd.revents = 0;
-		_pollFds.push_back(pfd);
+void ServerManager::requestStats() {
+	if (!_loops.empty()) {
+		_loops[0]->requestStats();
 	}
+}
 
-	// Add client connections
-	for (std::map<int, Connection*>::iterator it = _connections.begin();
-	     it != _connections.end(); ++it) {
-		Connection* conn = it->second;
-		struct pollfd pfd;
-		pfd.fd = conn->getFd();
-		pfd.revents = 0;
-
-		// Monitor based on connection state
-		if (conn->getState() == Connection::READING_REQUEST) {
-			pfd.events = POLLIN;  // Monitor for read
-		} else if (conn->getState() == Connection::WRITING_RESPONSE) {
-			pfd.events = POLLOUT; // Monitor for write
-		} else {
-			pfd.events = POLLIN | POLLOUT; // Monitor both
-		}
-
-		_pollFds.push_back(pfd);
+void ServerManager::collectStats(LoopStats& total) const {
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		LoopStats loop;
+		_loops[i]->getStats().snapshot(loop);
+		total.merge(loop);
 	}
 }
 
-// Handle listening socket (new connection)
-void ServerManager::handleListeningSocket(int fd) {
-	// Find the listening socket
-	Socket* listenSocket = NULL;
-	for (size_t i = 0; i < _listeningSockets.size(); ++i) {
-		if (_listeningSockets[i]->getFd() == fd) {
-			listenSocket = _listeningSockets[i];
-			break;
-		}
-	}
+void ServerManager::dumpStats() const {
+	std::ostringstream title;
+	title << "Event loop stats (pid " << getpid() << ", " << totalLoad() << " open connection(s))";
 
-	if (!listenSocket) {
-		Logger::error << "Listening socket not found for fd: " << fd << std::endl;
+	if (_loops.size() == 1) {
+		LoopStats stats;
+		_loops[0]->getStats().snapshot(stats);
+		stats.dump(title.str());
 		return;
 	}
 
-	// Accept new connections (may be multiple)
-	while (true) {
-		struct sockaddr_in clientAddr;
-		int clientFd = listenSocket->accept(clientAddr);
-
-		if (clientFd < 0) {
-			break; // No more connections to accept
-		}
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		LoopStats stats;
+		_loops[i]->getStats().snapshot(stats);
+		std::ostringstream loopTitle;
+		loopTitle << "Loop #" << i << " (pid " << getpid() << ", " << _loops[i]->load() << " open connection(s))";
+		stats.dump(loopTitle.str());
+	}
 
-		// Set client socket to non-blocking
-		int flags = fcntl(clientFd, F_GETFL, 0);
-		if (flags >= 0) {
-			fcntl(clientFd, F_SETFL, flags | O_NONBLOCK);
-		}
+	LoopStats total;
+	collectStats(total);
+	total.dump(title.str() + ", all loops");
+}
 
-		Logger::debug << "Socket set to non-blocking mode (fd: " << clientFd << ")" << std::endl;
+// Check if server is running
+bool ServerManager::isRunning() const {
+	return _running != 0;
+}
 
-		// Find the server configuration for this socket
-		const Server* server = _config.getDefaultServer(
-			listenSocket->getHost(),
-			listenSocket->getPort()
-		);
+// Thread entry point: run one loop until stopped
+void* ServerManager::threadMain(void* arg) {
+	static_cast<EventLoop*>(arg)->run();
+	return NULL;
+}
 
-		if (!server) {
-			Logger::warning << "No server configuration found for connection" << std::endl;
-			close(clientFd);
-			continue;
+// Start a thread for every loop but the first
+bool ServerManager::startThreads() {
+	// Worker threads never take process signals; loop #0's thread does
+	sigset_t blocked, saved;
+	sigfillset(&blocked);
+	pthread_sigmask(SIG_BLOCK, &blocked, &saved);
+
+	bool ok = true;
+	for (size_t i = 1; i < _loops.size(); ++i) {
+		pthread_t thread;
+		int err = pthread_create(&thread, NULL, threadMain, _loops[i]);
+		if (err != 0) {
+			Logger::error << "Failed to start loop thread #" << i << ": " << std::strerror(err) << std::endl;
+			ok = false;
+			break;
 		}
-
-		// Create connection object
-		Connection* conn = new Connection(clientFd, clientAddr, server);
-		_connections[clientFd] = conn;
-
-		Logger::info << "Accepted new connection (fd: " << clientFd
-		             << "), total connections: " << _connections.size() << std::endl;
+		_threads.push_back(thread);
 	}
+
+	pthread_sigmask(SIG_SETMASK, &saved, NULL);
+	return ok;
 }
 
-// Handle client socket events
-void ServerManager::handleClientSocket(int fd, short revents) {
-	// Find connection
-	std::map<int, Connection*>::iterator it = _connections.find(fd);
-	if (it == _connections.end()) {
-		Logger::warning << "Connection not found for fd: " << fd << std::endl;
-		return;
+void ServerManager::joinThreads() {
+	for (size_t i = 0; i < _threads.size(); ++i) {
+		pthread_join(_threads[i], NULL);
 	}
+	_threads.clear();
+}
 
-	Connection* conn = it->second;
-
-	// Check for errors
-	if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
-		Logger::debug << "Connection error/hangup (fd: " << fd << ")" << std::endl;
-		closeConnection(fd);
-		return;
+// Connections owned or queued by every loop of this process
+size_t ServerManager::totalLoad() const {
+	size_t total = 0;
+	for (size_t i = 0; i < _loops.size(); ++i) {
+		total += _loops[i]->load();
 	}
+	return total;
+}
 
-	// Handle reading
-	if (revents & POLLIN) {
-		if (!conn->readRequest()) {
-			Logger::debug << "Error reading request (fd: " << fd << ")" << std::endl;
-			closeConnection(fd);
-			return;
+// Least-loaded loop; ties rotate so idle loops share new connections
+EventLoop* ServerManager::pickLoop() {
+	size_t count = _loops.size();
+	size_t best = _nextLoop % count;
+	size_t bestLoad = _loops[best]->load();
+
+	for (size_t n = 1; n < count && bestLoad > 0; ++n) {
+		size_t i = (_nextLoop + n) % count;
+		size_t load = _loops[i]->load();
+		if (load < bestLoad) {
+			best = i;
+			bestLoad = load;
 		}
 	}
 
-	// Handle writing
-	if (revents & POLLOUT) {
-		if (conn->getState() == Connection::WRITING_RESPONSE) {
-			if (!conn->writeResponse()) {
-				Logger::debug << "Error writing response (fd: " << fd << ")" << std::endl;
-				closeConnection(fd);
-				return;
-			}
-		}
-	}
+	_nextLoop = best + 1;
+	return _loops[best];
+}
 
-	// Check if connection should be closed
-	if (conn->shouldClose()) {
-		closeConnection(fd);
+// Answer an accepted socket with the canned 503 and close it
+// No Connection, no parsing, no allocation: a few syscalls on a static buffer
+void ServerManager::rejectOverloaded(int clientFd) {
+	static const char response[] =
+		"HTTP/1.1 503 Service Unavailable\r\n"
+		"Content-Type: text/plain\r\n"
+		"Content-Length: 20\r\n"
+		"Retry-After: 1\r\n"
+		"Connection: close\r\n"
+		"\r\n"
+		"Service Unavailable\n";
+
+	// Best effort: a fresh socket has an empty send buffer, so this fits
+	ssize_t sent = send(clientFd, response, sizeof(response) - 1, 0); // SIGPIPE is ignored
+	(void)sent;
+
+	// Discard the request bytes that already arrived (the socket is
+	// non-blocking), so close() sends a FIN after the response instead of
+	// a RST that could destroy it
+	shutdown(clientFd, SHUT_WR);
+	char discard[512];
+	while (recv(clientFd, discard, sizeof(discard), 0) > 0) {
 	}
+	close(clientFd);
 }
 
-// Close connection
-void ServerManager::closeConnection(int fd) {
-	std::map<int, Connection*>::iterator it = _connections.find(fd);
-	if (it != _connections.end()) {
-		Logger::debug << "Closing connection (fd: " << fd << ")" << std::endl;
-		delete it->second;
-		_connections.erase(it);
+// Handle listening socket (new connections)
+// At most accept_budget clients per call: the listener stays readable, so
+// the rest are picked up next iteration, after the established clients
+// of this iteration have been served
+void ServerManager::handleListeningSocket(Socket* listenSocket) {
+	const Server* server = listenSocket->getServer();
+	int budget = _config.getAcceptBudget();
+	size_t load = totalLoad();
+
+	for (int accepted = 0; accepted < budget; ++accepted) {
+		struct sockaddr_in clientAddr;
+		int clientFd = listenSocket->accept(clientAddr);
+
+		if (clientFd < 0) {
+			break; // No more connections to accept
+		}
+		placeClient(clientFd, clientAddr, server, load);
 	}
 }
 
-// Cleanup timed out connections
-void ServerManager::cleanupTimedOutConnections() {
-	std::vector<int> toClose;
+// Socket the event backend already accepted on a listener (io_uring)
+void ServerManager::handleAcceptedSocket(Socket* listenSocket, int clientFd) {
+	struct sockaddr_in clientAddr;
+	socklen_t addrLen = sizeof(clientAddr);
+	std::memset(&clientAddr, 0, sizeof(clientAddr));
+	getpeername(clientFd, reinterpret_cast<struct sockaddr*>(&clientAddr), &addrLen);
+
+	size_t load = totalLoad();
+	placeClient(clientFd, clientAddr, listenSocket->getServer(), load);
+}
 
-	for (std::map<int, Connection*>::iterator it = _connections.begin();
-	     it != _connections.end(); ++it) {
-		if (it->second->isTimedOut(_timeout)) {
-			Logger::warning << "Connection timed out (fd: " << it->first << ")" << std::endl;
-			toClose.push_back(it->first);
+// Give an accepted client to the least loaded loop, or 503 when overloaded
+void ServerManager::placeClient(int clientFd, const struct sockaddr_in& clientAddr, const Server* server, size_t& load) {
+	size_t limit = static_cast<size_t>(_config.getWorkerConnections());
+
+	// Above the high watermark: keep draining the backlog, but answer
+	// 503 right away instead of letting clients time out in SYN queues
+	if (load >= limit) {
+		load = totalLoad(); // Loops may have closed some since
+		if (load >= limit) {
+			if (!_overloaded) {
+				Logger::warning << "worker_connections (" << limit << ") reached, rejecting new connections with 503" << std::endl;
+				_overloaded = true;
+			}
+			rejectOverloaded(clientFd);
+			return;
 		}
 	}
+	if (_overloaded) {
+		Logger::info << "Below worker_connections again, accepting new connections" << std::endl;
+		_overloaded = false;
+	}
+	++load;
 
-	for (size_t i = 0; i < toClose.size(); ++i) {
-		closeConnection(toClose[i]);
+	// Loop #0 is the calling thread and adopts directly; others get a hand-off
+	EventLoop* loop = pickLoop();
+	if (loop == _loops[0]) {
+		loop->adopt(clientFd, clientAddr, server);
+		return;
 	}
-}
 
-// Cleanup all connections
-void ServerManager::cleanupAllConnections() {
-	for (std::map<int, Connection*>::iterator it = _connections.begin();
-	     it != _connections.end(); ++it) {
-		delete it->second;
+	EventLoop::Handoff handoff;
+	handoff.fd = clientFd;
+	handoff.addr = clientAddr;
+	handoff.server = server;
+	if (!loop->post(handoff)) {
+		Logger::warning << "Hand-off queue of loop #" << loop->getId() << " is full, dropping connection" << std::endl;
+		close(clientFd);
 	}
-	_connections.clear();
 }
 
 } // namespace HTTP
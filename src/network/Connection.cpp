@@ -22,26 +22,38 @@
 #include <unistd.h>
 #include <cstring>
 #include <cerrno>
-#include <ctime>
 
 // Constructors
-Connection::Connection(int fd, const struct sockaddr_in& addr, const Server* server)
+Connection::Connection(int fd, const struct sockaddr_in& addr, const Server* server, TimerWheel* timers)
 	: _fd(fd)
 	, _addr(addr)
 	, _clientHost(Socket::getHostString(addr))
 	, _clientPort(Socket::getPortNumber(addr))
 	, _server(server)
 	, _state(READING_REQUEST)
-	, _lastActivity(std::time(NULL))
-	, _responseOffset(0)
+	, _timers(timers)
+	, _lastActivity(0)
 	, _keepAlive(false)
-	, _shouldClose(false) {
+	, _keepAliveAllowed(true)
+	, _requestsServed(0)
+	, _shouldClose(false)
+	, _expectAnswered(false) {
+
+	_idleTimer.kind = TIMER_IDLE;
+	_idleTimer.owner = this;
+	_headerTimer.kind = TIMER_HEADER;
+	_headerTimer.owner = this;
+	_parser.setMaxBodySize(_server->getMaxBodySize());
+	_parser.setBodyBufferSize(_server->getBodyBufferSize());
 
-	Logger::info << "New connection from " << _clientHost << ":" << _clientPort
-	             << " (fd: " << _fd << ")" << std::endl;
+	updateActivity();
+	_timers->schedule(&_headerTimer, _server->getClientHeaderTimeout() * 1000ULL);
 }
 
 Connection::~Connection() {
+	_timers->cancel(&_idleTimer);
+	_timers->cancel(&_headerTimer);
+
 	if (_fd >= 0) {
 		::close(_fd);
 		Logger::debug << "Connection closed (fd: " << _fd << ")" << std::endl;
@@ -53,100 +65,141 @@ bool Connection::readRequest() {
 	const size_t BUFFER_SIZE = 4096;
 	char buffer[BUFFER_SIZE];
 
-	ssize_t bytesRead = recv(_fd, buffer, BUFFER_SIZE - 1, 0);
+	ssize_t bytesRead = recv(_fd, buffer, BUFFER_SIZE, 0);
 
 	if (bytesRead < 0) {
 		// Non-blocking socket: would block means no data available
 		// Don't check errno - just return success and try again later
 		return true; // Not an error for non-blocking sockets
 	}
+	return receive(buffer, bytesRead);
+}
 
-	if (bytesRead == 0) {
+bool Connection::receive(const char* data, ssize_t length) {
+	if (length == 0) {
 		// Client closed connection
 		Logger::debug << "Client closed connection (fd: " << _fd << ")" << std::endl;
+		// Half-closed after pipelining: still answer what was received
+		if (!_output.empty() || _state == PROCESSING) {
+			disableKeepAlive();
+			return true;
+		}
 		_shouldClose = true;
 		return false;
 	}
 
+	// Drop requests already parsed before the buffer grows (the parser
+	// keeps offsets relative to the request start, so they stay valid)
+	if (_parser.start() > 0) {
+		_requestBuffer.erase(0, _parser.start());
+		_parser.rebase();
+	}
+	// Body bytes are already in the parser's sink
+	_parser.dropBody(_requestBuffer);
+
 	// Append to request buffer
-	buffer[bytesRead] = '\0';
-	_requestBuffer.append(buffer, bytesRead);
+	_requestBuffer.append(data, length);
 	updateActivity();
 
-	Logger::debug << "Read " << bytesRead << " bytes from connection (fd: " << _fd
+	Logger::debug << "Read " << length << " bytes from connection (fd: " << _fd
 	              << "), total: " << _requestBuffer.size() << " bytes" << std::endl;
 
-	// Check if we have a complete HTTP request
-	if (_requestBuffer.find("\r\n\r\n") != std::string::npos) {
-		Logger::debug << "Complete request received (fd: " << _fd << ")" << std::endl;
-		_state = PROCESSING;
-
-		// Parse HTTP request
-		HTTP::Request request;
-		if (!request.parse(_requestBuffer)) {
-			Logger::error << "Failed to parse HTTP request" << std::endl;
-			HTTP::Response errorResp = HTTP::Response::errorResponse(400, "Bad Request");
-			_responseBuffer = errorResp.build();
-			_responseOffset = 0;
-			_state = WRITING_RESPONSE;
-			_shouldClose = true;
-			return true;
-		}
-
-		// Debug: print request
-		if (Logger::debug << "") {
-			request.print();
-		}
-
-		// Handle request
-		HTTP::RequestHandler handler(_server);
-		HTTP::Response response = handler.handle(request);
-
-		// Build response
-		_responseBuffer = response.build();
-		_responseOffset = 0;
-		_state = WRITING_RESPONSE;
-		// Don't set _shouldClose here - let writeResponse handle it
+	if (wantsRead()) {
+		parseRequest();
 	}
-
 	return true;
 }
 
+void Connection::processRequest() {
+	// Handle request
+	HTTP::RequestHandler handler(_server);
+	HTTP::Response response = handler.handle(_request);
+
+	// Persistent unless the client, the limits or a graceful stop say otherwise
+	++_requestsServed;
+	_keepAlive = _keepAliveAllowed
+	          && _request.keepAlive()
+	          && _server->getKeepaliveTimeout() > 0
+	          && _requestsServed < _server->getKeepaliveRequests();
+	response.setKeepAlive(_keepAlive);
+	queueResponse(response);
+	_state = WRITING_RESPONSE;
+
+	// Pipelined: the next buffered request is answered before anything is
+	// written, so all the responses leave in one write
+	if (wantsRead()) {
+		parseRequest();
+	}
+	// Don't set _shouldClose here - let writeResponse handle it
+}
+
 bool Connection::writeResponse() {
-	if (_responseBuffer.empty() || _responseOffset >= _responseBuffer.size()) {
-		// Nothing to write or already written everything
-		_shouldClose = true;
+	if (_output.empty()) {
 		return true;
 	}
 
-	const char* data = _responseBuffer.c_str() + _responseOffset;
-	size_t remaining = _responseBuffer.size() - _responseOffset;
-
-	ssize_t bytesWritten = send(_fd, data, remaining, 0);
+	// As much of the queue as one scatter write takes
+	size_t queued = _output.messages();
+	ssize_t bytesWritten = _output.flush(_fd);
 
 	if (bytesWritten < 0) {
+		if (_output.failed()) {
+			return false;
+		}
 		// Non-blocking socket: would block means socket not ready
 		// Don't check errno - just return success and try again later
 		return true; // Not an error for non-blocking sockets
 	}
 
-	_responseOffset += bytesWritten;
 	updateActivity();
 
 	Logger::debug << "Wrote " << bytesWritten << " bytes to connection (fd: " << _fd
-	              << "), total: " << _responseOffset << "/" << _responseBuffer.size()
-	              << " bytes" << std::endl;
+	              << "), " << _output.messages() << " response(s) queued" << std::endl;
 
-	// Check if response is complete
-	if (_responseOffset >= _responseBuffer.size()) {
+	for (size_t done = queued - _output.messages(); done > 0; --done) {
 		Logger::info << "Response complete (fd: " << _fd << ")" << std::endl;
-		_shouldClose = true;
-		_state = CLOSING;
+	}
+
+	if (_state != WRITING_RESPONSE) {
+		return true;
+	}
+
+	if (_output.empty()) {
+		if (_keepAlive) {
+			nextRequest();
+		} else {
+			_shouldClose = true;
+			_state = CLOSING;
+		}
+	} else if (wantsRead()) {
+		// Room in the queue again for requests held back by the limit
+		parseRequest();
 	}
 
 	return true;
 }
 
+bool Connection::hasPendingOutput() const {
+	return !_output.empty();
+}
+
+bool Connection::wantsRead() const {
+	if (_state == READING_REQUEST) {
+		return true;
+	}
+	return _state == WRITING_RESPONSE && _keepAlive && _output.messages() < MAX_QUEUED_RESPONSES;
+}
+
+// Keep-alive
+void Connection::disableKeepAlive() {
+	_keepAliveAllowed = false;
+	_keepAlive = false;
+}
+
+bool Connection::isIdle() const {
+	return _state == READING_REQUEST && _requestBuffer.empty();
+}
+
 // State management
 Connection::State Connection::getState() const {
 	return _state;
@@ -169,7 +222,7 @@ int Connection::getClientPort() const {
 	return _clientPort;
 }
 
-time_t Connection::getLastActivity() const {
+unsigned long long Connection::getLastActivity() const {
 	return _lastActivity;
 }
 
@@ -177,11 +230,6 @@ bool Connection::shouldClose() const {
 	return _shouldClose;
 }
 
-// Timeout check
-bool Connection::isTimedOut(time_t timeout) const {
-	return (std::time(NULL) - _lastActivity) > timeout;
-}
-
 // Buffer management
 const std::string& Connection::getRequestBuffer() const {
 	return _requestBuffer;
@@ -193,5 +241,112 @@ void Connection::clearRequestBuffer() {
 
 // Helper methods
 void Connection::updateActivity() {
-	_lastActivity = std::time(NULL);
+	// Uses the loop's cached clock, no time syscall per event
+	_lastActivity = _timers->now();
+	_idleTimer.kind = TIMER_IDLE;
+	_timers->schedule(&_idleTimer, IDLE_TIMEOUT * 1000ULL);
+}
+
+// Move the first complete buffered request into _request (PROCESSING),
+// or queue a 400 if it does not parse
+bool Connection::parseRequest() {
+	// Resumes where the previous read stopped
+	HTTP::RequestParser::Result result = _parser.feed(_requestBuffer);
+	if (result == HTTP::RequestParser::NEED_MORE) {
+		// The header timeout runs from the first byte of every request until
+		// its head is complete; a slow body is left to the idle timeout
+		if (_parser.headComplete()) {
+			_timers->cancel(&_headerTimer);
+			if (_parser.expectsContinue() && !_expectAnswered) {
+				return answerExpectation();
+			}
+		} else if (_requestBuffer.size() > _parser.start() && !_headerTimer.isArmed()) {
+			_timers->schedule(&_headerTimer, _server->getClientHeaderTimeout() * 1000ULL);
+		}
+		return false;
+	}
+
+	Logger::debug << "Complete request received (fd: " << _fd << ")" << std::endl;
+	_state = PROCESSING;
+	_timers->cancel(&_headerTimer);
+	_expectAnswered = false;
+
+	if (result == HTTP::RequestParser::FAILED) {
+		Logger::error << "Failed to parse HTTP request" << std::endl;
+		rejectRequest(HTTP::Response::errorResponse(_parser.errorStatus(), ""));
+		return true;
+	}
+
+	_request.load(_parser, _requestBuffer);
+
+	// The next request starts right after this one; the buffer is emptied
+	// once everything in it is consumed (and compacted before reads)
+	_parser.reset(_parser.end());
+	if (_parser.start() == _requestBuffer.size()) {
+		_requestBuffer.clear();
+		_parser.reset();
+	}
+
+	// Debug: print request
+	if (Logger::debug << "") {
+		_request.print();
+	}
+	return true;
+}
+
+// Expect: 100-continue, once the head is in: the client waits for 100
+// Continue before sending the body. A request the handler would refuse
+// anyway gets its final response instead, and the body is never sent.
+bool Connection::answerExpectation() {
+	_expectAnswered = true;
+	_request.loadHead(_parser, _requestBuffer);
+
+	HTTP::RequestHandler handler(_server);
+	HTTP::Response rejection;
+	if (handler.checkHead(_request, rejection)) {
+		Logger::debug << "100 Continue (fd: " << _fd << ")" << std::endl;
+		static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+		_output.addText(CONTINUE, sizeof(CONTINUE) - 1);
+		_output.endMessage();
+		return false;
+	}
+
+	Logger::info << "Refused " << _request.getMethod() << " " << _request.getPath()
+	             << " before its body (" << rejection.getStatusCode() << ")" << std::endl;
+	_expectAnswered = false;
+	_timers->cancel(&_headerTimer);
+	rejectRequest(rejection);
+	return true;
+}
+
+// Final response to a request that is not read to its end: the rest of
+// it cannot be told apart from a next request, so the connection closes
+void Connection::rejectRequest(const HTTP::Response& response) {
+	HTTP::Response closing = response;
+	closing.setKeepAlive(false);
+	queueResponse(closing);
+	_state = WRITING_RESPONSE;
+	_keepAlive = false;
+	_requestBuffer.clear();
+	_parser.reset();
+}
+
+// Append a response to the write queue: the head is serialized in place,
+// the body is moved over from the response
+void Connection::queueResponse(HTTP::Response& response) {
+	response.serialize(_output);
+}
+
+// Every response sent on a persistent connection: wait for the next
+// request, which may already be (partly) buffered
+void Connection::nextRequest() {
+	_state = READING_REQUEST;
+
+	if (_requestBuffer.empty()) {
+		_idleTimer.kind = TIMER_KEEPALIVE;
+		_timers->schedule(&_idleTimer, _server->getKeepaliveTimeout() * 1000ULL);
+		return;
+	}
+
+	parseRequest();
 }
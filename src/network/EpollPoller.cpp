@@ -0,0 +1,153 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollPoller.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:21:30 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:21:30 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * EpollPoller.cpp
+ * Implementation of the epoll backend
+ */
+#include "includes/network/EpollPoller.hpp"
+
+#ifdef WEBSERV_HAVE_EPOLL
+
+#include "includes/utils/Logger.hpp"
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+EpollPoller::EpollPoller()
+	: _epollFd(epoll_create1(EPOLL_CLOEXEC))
+	, _events(MIN_EVENTS) {
+	if (_epollFd < 0) {
+		Logger::error << "epoll_create failed: " << std::strerror(errno) << std::endl;
+	}
+}
+
+EpollPoller::~EpollPoller() {
+	if (_epollFd >= 0) {
+		::close(_epollFd);
+	}
+}
+
+bool EpollPoller::isValid() const {
+	return _epollFd >= 0;
+}
+
+bool EpollPoller::add(int fd, short events) {
+	if (fd < 0) {
+		return false;
+	}
+	if (isRegistered(fd)) {
+		return modify(fd, events);
+	}
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpoll(events);
+	ev.data.fd = fd;
+
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		Logger::error << "epoll_ctl(ADD) failed (fd: " << fd << "): "
+		              << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	setInterest(fd, events);
+	return true;
+}
+
+bool EpollPoller::modify(int fd, short events) {
+	if (!isRegistered(fd)) {
+		return false;
+	}
+
+	// Skip the syscall when the interest did not change
+	if (_interest[fd] == events) {
+		return true;
+	}
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpoll(events);
+	ev.data.fd = fd;
+
+	if (epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+		Logger::error << "epoll_ctl(MOD) failed (fd: " << fd << "): "
+		              << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	setInterest(fd, events);
+	return true;
+}
+
+void EpollPoller::remove(int fd) {
+	if (!isRegistered(fd)) {
+		return;
+	}
+
+	// Kernels before 2.6.9 require a non-NULL event for EPOLL_CTL_DEL
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, &ev);
+	clearInterest(fd);
+}
+
+int EpollPoller::wait(std::vector<Event>& ready, int timeoutMs) {
+	ready.clear();
+
+	// Grow the output buffer with the number of watched fds
+	if (_events.size() < MAX_EVENTS && _events.size() < size()) {
+		size_t wanted = size() < MAX_EVENTS ? size() : MAX_EVENTS;
+		_events.resize(wanted);
+	}
+
+	int result = epoll_wait(_epollFd, &_events[0], static_cast<int>(_events.size()), timeoutMs);
+	if (result <= 0) {
+		return result;
+	}
+
+	ready.reserve(result);
+	for (int i = 0; i < result; ++i) {
+		ready.push_back(readyEvent(_events[i].data.fd, fromEpoll(_events[i].events)));
+	}
+
+	return result;
+}
+
+const char* EpollPoller::getName() const {
+	return "epoll";
+}
+
+// Translate poll() flags to epoll flags and back
+unsigned int EpollPoller::toEpoll(short events) {
+	unsigned int result = 0;
+	if (events & POLLIN)
+		result |= EPOLLIN;
+	if (events & POLLOUT)
+		result |= EPOLLOUT;
+	return result;
+}
+
+short EpollPoller::fromEpoll(unsigned int events) {
+	short result = 0;
+	if (events & EPOLLIN)
+		result |= POLLIN;
+	if (events & EPOLLOUT)
+		result |= POLLOUT;
+	if (events & EPOLLERR)
+		result |= POLLERR;
+	if (events & EPOLLHUP)
+		result |= POLLHUP;
+	return result;
+}
+
+#endif // WEBSERV_HAVE_EPOLL
@@ -0,0 +1,639 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoUringPoller.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:02:48 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 16:02:48 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * IoUringPoller.cpp
+ * Implementation of the io_uring backend
+ */
+#include "includes/network/IoUringPoller.hpp"
+
+#ifdef WEBSERV_HAVE_IO_URING
+
+#include "includes/utils/Logger.hpp"
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <endian.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+IoUringPoller::IoUringPoller()
+	: _ringFd(-1)
+	, _sqEntries(0)
+	, _sqRing(MAP_FAILED)
+	, _sqRingSize(0)
+	, _sqHead(NULL)
+	, _sqTail(NULL)
+	, _sqMask(NULL)
+	, _sqArray(NULL)
+	, _sqes(NULL)
+	, _sqesSize(0)
+	, _pending(0)
+	, _cqRing(MAP_FAILED)
+	, _cqRingSize(0)
+	, _cqHead(NULL)
+	, _cqTail(NULL)
+	, _cqMask(NULL)
+	, _cqes(NULL)
+	, _bufRing(NULL)
+	, _bufRingTail(NULL)
+	, _buffers(NULL)
+	, _bufTail(0)
+	, _multishotRecv(true) {
+	if (!(setup() && setupBuffers()) && _ringFd >= 0) {
+		::close(_ringFd);
+		_ringFd = -1;
+	}
+}
+
+IoUringPoller::~IoUringPoller() {
+	// Closing the ring unregisters the buffer ring before it is unmapped
+	if (_ringFd >= 0) {
+		::close(_ringFd);
+	}
+	if (_buffers != NULL) {
+		munmap(_buffers, BUFFER_COUNT * BUFFER_SIZE);
+	}
+	if (_bufRing != NULL) {
+		munmap(_bufRing, BUFFER_COUNT * sizeof(struct io_uring_buf));
+	}
+	if (_sqes != NULL) {
+		munmap(_sqes, _sqesSize);
+	}
+	if (_cqRing != MAP_FAILED && _cqRing != _sqRing) {
+		munmap(_cqRing, _cqRingSize);
+	}
+	if (_sqRing != MAP_FAILED) {
+		munmap(_sqRing, _sqRingSize);
+	}
+}
+
+bool IoUringPoller::isValid() const {
+	return _ringFd >= 0;
+}
+
+// Create the ring and map the shared submission/completion queues
+bool IoUringPoller::setup() {
+	struct io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	// Completions are only needed when the loop enters the ring: no IPI to
+	// interrupt the thread for each one (Linux 5.19, like the buffer ring)
+	params.flags = IORING_SETUP_COOP_TASKRUN;
+
+	_ringFd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+	if (_ringFd < 0) {
+		Logger::debug << "io_uring_setup failed: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	// Timed waits (IORING_ENTER_EXT_ARG) need Linux 5.11
+	if (!(params.features & IORING_FEAT_EXT_ARG)) {
+		Logger::debug << "io_uring lacks IORING_FEAT_EXT_ARG (kernel too old)" << std::endl;
+		return false;
+	}
+
+	_sqEntries = params.sq_entries;
+	_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+	bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMmap && _cqRingSize > _sqRingSize) {
+		_sqRingSize = _cqRingSize;
+	}
+
+	_sqRing = mmap(NULL, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	               _ringFd, IORING_OFF_SQ_RING);
+	if (_sqRing == MAP_FAILED) {
+		return false;
+	}
+
+	if (singleMmap) {
+		_cqRing = _sqRing;
+	} else {
+		_cqRing = mmap(NULL, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		               _ringFd, IORING_OFF_CQ_RING);
+		if (_cqRing == MAP_FAILED) {
+			return false;
+		}
+	}
+
+	_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	void* sqes = mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	                  _ringFd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		return false;
+	}
+	_sqes = static_cast<struct io_uring_sqe*>(sqes);
+
+	char* sq = static_cast<char*>(_sqRing);
+	_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+	char* cq = static_cast<char*>(_cqRing);
+	_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	_cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+// Next free SQE (flushes the ring to the kernel when it is full)
+struct io_uring_sqe* IoUringPoller::nextSqe() {
+	unsigned tail = *_sqTail;
+	unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+
+	if (tail - head >= _sqEntries) {
+		enter(0, 0);
+		head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+		if (tail - head >= _sqEntries) {
+			return NULL;
+		}
+	}
+
+	unsigned index = tail & *_sqMask;
+	struct io_uring_sqe* sqe = &_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	_sqArray[index] = index;
+
+	// Published now, consumed by the kernel on the next io_uring_enter()
+	__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+	++_pending;
+	return sqe;
+}
+
+// Submit queued SQEs and optionally wait for completions
+int IoUringPoller::enter(unsigned minComplete, int timeoutMs) {
+	unsigned flags = 0;
+	void* arg = NULL;
+	size_t argSize = 0;
+
+	struct __kernel_timespec ts;
+	struct io_uring_getevents_arg getevents;
+
+	if (minComplete > 0) {
+		flags |= IORING_ENTER_GETEVENTS;
+		if (timeoutMs >= 0) {
+			ts.tv_sec = timeoutMs / 1000;
+			ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+			std::memset(&getevents, 0, sizeof(getevents));
+			getevents.ts = reinterpret_cast<unsigned long long>(&ts);
+			flags |= IORING_ENTER_EXT_ARG;
+			arg = &getevents;
+			argSize = sizeof(getevents);
+		}
+	}
+
+	int result = static_cast<int>(syscall(__NR_io_uring_enter, _ringFd, _pending,
+	                                      minComplete, flags, arg, argSize));
+	if (result >= 0) {
+		unsigned submitted = static_cast<unsigned>(result);
+		_pending = (submitted >= _pending) ? 0 : _pending - submitted;
+	}
+	return result;
+}
+
+// Register the provided buffer ring multishot recv reads into
+// (IORING_REGISTER_PBUF_RING and multishot accept need Linux 5.19)
+bool IoUringPoller::setupBuffers() {
+	void* ring = mmap(NULL, BUFFER_COUNT * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+	                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring == MAP_FAILED) {
+		return false;
+	}
+	// Indexed by hand: in C++ the uapi bufs[] member does not start at offset 0.
+	// The kernel reads the tail from the reserved field of the first entry
+	_bufRing = static_cast<struct io_uring_buf*>(ring);
+	_bufRingTail = &_bufRing[0].resv;
+
+	void* buffers = mmap(NULL, BUFFER_COUNT * BUFFER_SIZE, PROT_READ | PROT_WRITE,
+	                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (buffers == MAP_FAILED) {
+		return false;
+	}
+	_buffers = static_cast<char*>(buffers);
+
+	struct io_uring_buf_reg reg;
+	std::memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = reinterpret_cast<unsigned long long>(_bufRing);
+	reg.ring_entries = BUFFER_COUNT;
+	reg.bgid = BUFFER_GROUP;
+	if (syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+		Logger::debug << "io_uring buffer ring registration failed: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	for (unsigned bid = 0; bid < BUFFER_COUNT; ++bid) {
+		recycle(static_cast<unsigned short>(bid));
+	}
+	__atomic_store_n(_bufRingTail, _bufTail, __ATOMIC_RELEASE);
+	return true;
+}
+
+// Give a buffer back to the kernel (published by the caller)
+void IoUringPoller::recycle(unsigned short bid) {
+	struct io_uring_buf* buf = &_bufRing[_bufTail & (BUFFER_COUNT - 1)];
+	buf->addr = reinterpret_cast<unsigned long long>(_buffers + static_cast<size_t>(bid) * BUFFER_SIZE);
+	buf->len = BUFFER_SIZE;
+	buf->bid = bid;
+	++_bufTail;
+}
+
+// user_data: op (2 bits), epoch (14), sequence (16), fd (32)
+unsigned long long IoUringPoller::tag(Op op, int fd, unsigned epoch, unsigned seq) {
+	return (static_cast<unsigned long long>(op) << 62)
+	     | (static_cast<unsigned long long>(epoch & 0x3fff) << 48)
+	     | (static_cast<unsigned long long>(seq & 0xffff) << 32)
+	     | static_cast<unsigned>(fd);
+}
+
+// Start watching fd (a new socket: completions of the old one become stale)
+void IoUringPoller::track(int fd, Mode mode) {
+	if (static_cast<size_t>(fd) >= _fds.size()) {
+		FdState empty;
+		std::memset(&empty, 0, sizeof(empty));
+		_fds.resize(fd + 1, empty);
+	}
+	FdState& state = _fds[fd];
+	++state.epoch;
+	state.mode = static_cast<unsigned char>(mode);
+	state.pollArmed = false;
+	state.opArmed = false;
+	state.eof = false;
+}
+
+// Queue whatever requests the fd's interest needs and are not in flight
+void IoUringPoller::arm(int fd) {
+	FdState& state = _fds[fd];
+	short events = _interest[fd];
+
+	switch (state.mode) {
+		case MODE_LISTENER:
+			if (!state.opArmed) {
+				queueAccept(fd);
+			}
+			break;
+		case MODE_STREAM:
+			if ((events & POLLIN) && !state.opArmed && !state.eof) {
+				queueRecv(fd);
+			}
+			if ((events & POLLOUT) && !state.pollArmed) {
+				queuePoll(fd, POLLOUT);
+			}
+			break;
+		default:
+			if (!state.pollArmed) {
+				queuePoll(fd, events);
+			}
+			break;
+	}
+}
+
+// Queue a one-shot poll
+void IoUringPoller::queuePoll(int fd, short events) {
+	struct io_uring_sqe* sqe = nextSqe();
+	if (sqe == NULL) {
+		// Ring full even after a flush: retry on the next wait
+		_rearm.push_back(fd);
+		return;
+	}
+
+	FdState& state = _fds[fd];
+	unsigned mask = static_cast<unsigned short>(events);
+#if __BYTE_ORDER == __BIG_ENDIAN
+	mask = (mask << 16) | (mask >> 16);  // poll32_events is word-swapped on BE
+#endif
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = mask;
+	sqe->user_data = tag(OP_POLL, fd, state.epoch, ++state.pollSeq);
+	state.pollArmed = true;
+}
+
+// Queue a multishot accept (one completion per accepted socket)
+void IoUringPoller::queueAccept(int fd) {
+	struct io_uring_sqe* sqe = nextSqe();
+	if (sqe == NULL) {
+		_rearm.push_back(fd);
+		return;
+	}
+
+	FdState& state = _fds[fd];
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+	sqe->user_data = tag(OP_ACCEPT, fd, state.epoch, ++state.opSeq);
+	state.opArmed = true;
+}
+
+// Queue a multishot recv into the provided buffers (one completion per read)
+void IoUringPoller::queueRecv(int fd) {
+	struct io_uring_sqe* sqe = nextSqe();
+	if (sqe == NULL) {
+		_rearm.push_back(fd);
+		return;
+	}
+
+	FdState& state = _fds[fd];
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = BUFFER_GROUP;
+	sqe->user_data = tag(OP_RECV, fd, state.epoch, ++state.opSeq);
+	state.opArmed = true;
+}
+
+// Queue the cancellation of an in-flight request
+void IoUringPoller::queueCancel(unsigned long long target) {
+	struct io_uring_sqe* sqe = nextSqe();
+	if (sqe == NULL) {
+		return; // Its completions carry an old tag and are dropped
+	}
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = target;
+	sqe->user_data = IGNORED;
+}
+
+void IoUringPoller::cancelPoll(int fd) {
+	FdState& state = _fds[fd];
+	if (state.pollArmed) {
+		queueCancel(tag(OP_POLL, fd, state.epoch, state.pollSeq));
+		state.pollArmed = false;
+	}
+}
+
+void IoUringPoller::cancelOp(int fd) {
+	FdState& state = _fds[fd];
+	if (state.opArmed) {
+		Op op = (state.mode == MODE_LISTENER) ? OP_ACCEPT : OP_RECV;
+		queueCancel(tag(op, fd, state.epoch, state.opSeq));
+		state.opArmed = false;
+	}
+}
+
+bool IoUringPoller::add(int fd, short events) {
+	if (fd < 0) {
+		return false;
+	}
+	if (isRegistered(fd)) {
+		return modify(fd, events);
+	}
+
+	track(fd, MODE_POLL);
+	setInterest(fd, events);
+	arm(fd);
+	return true;
+}
+
+bool IoUringPoller::addListener(int fd) {
+	if (fd < 0 || isRegistered(fd)) {
+		return false;
+	}
+
+	track(fd, MODE_LISTENER);
+	setInterest(fd, POLLIN);
+	arm(fd);
+	return true;
+}
+
+bool IoUringPoller::addStream(int fd, short events) {
+	if (fd < 0) {
+		return false;
+	}
+	if (isRegistered(fd)) {
+		return modify(fd, events);
+	}
+
+	track(fd, _multishotRecv ? MODE_STREAM : MODE_POLL);
+	setInterest(fd, events);
+	arm(fd);
+	return true;
+}
+
+bool IoUringPoller::modify(int fd, short events) {
+	if (!isRegistered(fd)) {
+		return false;
+	}
+
+	// Skip the request when the interest did not change
+	if (_interest[fd] == events) {
+		return true;
+	}
+
+	setInterest(fd, events);
+
+	FdState& state = _fds[fd];
+	if (state.mode == MODE_STREAM) {
+		// Stop reading while the connection does not want more input
+		// (bytes already completed are still delivered)
+		if (!(events & POLLIN)) {
+			cancelOp(fd);
+		}
+		if (!(events & POLLOUT)) {
+			cancelPoll(fd);
+		}
+		arm(fd);
+		return true;
+	}
+
+	// A fired fd waits in _rearm and picks up the new mask there
+	if (state.pollArmed) {
+		cancelPoll(fd);
+		queuePoll(fd, events);
+	}
+	return true;
+}
+
+void IoUringPoller::remove(int fd) {
+	if (!isRegistered(fd)) {
+		return;
+	}
+
+	cancelPoll(fd);
+	cancelOp(fd);
+	++_fds[fd].epoch; // Completions still in flight become stale
+	clearInterest(fd);
+}
+
+int IoUringPoller::wait(std::vector<Event>& ready, int timeoutMs) {
+	ready.clear();
+
+	// Buffers handed out last time were consumed by the caller
+	if (!_spent.empty()) {
+		for (size_t i = 0; i < _spent.size(); ++i) {
+			recycle(_spent[i]);
+		}
+		__atomic_store_n(_bufRingTail, _bufTail, __ATOMIC_RELEASE);
+		_spent.clear();
+	}
+
+	// Re-arm what ended last time, in the same batch as the wait
+	std::vector<int> rearm;
+	rearm.swap(_rearm);
+	for (size_t i = 0; i < rearm.size(); ++i) {
+		if (isRegistered(rearm[i])) {
+			arm(rearm[i]);
+		}
+	}
+
+	// Completions already waiting: only submit
+	bool haveCompletions = *_cqHead != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+	unsigned minComplete = (haveCompletions || timeoutMs == 0) ? 0 : 1;
+
+	if (enter(minComplete, timeoutMs) < 0) {
+		if (errno != ETIME && errno != EBUSY && errno != EAGAIN) {
+			return -1;
+		}
+		// ETIME: timed out; EBUSY/EAGAIN: completion ring full, reap first
+	}
+
+	reap(ready);
+	return static_cast<int>(ready.size());
+}
+
+// Turn the completions of live sockets into events
+void IoUringPoller::reap(std::vector<Event>& ready) {
+	unsigned head = *_cqHead;
+	unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; ++head) {
+		const struct io_uring_cqe* cqe = &_cqes[head & *_cqMask];
+		unsigned long long data = cqe->user_data;
+		if (data == IGNORED) {
+			continue;
+		}
+
+		// A filled buffer goes back to the ring on the next wait, used or not
+		if (cqe->flags & IORING_CQE_F_BUFFER) {
+			_spent.push_back(static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+		}
+
+		Op op = static_cast<Op>(data >> 62);
+		int fd = static_cast<int>(data & 0xffffffffULL);
+		unsigned epoch = static_cast<unsigned>(data >> 48) & 0x3fff;
+		unsigned seq = static_cast<unsigned>(data >> 32) & 0xffff;
+
+		if (!isRegistered(fd) || (_fds[fd].epoch & 0x3fff) != epoch) {
+			// Removed since: nobody will own a socket it accepted
+			if (op == OP_ACCEPT && cqe->res >= 0) {
+				::close(cqe->res);
+			}
+			continue;
+		}
+
+		if (op == OP_ACCEPT) {
+			completeAccept(fd, seq, cqe, ready);
+		} else if (op == OP_RECV) {
+			completeRecv(fd, seq, cqe, ready);
+		} else {
+			completePoll(fd, seq, cqe, ready);
+		}
+	}
+
+	__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+}
+
+void IoUringPoller::completePoll(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready) {
+	FdState& state = _fds[fd];
+	if ((state.pollSeq & 0xffff) != seq) {
+		return; // Modified since this poll was queued
+	}
+
+	state.pollArmed = false;
+	_rearm.push_back(fd);
+	ready.push_back(readyEvent(fd, (cqe->res < 0) ? POLLERR : static_cast<short>(cqe->res)));
+}
+
+void IoUringPoller::completeAccept(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready) {
+	FdState& state = _fds[fd];
+
+	// Without IORING_CQE_F_MORE the accept ended (error or overflow)
+	if (!(cqe->flags & IORING_CQE_F_MORE) && (state.opSeq & 0xffff) == seq) {
+		state.opArmed = false;
+		_rearm.push_back(fd);
+	}
+
+	if (cqe->res < 0) {
+		Logger::debug << "io_uring accept failed on fd " << fd << ": " << std::strerror(-cqe->res) << std::endl;
+		return;
+	}
+
+	Event event = readyEvent(fd, POLLIN);
+	event.type = EVENT_ACCEPTED;
+	event.result = cqe->res;
+	ready.push_back(event);
+}
+
+void IoUringPoller::completeRecv(int fd, unsigned seq, const struct io_uring_cqe* cqe, std::vector<Event>& ready) {
+	FdState& state = _fds[fd];
+	int res = cqe->res;
+	bool current = (state.opSeq & 0xffff) == seq;
+
+	if (!(cqe->flags & IORING_CQE_F_MORE) && current) {
+		state.opArmed = false;
+		// Out of buffers (they return on the next wait) or stopped early
+		if (res > 0 || res == -ENOBUFS) {
+			_rearm.push_back(fd);
+		}
+	}
+
+	// Bytes of an older recv on the same socket are delivered as well
+	if (res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+		unsigned short bid = static_cast<unsigned short>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+		Event event = readyEvent(fd, POLLIN);
+		event.type = EVENT_RECEIVED;
+		event.result = res;
+		event.data = _buffers + static_cast<size_t>(bid) * BUFFER_SIZE;
+		ready.push_back(event);
+		return;
+	}
+
+	if (res == 0) {
+		state.eof = true;
+		Event event = readyEvent(fd, POLLIN);
+		event.type = EVENT_RECEIVED;
+		ready.push_back(event);
+		return;
+	}
+
+	if (res == -ENOBUFS || res == -ECANCELED) {
+		return;
+	}
+
+	// Linux 5.19 has buffer rings but no multishot recv: poll instead
+	if (res == -EINVAL) {
+		if (_multishotRecv) {
+			Logger::debug << "io_uring multishot recv unsupported, polling connections instead" << std::endl;
+			_multishotRecv = false;
+		}
+		cancelPoll(fd);
+		state.mode = MODE_POLL;
+		state.opArmed = false;
+		_rearm.push_back(fd);
+		return;
+	}
+
+	ready.push_back(readyEvent(fd, POLLERR));
+}
+
+const char* IoUringPoller::getName() const {
+	return "io_uring";
+}
+
+#endif // WEBSERV_HAVE_IO_URING
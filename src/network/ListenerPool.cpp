@@ -0,0 +1,223 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ListenerPool.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 18:02:11 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 18:02:11 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ListenerPool.cpp
+ * Implementation of the listening socket pool
+ */
+#include "includes/network/ListenerPool.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cstdlib>
+#include <set>
+#include <sstream>
+
+const char* const ListenerPool::ENV_NAME = "WEBSERV_LISTENERS";
+
+// Constructor
+ListenerPool::ListenerPool() {}
+
+// Destructor
+ListenerPool::~ListenerPool() {
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		delete _entries[i].socket;
+	}
+	_entries.clear();
+}
+
+// Adopt the sockets passed by the previous binary
+void ListenerPool::inherit(const char* value) {
+	if (value == NULL) {
+		return;
+	}
+
+	std::istringstream list(value);
+	std::string item;
+	while (std::getline(list, item, ';')) {
+		// fd:slot:host:port
+		size_t a = item.find(':');
+		size_t b = (a == std::string::npos) ? a : item.find(':', a + 1);
+		size_t c = item.rfind(':');
+		if (b == std::string::npos || c <= b) {
+			Logger::warning << "Ignoring malformed inherited listener: " << item << std::endl;
+			continue;
+		}
+
+		int fd = std::atoi(item.substr(0, a).c_str());
+		if (fd < 0 || fcntl(fd, F_GETFD) < 0) {
+			Logger::warning << "Inherited listener fd " << fd << " is not open" << std::endl;
+			continue;
+		}
+
+		Entry entry;
+		entry.slot = static_cast<size_t>(std::atoi(item.substr(a + 1, b - a - 1).c_str()));
+		entry.host = item.substr(b + 1, c - b - 1);
+		entry.port = std::atoi(item.substr(c + 1).c_str());
+		entry.backlog = -1;
+		entry.socket = new Socket(fd, entry.host, entry.port);
+		entry.socket->setCloseOnExec(true);
+		_entries.push_back(entry);
+
+		Logger::info << "Inherited listener " << entry.host << ":" << entry.port
+		             << " (slot " << entry.slot << ", fd: " << fd << ")" << std::endl;
+	}
+}
+
+// Make the pool match the configuration
+bool ListenerPool::sync(const Config& config, size_t slots) {
+	const std::vector<Server>& servers = config.getServers();
+	std::vector<Entry> next;
+	std::vector<bool> kept(_entries.size(), false);
+	std::set<std::string> addresses;
+
+	for (size_t i = 0; i < servers.size(); ++i) {
+		const std::string& host = servers[i].getHost();
+		const std::vector<int>& ports = servers[i].getPorts();
+
+		for (size_t j = 0; j < ports.size(); ++j) {
+			int port = ports[j];
+
+			std::ostringstream key;
+			key << host << ":" << port;
+			if (!addresses.insert(key.str()).second) {
+				continue; // Address already handled for an earlier server
+			}
+
+			// The default (first) server of the address sets the backlog
+			int backlog = config.getDefaultServer(host, port)->getListenBacklog();
+			bool opened = false;
+
+			for (size_t slot = 0; slot < slots; ++slot) {
+				Entry entry;
+				entry.host = host;
+				entry.port = port;
+				entry.slot = slot;
+				entry.backlog = backlog;
+
+				int index = find(host, port, slot);
+				if (index >= 0) {
+					// Same address: keep the socket and its accept queue
+					entry.socket = _entries[index].socket;
+					if (_entries[index].backlog != backlog) {
+						entry.socket->listen(backlog);
+					}
+					kept[index] = true;
+				} else {
+					entry.socket = open(host, port, backlog);
+					if (!entry.socket) {
+						Logger::error << "Failed to create listening socket for " << key.str() << std::endl;
+						// Roll back: close what this call opened, keep the old pool
+						for (size_t k = 0; k < next.size(); ++k) {
+							if (find(next[k].host, next[k].port, next[k].slot) < 0) {
+								delete next[k].socket;
+							}
+						}
+						return false;
+					}
+					opened = opened || slot == 0;
+				}
+				next.push_back(entry);
+			}
+
+			if (opened) { // New address (not just more slots)
+				Logger::success << "Listening on " << key.str() << std::endl;
+			}
+		}
+	}
+
+	// Addresses (or slots) no longer configured
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		if (!kept[i]) {
+			if (_entries[i].slot == 0) {
+				Logger::info << "Closing listener " << _entries[i].host << ":" << _entries[i].port << std::endl;
+			}
+			delete _entries[i].socket;
+		}
+	}
+	_entries = next;
+	return true;
+}
+
+// Keep only the sockets of one slot (in a forked worker)
+void ListenerPool::retain(size_t slot) {
+	std::vector<Entry> mine;
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		if (_entries[i].slot == slot) {
+			mine.push_back(_entries[i]);
+		} else {
+			delete _entries[i].socket;
+		}
+	}
+	_entries = mine;
+}
+
+std::vector<Socket*> ListenerPool::forSlot(size_t slot) const {
+	std::vector<Socket*> sockets;
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		if (_entries[i].slot == slot) {
+			sockets.push_back(_entries[i].socket);
+		}
+	}
+	return sockets;
+}
+
+// fd:slot:host:port;...
+std::string ListenerPool::serialize() const {
+	std::ostringstream out;
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		out << _entries[i].socket->getFd() << ":" << _entries[i].slot << ":"
+		    << _entries[i].host << ":" << _entries[i].port << ";";
+	}
+	return out.str();
+}
+
+void ListenerPool::keepAcrossExec() const {
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		_entries[i].socket->setCloseOnExec(false);
+	}
+}
+
+int ListenerPool::find(const std::string& host, int port, size_t slot) const {
+	for (size_t i = 0; i < _entries.size(); ++i) {
+		if (_entries[i].port == port && _entries[i].slot == slot && _entries[i].host == host) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+// Create, configure, bind and listen
+Socket* ListenerPool::open(const std::string& host, int port, int backlog) {
+	Socket* sock = new Socket();
+
+	if (!sock->create()) {
+		delete sock;
+		return NULL;
+	}
+
+	// Configure socket
+	if (!sock->setReuseAddr()) {
+		Logger::warning << "Failed to set SO_REUSEADDR" << std::endl;
+	}
+
+	sock->setReusePort(); // May not be available on all systems
+
+	// CGI children must not inherit listeners
+	if (!sock->setCloseOnExec(true)
+	    || !sock->bind(host, port)
+	    || !sock->setNonBlocking()
+	    || !sock->listen(backlog)) {
+		delete sock;
+		return NULL;
+	}
+
+	return sock;
+}
@@ -0,0 +1,322 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 06:10:41 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 06:10:41 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * OutputQueue.cpp
+ * Implementation of the segmented output queue
+ */
+#include "includes/network/OutputQueue.hpp"
+#include "includes/utils/Logger.hpp"
+#include <climits>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+# define IOV_MAX 16     // _XOPEN_IOV_MAX, the least POSIX allows
+#endif
+
+namespace {
+	const int MAX_IOV = IOV_MAX;
+
+	// Hold partial frames while a head and the file after it are handed
+	// over, so they leave in full packets (not a TCP socket: ignored)
+	void setCork(int fd, bool on) {
+		int value = on ? 1 : 0;
+		setsockopt(fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value));
+	}
+}
+
+OutputQueue::OutputQueue()
+	: _cursor(0)
+	, _textStart(0)
+	, _textMark(0)
+	, _messages(0)
+	, _failed(false) {
+}
+
+OutputQueue::~OutputQueue() {
+	clear();
+}
+
+std::string& OutputQueue::beginText() {
+	_textMark = _text.size();
+	return _text;
+}
+
+void OutputQueue::endText() {
+	size_t length = _text.size() - _textMark;
+	if (length > 0) {
+		push(SEGMENT_TEXT, length).offset = _textMark;
+	}
+}
+
+void OutputQueue::addText(const char* data, size_t length) {
+	beginText().append(data, length);
+	endText();
+}
+
+void OutputQueue::addString(std::string& data) {
+	if (!data.empty()) {
+		push(SEGMENT_STRING, data.size()).data.swap(data);
+	}
+}
+
+void OutputQueue::addFile(int fd, off_t offset, size_t length, bool zeroCopy) {
+	if (fd < 0) {
+		fileFailed(fd);     // dup() ran out of descriptors
+		return;
+	}
+	if (length == 0) {
+		close(fd);
+		return;
+	}
+	Segment& added = push(SEGMENT_FILE, length);
+	added.fd = fd;
+	added.fileOffset = offset;
+	added.zeroCopy = zeroCopy;
+}
+
+void OutputQueue::addSource(Source* source) {
+	push(SEGMENT_SOURCE, 0).source = source;
+}
+
+void OutputQueue::endMessage() {
+	if (_segments.empty() || _segments.back().endsMessage) {
+		push(SEGMENT_TEXT, 0).offset = _text.size();    // Empty message
+	}
+	_segments.back().endsMessage = true;
+	++_messages;
+}
+
+ssize_t OutputQueue::flush(int fd) {
+	if (_failed) {
+		return -1;
+	}
+	advance(0);     // Empty messages
+	if (!_segments.empty() && _segments.front().kind == SEGMENT_FILE && _segments.front().zeroCopy) {
+		return sendFront(fd);
+	}
+
+	struct iovec iov[MAX_IOV];
+	int count = 0;
+	bool fileNext = false;
+	size_t skip = _cursor;
+	for (std::deque<Segment>::iterator it = _segments.begin();
+	     it != _segments.end() && count < MAX_IOV; ++it) {
+		size_t from = skip;
+		skip = 0;
+		if (it->kind == SEGMENT_SOURCE && it->length == 0) {
+			if (!refill(*it)) {
+				return -1;
+			}
+			if (it->length == 0 && !it->source->done()) {
+				break;
+			}
+		}
+		if (from >= it->length) {
+			continue;
+		}
+		if (it->kind == SEGMENT_FILE && it->zeroCopy) {
+			fileNext = true;
+			break;
+		}
+		if (it->kind == SEGMENT_FILE) {
+			size_t staged;
+			if (!stage(*it, from, staged)) {
+				return -1;
+			}
+			iov[count].iov_base = &_staging[0];
+			iov[count].iov_len = staged;
+			++count;
+			break;      // One staging buffer per batch
+		}
+		const char* base = (it->kind == SEGMENT_TEXT) ? _text.data() + it->offset : it->data.data();
+		iov[count].iov_base = const_cast<char*>(base + from);
+		iov[count].iov_len = it->length - from;
+		++count;
+		if (it->kind == SEGMENT_SOURCE) {
+			break;      // The next piece is made once this one went
+		}
+	}
+
+	if (count == 0) {
+		advance(0);     // A finished source
+		return 0;
+	}
+	if (fileNext) {
+		setCork(fd, true);
+	}
+	ssize_t written = writev(fd, iov, count);
+	if (written >= 0) {
+		advance(static_cast<size_t>(written));
+	}
+	if (fileNext) {
+		// Everything before the file went: start the file in the same packets
+		if (written >= 0 && _segments.front().kind == SEGMENT_FILE) {
+			ssize_t sent = sendFront(fd);
+			if (sent > 0) {
+				written += sent;
+			} else if (_failed) {
+				written = -1;
+			}
+		}
+		setCork(fd, false);
+	}
+	return written;
+}
+
+bool OutputQueue::empty() const {
+	return _segments.empty();
+}
+
+size_t OutputQueue::messages() const {
+	return _messages;
+}
+
+bool OutputQueue::failed() const {
+	return _failed;
+}
+
+void OutputQueue::clear() {
+	while (!_segments.empty()) {
+		pop();
+	}
+	_text.clear();
+	_textStart = 0;
+	_messages = 0;
+	_failed = false;
+}
+
+OutputQueue::Segment& OutputQueue::push(Kind kind, size_t length) {
+	_segments.push_back(Segment());
+	Segment& added = _segments.back();
+	added.kind = kind;
+	added.offset = 0;
+	added.length = length;
+	added.fd = -1;
+	added.fileOffset = 0;
+	added.zeroCopy = false;
+	added.source = NULL;
+	added.endsMessage = false;
+	return added;
+}
+
+// Read the next piece of a file segment into the staging buffer
+bool OutputQueue::stage(const Segment& segment, size_t from, size_t& staged) {
+	if (_staging.empty()) {
+		_staging.resize(FILE_STAGING_SIZE);
+	}
+	size_t wanted = segment.length - from;
+	if (wanted > _staging.size()) {
+		wanted = _staging.size();
+	}
+	ssize_t got = pread(segment.fd, &_staging[0], wanted, segment.fileOffset + static_cast<off_t>(from));
+	if (got <= 0) {
+		fileFailed(segment.fd);
+		return false;
+	}
+	staged = static_cast<size_t>(got);
+	return true;
+}
+
+// Next piece of a source segment whose previous piece was all sent
+bool OutputQueue::refill(Segment& segment) {
+	if (!segment.source->done() && !segment.source->read(segment.data)) {
+		Logger::error << "Could not produce a response body being sent" << std::endl;
+		_failed = true;
+		return false;
+	}
+	segment.length = segment.data.size();
+	return true;
+}
+
+// Zero-copy: the file segment at the front, from the cursor
+ssize_t OutputQueue::sendFront(int fd) {
+	const Segment& front = _segments.front();
+	size_t wanted = front.length - _cursor;
+	if (wanted > SENDFILE_MAX) {
+		wanted = SENDFILE_MAX;
+	}
+	off_t offset = front.fileOffset + static_cast<off_t>(_cursor);
+	ssize_t sent = sendfile(fd, front.fd, &offset, wanted);
+	if (sent < 0) {
+		return -1;      // Socket full (or gone: the next read tells)
+	}
+	if (sent == 0) {
+		fileFailed(front.fd);
+		return -1;
+	}
+	advance(static_cast<size_t>(sent));
+	return sent;
+}
+
+// Truncated or unreadable since the headers went out: the promised length
+// can no longer be delivered
+void OutputQueue::fileFailed(int fd) {
+	Logger::error << "Could not read a file being sent (fd: " << fd << ")" << std::endl;
+	_failed = true;
+}
+
+// Move the cursor past what the socket took, dropping finished segments
+void OutputQueue::advance(size_t written) {
+	while (!_segments.empty()) {
+		size_t left = _segments.front().length - _cursor;
+		if (written < left) {
+			_cursor += written;
+			break;
+		}
+		written -= left;
+		Segment& front = _segments.front();
+		if (front.kind == SEGMENT_SOURCE && !front.source->done()) {
+			// Sent up to the end of its piece: keep it for the next one
+			front.data.clear();
+			front.length = 0;
+			_cursor = 0;
+			break;
+		}
+		pop();
+	}
+
+	// Written text is dropped once it is most of the buffer
+	if (_segments.empty()) {
+		_text.clear();
+		_textStart = 0;
+	} else if (_textStart > _text.size() / 2) {
+		_text.erase(0, _textStart);
+		for (std::deque<Segment>::iterator it = _segments.begin(); it != _segments.end(); ++it) {
+			if (it->kind == SEGMENT_TEXT) {
+				it->offset -= _textStart;
+			}
+		}
+		_textStart = 0;
+	}
+}
+
+void OutputQueue::pop() {
+	Segment& front = _segments.front();
+	if (front.kind == SEGMENT_TEXT) {
+		_textStart = front.offset + front.length;
+	} else if (front.kind == SEGMENT_FILE) {
+		close(front.fd);
+	} else if (front.kind == SEGMENT_SOURCE) {
+		delete front.source;
+	}
+	if (front.endsMessage) {
+		--_messages;
+	}
+	_segments.pop_front();
+	_cursor = 0;
+}
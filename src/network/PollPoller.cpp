@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollPoller.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:16:45 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:16:45 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * PollPoller.cpp
+ * Implementation of the poll() backend
+ */
+#include "includes/network/PollPoller.hpp"
+#include "includes/utils/Logger.hpp"
+
+PollPoller::PollPoller() {}
+
+PollPoller::~PollPoller() {}
+
+bool PollPoller::add(int fd, short events) {
+	if (fd < 0) {
+		return false;
+	}
+	if (isRegistered(fd)) {
+		return modify(fd, events);
+	}
+
+	if (static_cast<size_t>(fd) >= _slots.size()) {
+		_slots.resize(fd + 1, -1);
+	}
+
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = events;
+	pfd.revents = 0;
+
+	_slots[fd] = static_cast<int>(_pollFds.size());
+	_pollFds.push_back(pfd);
+	setInterest(fd, events);
+	return true;
+}
+
+bool PollPoller::modify(int fd, short events) {
+	if (!isRegistered(fd)) {
+		return false;
+	}
+	_pollFds[_slots[fd]].events = events;
+	setInterest(fd, events);
+	return true;
+}
+
+void PollPoller::remove(int fd) {
+	if (!isRegistered(fd)) {
+		return;
+	}
+
+	// Move the last entry into the freed slot
+	int slot = _slots[fd];
+	int last = static_cast<int>(_pollFds.size()) - 1;
+	if (slot != last) {
+		_pollFds[slot] = _pollFds[last];
+		_slots[_pollFds[slot].fd] = slot;
+	}
+	_pollFds.pop_back();
+	_slots[fd] = -1;
+	clearInterest(fd);
+}
+
+int PollPoller::wait(std::vector<Event>& ready, int timeoutMs) {
+	ready.clear();
+
+	int result = poll(_pollFds.empty() ? NULL : &_pollFds[0], _pollFds.size(), timeoutMs);
+	if (result <= 0) {
+		return result;
+	}
+
+	// Collect ready fds so callers can add/remove while dispatching
+	for (size_t i = 0; i < _pollFds.size() && static_cast<int>(ready.size()) < result; ++i) {
+		if (_pollFds[i].revents != 0) {
+			ready.push_back(readyEvent(_pollFds[i].fd, _pollFds[i].revents));
+		}
+	}
+
+	return static_cast<int>(ready.size());
+}
+
+const char* PollPoller::getName() const {
+	return "poll";
+}
@@ -0,0 +1,133 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Poller.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:10:04 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 14:10:04 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * Poller.cpp
+ * Implementation of the Poller base class and backend factory
+ */
+#include "includes/network/Poller.hpp"
+#include "includes/network/PollPoller.hpp"
+#include "includes/network/EpollPoller.hpp"
+#include "includes/network/IoUringPoller.hpp"
+#include "includes/utils/Logger.hpp"
+
+// Constructors
+Poller::Poller()
+	: _count(0) {
+}
+
+Poller::~Poller() {}
+
+size_t Poller::size() const {
+	return _count;
+}
+
+// Readiness defaults for the completion hooks
+bool Poller::addListener(int fd) {
+	return add(fd, POLLIN);
+}
+
+bool Poller::addStream(int fd, short events) {
+	return add(fd, events);
+}
+
+Poller::Event Poller::readyEvent(int fd, short events) {
+	Event event;
+	event.fd = fd;
+	event.events = events;
+	event.type = EVENT_READY;
+	event.result = 0;
+	event.data = NULL;
+	return event;
+}
+
+// Interest bookkeeping (shared by all backends)
+bool Poller::isRegistered(int fd) const {
+	return fd >= 0 && static_cast<size_t>(fd) < _interest.size() && _interest[fd] >= 0;
+}
+
+void Poller::setInterest(int fd, short events) {
+	if (static_cast<size_t>(fd) >= _interest.size()) {
+		_interest.resize(fd + 1, -1);
+	}
+	if (_interest[fd] < 0) {
+		++_count;
+	}
+	_interest[fd] = events;
+}
+
+void Poller::clearInterest(int fd) {
+	if (isRegistered(fd)) {
+		_interest[fd] = -1;
+		--_count;
+	}
+}
+
+// Factory (io_uring -> epoll -> poll when a backend is unavailable)
+Poller* Poller::create(Backend backend) {
+#ifdef WEBSERV_HAVE_IO_URING
+	if (backend == BACKEND_IO_URING) {
+		IoUringPoller* poller = new IoUringPoller();
+		if (poller->isValid()) {
+			return poller;
+		}
+		delete poller;
+		Logger::warning << "io_uring unavailable (kernel < 5.19 or disabled), falling back" << std::endl;
+		backend = defaultBackend();
+	}
+#else
+	if (backend == BACKEND_IO_URING) {
+		Logger::warning << "io_uring not supported by this build, falling back" << std::endl;
+		backend = defaultBackend();
+	}
+#endif
+
+#ifdef WEBSERV_HAVE_EPOLL
+	if (backend == BACKEND_EPOLL) {
+		EpollPoller* poller = new EpollPoller();
+		if (poller->isValid()) {
+			return poller;
+		}
+		delete poller;
+		Logger::warning << "epoll unavailable, falling back to poll()" << std::endl;
+	}
+#else
+	if (backend == BACKEND_EPOLL) {
+		Logger::warning << "epoll not supported on this system, using poll()" << std::endl;
+	}
+#endif
+	return new PollPoller();
+}
+
+Poller::Backend Poller::defaultBackend() {
+#ifdef WEBSERV_HAVE_EPOLL
+	return BACKEND_EPOLL;
+#else
+	return BACKEND_POLL;
+#endif
+}
+
+bool Poller::parseBackend(const std::string& name, Backend& backend) {
+	if (name == "poll") {
+		backend = BACKEND_POLL;
+		return true;
+	}
+	if (name == "epoll") {
+		backend = BACKEND_EPOLL;
+		return true;
+	}
+	if (name == "io_uring") {
+		backend = BACKEND_IO_URING;
+		return true;
+	}
+	return false;
+}
@@ -25,14 +25,24 @@ Socket::Socket()
 	: _fd(-1)
 	, _host("")
 	, _port(0)
-	, _valid(false) {
+	, _valid(false)
+	, _server(NULL) {
 }
 
 Socket::Socket(int fd)
 	: _fd(fd)
 	, _host("")
 	, _port(0)
-	, _valid(fd >= 0) {
+	, _valid(fd >= 0)
+	, _server(NULL) {
+}
+
+Socket::Socket(int fd, const std::string& host, int port)
+	: _fd(fd)
+	, _host(host)
+	, _port(port)
+	, _valid(fd >= 0)
+	, _server(NULL) {
 }
 
 Socket::~Socket() {
@@ -112,9 +122,18 @@ int Socket::accept(struct sockaddr_in& clientAddr) {
 	}
 
 	socklen_t addrLen = sizeof(clientAddr);
-	std::memset(&clientAddr, 0, sizeof(clientAddr));
 
+#ifdef __linux__
+	// One syscall: flags are set atomically, no fcntl round-trips per client
+	int clientFd = ::accept4(_fd, (struct sockaddr*)&clientAddr, &addrLen,
+	                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
 	int clientFd = ::accept(_fd, (struct sockaddr*)&clientAddr, &addrLen);
+	if (clientFd >= 0) {
+		fcntl(clientFd, F_SETFL, fcntl(clientFd, F_GETFL, 0) | O_NONBLOCK);
+		fcntl(clientFd, F_SETFD, FD_CLOEXEC);
+	}
+#endif
 	if (clientFd < 0) {
 		// EWOULDBLOCK/EAGAIN is not an error in non-blocking mode
 		if (errno != EWOULDBLOCK && errno != EAGAIN) {
@@ -123,8 +142,6 @@ int Socket::accept(struct sockaddr_in& clientAddr) {
 		return -1;
 	}
 
-	Logger::debug << "Accepted connection from " << getHostString(clientAddr)
-	              << ":" << getPortNumber(clientAddr) << " (fd: " << clientFd << ")" << std::endl;
 	return clientFd;
 }
 
@@ -198,6 +215,27 @@ bool Socket::setReusePort() {
 	return true;
 }
 
+bool Socket::setCloseOnExec(bool enabled) {
+	if (!_valid) {
+		Logger::error << "Cannot set FD_CLOEXEC on invalid socket" << std::endl;
+		return false;
+	}
+
+	int flags = fcntl(_fd, F_GETFD, 0);
+	if (flags < 0) {
+		Logger::error << "Failed to get socket fd flags: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	flags = enabled ? (flags | FD_CLOEXEC) : (flags & ~FD_CLOEXEC);
+	if (fcntl(_fd, F_SETFD, flags) < 0) {
+		Logger::error << "Failed to set FD_CLOEXEC: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
 // Getters
 int Socket::getFd() const {
 	return _fd;
@@ -215,6 +253,14 @@ bool Socket::isValid() const {
 	return _valid;
 }
 
+void Socket::setServer(const Server* server) {
+	_server = server;
+}
+
+const Server* Socket::getServer() const {
+	return _server;
+}
+
 // Utils
 std::string Socket::getHostString(const struct sockaddr_in& addr) {
 	char buffer[INET_ADDRSTRLEN];
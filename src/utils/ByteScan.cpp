@@ -0,0 +1,348 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ByteScan.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:36:12 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 21:36:12 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * ByteScan.cpp
+ * Scalar, SSE4.2 and AVX2 scanning kernels and the runtime dispatch
+ * The vector kernels only handle whole 16/32-byte blocks that lie inside
+ * [from, size) and leave the tail to the scalar loop, so they never read
+ * past the end of the data.
+ */
+#include "includes/utils/ByteScan.hpp"
+#include <cctype>
+#include <cstring>
+#include <string>
+
+#if !defined(WEBSERV_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define BYTESCAN_X86
+# include <immintrin.h>
+#endif
+
+unsigned char ByteScan::_classes[256];
+
+namespace {
+	// Token bytes by nibble for the AVX2 kernel: byte b is a tchar when
+	// g_tokenLow[b & 15] & g_tokenHigh[b >> 4] is not zero
+	unsigned char g_tokenLow[16];
+	unsigned char g_tokenHigh[16];
+
+	// Scan kernels of one level
+	struct Kernels {
+		size_t (*skipToken)(const char*, size_t, size_t);
+		size_t (*skipVisible)(const char*, size_t, size_t);
+		size_t (*skipText)(const char*, size_t, size_t);
+		size_t (*findLineEnd)(const char*, size_t, size_t);
+		size_t (*find)(const char*, size_t, size_t, const char*, size_t);
+	};
+
+	// Bytes that end each scan, as a byte test and as 16/32-byte masks
+	struct TokenStop {
+		static bool scalar(unsigned char c) { return !ByteScan::isToken(c); }
+#ifdef BYTESCAN_X86
+		__attribute__((target("avx2")))
+		static __m256i avx2(__m256i v) {
+			const __m256i nibble = _mm256_set1_epi8(0x0f);
+			const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(g_tokenLow)));
+			const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(g_tokenHigh)));
+			__m256i lo = _mm256_shuffle_epi8(low, _mm256_and_si256(v, nibble));
+			__m256i hi = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+			return _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+		}
+#endif
+	};
+
+	struct VisibleStop {
+		static bool scalar(unsigned char c) { return !ByteScan::isVisible(c); }
+#ifdef BYTESCAN_X86
+		// c <= 0x20 (unsigned) or DEL
+		__attribute__((target("sse4.2")))
+		static __m128i sse42(__m128i v) {
+			__m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x20)), v);
+			return _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f)));
+		}
+		__attribute__((target("avx2")))
+		static __m256i avx2(__m256i v) {
+			__m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x20)), v);
+			return _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f)));
+		}
+#endif
+	};
+
+	struct TextStop {
+		static bool scalar(unsigned char c) { return !ByteScan::isText(c); }
+#ifdef BYTESCAN_X86
+		// c < 0x20 (unsigned) but not HTAB, or DEL
+		__attribute__((target("sse4.2")))
+		static __m128i sse42(__m128i v) {
+			__m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+			control = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), control);
+			return _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f)));
+		}
+		__attribute__((target("avx2")))
+		static __m256i avx2(__m256i v) {
+			__m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v);
+			control = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')), control);
+			return _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f)));
+		}
+#endif
+	};
+
+	struct LineEndStop {
+		static bool scalar(unsigned char c) { return c == '\r' || c == '\n'; }
+#ifdef BYTESCAN_X86
+		__attribute__((target("sse4.2")))
+		static __m128i sse42(__m128i v) {
+			return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+		}
+		__attribute__((target("avx2")))
+		static __m256i avx2(__m256i v) {
+			return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+		}
+#endif
+	};
+
+	template <class Stop>
+	size_t scanScalar(const char* data, size_t from, size_t size) {
+		while (from < size && !Stop::scalar(static_cast<unsigned char>(data[from]))) {
+			++from;
+		}
+		return from;
+	}
+
+	size_t findScalar(const char* data, size_t from, size_t size, const char* needle, size_t length) {
+		if (length == 0) {
+			return (from <= size) ? from : std::string::npos;
+		}
+		while (from + length <= size) {
+			const void* hit = std::memchr(data + from, needle[0], size - from - length + 1);
+			if (hit == NULL) {
+				break;
+			}
+			from = static_cast<const char*>(hit) - data;
+			if (std::memcmp(data + from + 1, needle + 1, length - 1) == 0) {
+				return from;
+			}
+			++from;
+		}
+		return std::string::npos;
+	}
+
+#ifdef BYTESCAN_X86
+	template <class Stop>
+	__attribute__((target("sse4.2")))
+	size_t scanSse42(const char* data, size_t from, size_t size) {
+		while (from + 16 <= size) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+			unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(Stop::sse42(v)));
+			if (mask != 0) {
+				return from + __builtin_ctz(mask);
+			}
+			from += 16;
+		}
+		return scanScalar<Stop>(data, from, size);
+	}
+
+	template <class Stop>
+	__attribute__((target("avx2")))
+	size_t scanAvx2(const char* data, size_t from, size_t size) {
+		while (from + 32 <= size) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+			unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(Stop::avx2(v)));
+			if (mask != 0) {
+				return from + __builtin_ctz(mask);
+			}
+			from += 32;
+		}
+		return scanScalar<Stop>(data, from, size);
+	}
+
+	// PCMPESTRI range match: the 8 ranges hold every byte that is not a
+	// tchar, plus '|' and '~' (inside {-0xff), which are rechecked by hand
+	__attribute__((target("sse4.2")))
+	size_t skipTokenSse42(const char* data, size_t from, size_t size) {
+		static const unsigned char ranges[16] = {
+			0x00, 0x20, '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']', '{', 0xff
+		};
+		const __m128i set = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+		while (from + 16 <= size) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+			int index = _mm_cmpestri(set, 16, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+			if (index == 16) {
+				from += 16;
+				continue;
+			}
+			from += index;
+			if (!ByteScan::isToken(static_cast<unsigned char>(data[from]))) {
+				return from;
+			}
+			++from;
+		}
+		return scanScalar<TokenStop>(data, from, size);
+	}
+
+	// Candidates are positions whose first and last bytes both match the
+	// needle's; only those are compared in full
+	__attribute__((target("sse4.2")))
+	size_t findSse42(const char* data, size_t from, size_t size, const char* needle, size_t length) {
+		if (length < 2) {
+			return findScalar(data, from, size, needle, length);
+		}
+		const __m128i first = _mm_set1_epi8(needle[0]);
+		const __m128i last = _mm_set1_epi8(needle[length - 1]);
+		while (from + length - 1 + 16 <= size) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from + length - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+				_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+			while (mask != 0) {
+				size_t at = from + __builtin_ctz(mask);
+				if (std::memcmp(data + at + 1, needle + 1, length - 2) == 0) {
+					return at;
+				}
+				mask &= mask - 1;
+			}
+			from += 16;
+		}
+		return findScalar(data, from, size, needle, length);
+	}
+
+	__attribute__((target("avx2")))
+	size_t findAvx2(const char* data, size_t from, size_t size, const char* needle, size_t length) {
+		if (length < 2) {
+			return findScalar(data, from, size, needle, length);
+		}
+		const __m256i first = _mm256_set1_epi8(needle[0]);
+		const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+		while (from + length - 1 + 32 <= size) {
+			__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+			__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from + length - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+				_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+			while (mask != 0) {
+				size_t at = from + __builtin_ctz(mask);
+				if (std::memcmp(data + at + 1, needle + 1, length - 2) == 0) {
+					return at;
+				}
+				mask &= mask - 1;
+			}
+			from += 32;
+		}
+		return findScalar(data, from, size, needle, length);
+	}
+#endif
+
+	const Kernels SCALAR_KERNELS = {
+		scanScalar<TokenStop>, scanScalar<VisibleStop>, scanScalar<TextStop>,
+		scanScalar<LineEndStop>, findScalar
+	};
+#ifdef BYTESCAN_X86
+	const Kernels SSE42_KERNELS = {
+		skipTokenSse42, scanSse42<VisibleStop>, scanSse42<TextStop>,
+		scanSse42<LineEndStop>, findSse42
+	};
+	const Kernels AVX2_KERNELS = {
+		scanAvx2<TokenStop>, scanAvx2<VisibleStop>, scanAvx2<TextStop>,
+		scanAvx2<LineEndStop>, findAvx2
+	};
+#endif
+
+	const Kernels* g_kernels = &SCALAR_KERNELS;
+	ByteScan::Level g_level = ByteScan::LEVEL_SCALAR;
+}
+
+// Fills the byte tables and picks the kernels before main()
+struct ByteScanInit {
+	ByteScanInit() {
+		for (int c = 0; c < 256; ++c) {
+			unsigned char classes = 0;
+			if (c > ' ' && c != 0x7f) {
+				classes |= ByteScan::CLASS_VISIBLE | ByteScan::CLASS_TEXT;
+			}
+			if (c == ' ' || c == '\t') {
+				classes |= ByteScan::CLASS_TEXT;
+			}
+			if (c < 0x80 && (std::isalnum(c) || std::strchr("!#$%&'*+-.^_`|~", c) != NULL)) {
+				classes |= ByteScan::CLASS_TOKEN;
+				g_tokenLow[c & 0x0f] |= static_cast<unsigned char>(1 << (c >> 4));
+			}
+			ByteScan::_classes[c] = classes;
+		}
+		for (int high = 0; high < 8; ++high) {
+			g_tokenHigh[high] = static_cast<unsigned char>(1 << high);
+		}
+		ByteScan::setLevel(ByteScan::detect());
+	}
+};
+
+static ByteScanInit g_byteScanInit;
+
+size_t ByteScan::skipToken(const char* data, size_t from, size_t size) {
+	return g_kernels->skipToken(data, from, size);
+}
+
+size_t ByteScan::skipVisible(const char* data, size_t from, size_t size) {
+	return g_kernels->skipVisible(data, from, size);
+}
+
+size_t ByteScan::skipText(const char* data, size_t from, size_t size) {
+	return g_kernels->skipText(data, from, size);
+}
+
+size_t ByteScan::findLineEnd(const char* data, size_t from, size_t size) {
+	return g_kernels->findLineEnd(data, from, size);
+}
+
+size_t ByteScan::find(const char* data, size_t from, size_t size, const char* needle, size_t length) {
+	return g_kernels->find(data, from, size, needle, length);
+}
+
+ByteScan::Level ByteScan::detect() {
+#ifdef BYTESCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return LEVEL_AVX2;
+	}
+	if (__builtin_cpu_supports("sse4.2")) {
+		return LEVEL_SSE42;
+	}
+#endif
+	return LEVEL_SCALAR;
+}
+
+ByteScan::Level ByteScan::level() {
+	return g_level;
+}
+
+ByteScan::Level ByteScan::setLevel(Level level) {
+	Level best = detect();
+	if (level > best) {
+		level = best;
+	}
+	g_level = level;
+	g_kernels = &SCALAR_KERNELS;
+#ifdef BYTESCAN_X86
+	if (level == LEVEL_AVX2) {
+		g_kernels = &AVX2_KERNELS;
+	} else if (level == LEVEL_SSE42) {
+		g_kernels = &SSE42_KERNELS;
+	}
+#endif
+	return level;
+}
+
+const char* ByteScan::levelName(Level level) {
+	switch (level) {
+		case LEVEL_AVX2: return "avx2";
+		case LEVEL_SSE42: return "sse4.2";
+		default: return "scalar";
+	}
+}
@@ -53,7 +53,8 @@ namespace Logger {
     // Get current timestamp
     std::string Stream::getTime() const {
         time_t now = time(0);
-        char* timeStr = ctime(&now);
+        char timeStr[32];
+        ctime_r(&now, timeStr); // Reentrant: loggers are used from every loop thread
         std::string result(timeStr);
         // Remove trailing newline
         if (!result.empty() && result[result.length() - 1] == '\n') {
@@ -0,0 +1,151 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoopStats.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:20:45 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 19:20:45 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * LoopStats.cpp
+ * Implementation of the event loop timing histograms
+ */
+#include "includes/utils/LoopStats.hpp"
+#include "includes/utils/Logger.hpp"
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+	// Single writer: a relaxed load + store is enough (plain movs on x86,
+	// no locked RMW) and keeps readers on other threads race-free
+	inline void add(unsigned long long& counter, unsigned long long value) {
+		__atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+	}
+
+	inline unsigned long long read(const unsigned long long& counter) {
+		return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+	}
+}
+
+LoopStats::LoopStats() {
+	std::memset(_phases, 0, sizeof(_phases));
+}
+
+void LoopStats::record(Phase phase, unsigned long long us) {
+	Histogram& histogram = _phases[phase];
+
+	// Bucket b holds [2^(b-1), 2^b) microseconds
+	unsigned int bucket = (us == 0) ? 0 : 64 - __builtin_clzll(us);
+	if (bucket >= BUCKETS) {
+		bucket = BUCKETS - 1;
+	}
+
+	add(histogram.count, 1);
+	add(histogram.totalUs, us);
+	add(histogram.buckets[bucket], 1);
+	if (us > read(histogram.maxUs)) {
+		__atomic_store_n(&histogram.maxUs, us, __ATOMIC_RELAXED);
+	}
+}
+
+void LoopStats::snapshot(LoopStats& out) const {
+	for (int p = 0; p < PHASE_COUNT; ++p) {
+		const Histogram& from = _phases[p];
+		Histogram& to = out._phases[p];
+		to.count = read(from.count);
+		to.totalUs = read(from.totalUs);
+		to.maxUs = read(from.maxUs);
+		for (unsigned int b = 0; b < BUCKETS; ++b) {
+			to.buckets[b] = read(from.buckets[b]);
+		}
+	}
+}
+
+void LoopStats::merge(const LoopStats& other) {
+	for (int p = 0; p < PHASE_COUNT; ++p) {
+		const Histogram& from = other._phases[p];
+		Histogram& to = _phases[p];
+		to.count += from.count;
+		to.totalUs += from.totalUs;
+		if (from.maxUs > to.maxUs) {
+			to.maxUs = from.maxUs;
+		}
+		for (unsigned int b = 0; b < BUCKETS; ++b) {
+			to.buckets[b] += from.buckets[b];
+		}
+	}
+}
+
+const LoopStats::Histogram& LoopStats::get(Phase phase) const {
+	return _phases[phase];
+}
+
+void LoopStats::dump(const std::string& title) const {
+	Logger::info << title << std::endl;
+
+	std::ostringstream header;
+	header << "  " << std::left << std::setw(8) << "phase" << std::right
+	       << std::setw(12) << "count" << std::setw(12) << "avg us"
+	       << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+	       << std::setw(12) << "max us";
+	Logger::info << header.str() << std::endl;
+
+	for (int p = 0; p < PHASE_COUNT; ++p) {
+		const Histogram& histogram = _phases[p];
+		std::ostringstream line;
+		line << "  " << std::left << std::setw(8) << phaseName(static_cast<Phase>(p)) << std::right
+		     << std::setw(12) << histogram.count
+		     << std::setw(12) << (histogram.count ? histogram.totalUs / histogram.count : 0)
+		     << std::setw(12) << percentile(histogram, 0.50)
+		     << std::setw(12) << percentile(histogram, 0.99)
+		     << std::setw(12) << histogram.maxUs;
+		Logger::info << line.str() << std::endl;
+	}
+}
+
+// Bucket resolution: the result is an upper bound, capped by the max seen
+unsigned long long LoopStats::percentile(const Histogram& histogram, double fraction) {
+	if (histogram.count == 0) {
+		return 0;
+	}
+
+	unsigned long long rank = static_cast<unsigned long long>(histogram.count * fraction);
+	if (rank >= histogram.count) {
+		rank = histogram.count - 1;
+	}
+
+	unsigned long long seen = 0;
+	for (unsigned int b = 0; b < BUCKETS; ++b) {
+		seen += histogram.buckets[b];
+		if (seen > rank) {
+			unsigned long long bound = (b == 0) ? 0 : (1ULL << b) - 1;
+			return (b == BUCKETS - 1 || bound > histogram.maxUs) ? histogram.maxUs : bound;
+		}
+	}
+	return histogram.maxUs;
+}
+
+const char* LoopStats::phaseName(Phase phase) {
+	switch (phase) {
+		case PHASE_LAG:    return "lag";
+		case PHASE_ACCEPT: return "accept";
+		case PHASE_READ:   return "read";
+		case PHASE_HANDLE: return "handle";
+		case PHASE_WRITE:  return "write";
+		case PHASE_TIMERS: return "timers";
+		default:           return "?";
+	}
+}
+
+unsigned long long LoopStats::monotonicUs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<unsigned long long>(ts.tv_sec) * 1000000ULL
+	     + static_cast<unsigned long long>(ts.tv_nsec) / 1000ULL;
+}
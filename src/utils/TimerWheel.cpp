@@ -0,0 +1,241 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: tborges- <tborges-@student.42lisboa.com    +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:58:47 by tborges-          #+#    #+#             */
+/*   Updated: 2026/10/17 16:58:47 by tborges-         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+/**
+ * TimerWheel.cpp
+ * Implementation of the hierarchical timer wheel
+ *
+ * Level 0 holds timers expiring in the next 64 ticks, level 1 the next
+ * 64*64 ticks, and so on. When level 0 wraps, the matching slot of the
+ * level above is cascaded down (same scheme as the classic Linux wheel).
+ */
+#include "includes/utils/TimerWheel.hpp"
+#include <ctime>
+
+// Timer node
+TimerWheel::Timer::Timer()
+	: prev(NULL)
+	, next(NULL)
+	, expires(0)
+	, kind(0)
+	, owner(NULL) {
+}
+
+bool TimerWheel::Timer::isArmed() const {
+	return next != NULL;
+}
+
+// Constructor
+TimerWheel::TimerWheel(unsigned int tickMs)
+	: _tickMs(tickMs > 0 ? tickMs : 1)
+	, _now(monotonicMs())
+	, _currentTick(_now / _tickMs)
+	, _count(0) {
+	for (unsigned int level = 0; level < LEVELS; ++level) {
+		for (unsigned int slot = 0; slot < SLOTS; ++slot) {
+			listInit(&_slots[level][slot]);
+		}
+	}
+	listInit(&_expired);
+}
+
+// Destructor - owners must cancel their timers before the wheel goes away
+TimerWheel::~TimerWheel() {}
+
+// Arm or re-arm a timer
+void TimerWheel::schedule(Timer* timer, unsigned long long delayMs) {
+	if (timer->isArmed()) {
+		listUnlink(timer);
+	} else {
+		++_count;
+	}
+	timer->expires = _now + delayMs;
+	insert(timer);
+}
+
+// Disarm a timer
+void TimerWheel::cancel(Timer* timer) {
+	if (timer->isArmed()) {
+		listUnlink(timer);
+		--_count;
+	}
+}
+
+// Advance the wheel up to nowMs
+void TimerWheel::advance(unsigned long long nowMs) {
+	if (nowMs > _now) {
+		_now = nowMs;
+	}
+	unsigned long long target = _now / _tickMs;
+
+	// Nothing armed: jump straight to the current tick
+	if (_count == 0) {
+		if (target >= _currentTick) {
+			_currentTick = target + 1;
+		}
+		return;
+	}
+
+	while (_currentTick <= target) {
+		unsigned int index = static_cast<unsigned int>(_currentTick & SLOT_MASK);
+
+		// Level 0 wrapped: bring the next batch down from level 1 (and up)
+		if (index == 0) {
+			cascade(1);
+		}
+
+		Timer* head = &_slots[0][index];
+		while (!listEmpty(head)) {
+			Timer* timer = head->next;
+			listUnlink(timer);
+			listAppend(&_expired, timer);
+		}
+
+		++_currentTick;
+	}
+}
+
+// Pop next expired timer
+TimerWheel::Timer* TimerWheel::popExpired() {
+	if (listEmpty(&_expired)) {
+		return NULL;
+	}
+	Timer* timer = _expired.next;
+	listUnlink(timer);
+	--_count;
+	return timer;
+}
+
+// Milliseconds until the next timer may expire
+int TimerWheel::nextTimeout(int maxMs) const {
+	if (!listEmpty(&_expired)) {
+		return 0;
+	}
+	if (_count == 0) {
+		return maxMs;
+	}
+
+	// First non-empty level 0 slot, or the next cascade point
+	unsigned int index = static_cast<unsigned int>(_currentTick & SLOT_MASK);
+	unsigned int ticks = 0;
+	for (; ticks < SLOTS; ++ticks) {
+		unsigned int slot = (index + ticks) & SLOT_MASK;
+		if (ticks > 0 && slot == 0) {
+			break; // Level 0 wraps here: higher levels cascade
+		}
+		if (!listEmpty(&_slots[0][slot])) {
+			break;
+		}
+	}
+
+	unsigned long long due = (_currentTick + ticks) * _tickMs;
+	if (due <= _now) {
+		return 0;
+	}
+	unsigned long long wait = due - _now;
+	if (maxMs >= 0 && wait > static_cast<unsigned long long>(maxMs)) {
+		return maxMs;
+	}
+	return static_cast<int>(wait);
+}
+
+unsigned long long TimerWheel::now() const {
+	return _now;
+}
+
+size_t TimerWheel::size() const {
+	return _count;
+}
+
+unsigned long long TimerWheel::monotonicMs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<unsigned long long>(ts.tv_sec) * 1000ULL
+	     + static_cast<unsigned long long>(ts.tv_nsec) / 1000000ULL;
+}
+
+// Place a timer in the level/slot matching its expiry
+void TimerWheel::insert(Timer* timer) {
+	// Round up so a timer never fires early
+	unsigned long long tick = (timer->expires + _tickMs - 1) / _tickMs;
+	if (tick < _currentTick) {
+		tick = _currentTick;
+	}
+
+	unsigned long long delta = tick - _currentTick;
+	unsigned int level = 0;
+	while (level < LEVELS - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+		++level;
+	}
+
+	// Beyond the wheel range: park it in the farthest slot
+	unsigned long long range = 1ULL << (LEVELS * SLOT_BITS);
+	if (delta >= range) {
+		tick = _currentTick + range - 1;
+	}
+
+	unsigned int slot = static_cast<unsigned int>((tick >> (level * SLOT_BITS)) & SLOT_MASK);
+	listAppend(&_slots[level][slot], timer);
+}
+
+// Re-insert the timers of the current slot of a level (they move down)
+void TimerWheel::cascade(unsigned int level) {
+	if (level >= LEVELS) {
+		return;
+	}
+
+	unsigned int slot = static_cast<unsigned int>((_currentTick >> (level * SLOT_BITS)) & SLOT_MASK);
+
+	// Detach the whole list first, insert() may append to the same slot
+	Timer pending;
+	listInit(&pending);
+	Timer* head = &_slots[level][slot];
+	while (!listEmpty(head)) {
+		Timer* timer = head->next;
+		listUnlink(timer);
+		listAppend(&pending, timer);
+	}
+	while (!listEmpty(&pending)) {
+		Timer* timer = pending.next;
+		listUnlink(timer);
+		insert(timer);
+	}
+
+	// This level wrapped too: cascade the level above
+	if (slot == 0) {
+		cascade(level + 1);
+	}
+}
+
+// Intrusive circular list helpers (head is a sentinel)
+void TimerWheel::listInit(Timer* head) {
+	head->prev = head;
+	head->next = head;
+}
+
+bool TimerWheel::listEmpty(const Timer* head) {
+	return head->next == head;
+}
+
+void TimerWheel::listAppend(Timer* head, Timer* timer) {
+	timer->prev = head->prev;
+	timer->next = head;
+	head->prev->next = timer;
+	head->prev = timer;
+}
+
+void TimerWheel::listUnlink(Timer* timer) {
+	timer->prev->next = timer->next;
+	timer->next->prev = timer->prev;
+	timer->prev = NULL;
+	timer->next = NULL;
+}
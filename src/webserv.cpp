@@ -11,19 +11,7 @@
 /* ************************************************************************** */
 
 #include "includes/webserv.hpp"
-#include <csignal>
-
-// Global pointer to server manager for signal handling
-HTTP::ServerManager* g_serverManager = NULL;
-
-void signalHandler(int signal) {
-	(void)signal;
-	std::cout << std::endl;
-	Logger::warning << "Received interrupt signal, stopping server..." << std::endl;
-	if (g_serverManager) {
-		g_serverManager->stop();
-	}
-}
+#include "includes/core/Master.hpp"
 
 int	main(int ac, char **av, char **env)
 {
@@ -58,26 +46,35 @@ int	main(int ac, char **av, char **env)
 	Logger::success << "Configuration loaded successfully!" << std::endl;
 	std::cout << std::endl;
 
-	// Initialize server manager
-	HTTP::ServerManager serverManager;
-	g_serverManager = &serverManager;
+	// Listening sockets: inherited from the binary that exec'd us (upgrade)
+	// where the address matches, opened otherwise
+	ListenerPool listeners;
+	listeners.inherit(std::getenv(ListenerPool::ENV_NAME));
+	unsetenv(ListenerPool::ENV_NAME);
 
-	if (!serverManager.init(config)) {
-		Logger::error << "Failed to initialize server manager" << std::endl;
+	bool useMaster = config.getMasterProcess();
+	if (!listeners.sync(config, useMaster ? config.getWorkerProcesses() : 1)) {
+		Logger::error << "Failed to setup listening sockets" << std::endl;
 		return 1;
 	}
 
-	// Setup signal handlers
-	signal(SIGINT, signalHandler);  // Ctrl+C
-	signal(SIGTERM, signalHandler); // kill
-
-	std::cout << std::endl;
-
-	// Start server (blocking)
-	serverManager.run();
+	int status;
+	if (useMaster) {
+		// A master supervises one event loop per worker process
+		Master master(config, configFile, av, listeners);
+		status = master.run();
+	} else {
+		// Single process: run the event loop here (blocking)
+		status = Master::serve(config, listeners.forSlot(0));
+		if (status == Master::WORKER_INIT_FAILED) {
+			return 1;
+		}
+	}
 
 	std::cout << std::endl;
-	Logger::success << "Server shutdown complete." << std::endl;
+	if (status == 0) {
+		Logger::success << "Server shutdown complete." << std::endl;
+	}
 
-	return 0;
+	return status;
 }
@@ -0,0 +1,206 @@
+#!/bin/bash
+
+# =============================================================================
+# Event backend comparison (poll vs epoll vs io_uring)
+# Starts ./webserv once per backend with the same minimal config and drives
+# it with the same load generator: concurrent clients doing one request per
+# connection (or, with KEEPALIVE=1, all their requests on one persistent
+# connection), next to a pool of idle connections.
+# Reports throughput, latency and, per request, context switches of the
+# server and (when strace is installed) system calls.
+#
+# Usage: ./bench_backends.sh [requests per client] [clients] [idle]
+#   ./bench_backends.sh 500 8 2000
+#   KEEPALIVE=1 ./bench_backends.sh 5000 8 0
+# Run from the repository root (needs ./webserv and ./www).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+HOST=127.0.0.1
+PORT=${PORT:-8099}
+REQUESTS=${1:-500}
+CLIENTS=${2:-8}
+IDLE=${3:-1000}
+BACKENDS=${BACKENDS:-poll epoll io_uring}
+KEEPALIVE=${KEEPALIVE:-0}
+
+echo "======================================"
+echo "⚖  Webserv Event Backend Benchmark"
+echo "======================================"
+echo ""
+echo "Clients: $CLIENTS x $REQUESTS requests, idle connections: $IDLE, keep-alive: $KEEPALIVE"
+echo ""
+
+if [ ! -x ./webserv ]; then
+    echo -e "${RED}Error: ./webserv not found (run 'make' in the repository root)${NC}"
+    exit 1
+fi
+
+if ! command -v python3 > /dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required for the load generator${NC}"
+    exit 1
+fi
+
+HAVE_STRACE=0
+if command -v strace > /dev/null 2>&1; then
+    HAVE_STRACE=1
+fi
+
+ulimit -n 65536 2> /dev/null || ulimit -n $(ulimit -Hn) 2> /dev/null
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf "${BLUE}%-10s %-10s %-10s %-10s %-12s %-12s${NC}\n" \
+    "backend" "req/s" "avg (us)" "p99 (us)" "ctxsw/req" "syscalls/req"
+
+for BACKEND in $BACKENDS; do
+    cat > "$TMP/bench.conf" <<CONF
+events {
+    use $BACKEND;
+}
+
+server {
+    listen $HOST:$PORT;
+    location / {
+        root ./www;
+        methods GET;
+        index index.html;
+    }
+}
+CONF
+
+    ./webserv "$TMP/bench.conf" > "$TMP/server.log" 2>&1 &
+    SERVER=$!
+    for _ in $(seq 50); do
+        curl -s -o /dev/null "http://$HOST:$PORT/" && break
+        sleep 0.1
+    done
+
+    # The backend actually used (io_uring falls back when the kernel lacks it)
+    USED=$(sed 's/\x1b\[[0-9;]*m//g' "$TMP/server.log" | grep -o "Using [a-z_]* event backend" | head -1 | awk '{print $2}')
+
+    if [ $HAVE_STRACE -eq 1 ]; then
+        strace -c -f -p $SERVER -o "$TMP/strace.txt" 2> /dev/null &
+        TRACER=$!
+        sleep 0.5
+    fi
+
+    CTX_BEFORE=$(awk '/ctxt_switches/ {s += $2} END {print s}' /proc/$SERVER/status 2> /dev/null)
+
+    RESULT=$(python3 - "$HOST" "$PORT" "$CLIENTS" "$REQUESTS" "$IDLE" "$KEEPALIVE" <<'PYEOF'
+import socket, sys, threading, time
+
+host, port = sys.argv[1], int(sys.argv[2])
+clients, requests, idle = int(sys.argv[3]), int(sys.argv[4]), int(sys.argv[5])
+keepalive = sys.argv[6] == "1"
+
+held = []
+for i in range(idle):
+    try:
+        held.append(socket.create_connection((host, port)))
+    except OSError:
+        break
+    if i % 100 == 99:
+        time.sleep(0.01)
+time.sleep(0.5)
+
+request = ("GET / HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n\r\n"
+           % (host, "keep-alive" if keepalive else "close")).encode()
+samples = []
+lock = threading.Lock()
+
+# One response on a persistent connection: headers, then Content-Length bytes
+# Returns the bytes after it and whether the server is closing (keepalive_requests)
+def read_response(s, pending):
+    while b"\r\n\r\n" not in pending:
+        pending += s.recv(65536)
+    head, _, rest = pending.partition(b"\r\n\r\n")
+    length = 0
+    closing = False
+    for line in head.lower().split(b"\r\n"):
+        if line.startswith(b"content-length:"):
+            length = int(line.split(b":", 1)[1])
+        elif line.startswith(b"connection:"):
+            closing = b"close" in line
+    while len(rest) < length:
+        rest += s.recv(65536)
+    return rest[length:], closing
+
+def client():
+    local = []
+    s = socket.create_connection((host, port)) if keepalive else None
+    pending = b""
+    for _ in range(requests):
+        t0 = time.time()
+        if keepalive:
+            s.sendall(request)
+            pending, closing = read_response(s, pending)
+            if closing:
+                s.close()
+                s = socket.create_connection((host, port))
+                pending = b""
+        else:
+            s = socket.create_connection((host, port))
+            s.sendall(request)
+            while s.recv(65536):
+                pass
+            s.close()
+        local.append((time.time() - t0) * 1e6)
+    if keepalive:
+        s.close()
+    with lock:
+        samples.extend(local)
+
+threads = [threading.Thread(target=client) for _ in range(clients)]
+start = time.time()
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+elapsed = time.time() - start
+
+samples.sort()
+avg = sum(samples) / len(samples)
+p99 = samples[min(len(samples) - 1, int(len(samples) * 0.99))]
+print("%d %.0f %.0f %.0f" % (len(samples), len(samples) / elapsed, avg, p99))
+for s in held:
+    s.close()
+PYEOF
+)
+
+    CTX_AFTER=$(awk '/ctxt_switches/ {s += $2} END {print s}' /proc/$SERVER/status 2> /dev/null)
+
+    if [ $HAVE_STRACE -eq 1 ]; then
+        kill -INT $TRACER 2> /dev/null
+        wait $TRACER 2> /dev/null
+    fi
+    kill -TERM $SERVER 2> /dev/null
+    wait $SERVER 2> /dev/null
+
+    read TOTAL RPS AVG P99 <<< "$RESULT"
+    CTX=$(awk -v a="$CTX_BEFORE" -v b="$CTX_AFTER" -v n="$TOTAL" 'BEGIN { if (n > 0 && b != "") printf "%.1f", (b - a) / n; else print "-" }')
+    SYSCALLS="-"
+    if [ $HAVE_STRACE -eq 1 ] && [ -s "$TMP/strace.txt" ]; then
+        SYSCALLS=$(awk -v n="$TOTAL" '/total/ { printf "%.1f", $4 / n }' "$TMP/strace.txt")
+    fi
+
+    LABEL=$BACKEND
+    if [ -n "$USED" ] && [ "$USED" != "$BACKEND" ]; then
+        LABEL="$BACKEND->$USED"
+    fi
+    printf "%-10s %-10s %-10s %-10s %-12s %-12s\n" "$LABEL" "$RPS" "$AVG" "$P99" "$CTX" "$SYSCALLS"
+    sleep 1
+done
+
+echo ""
+if [ $HAVE_STRACE -eq 0 ]; then
+    echo -e "${YELLOW}Install strace to also count system calls per request${NC}"
+fi
+echo -e "${GREEN}Done.${NC}"
@@ -0,0 +1,148 @@
+#!/bin/bash
+
+# =============================================================================
+# Connect-flood benchmark
+# While flood workers open and drop connections as fast as they can, the
+# clients that were already connected send one request each and time the
+# answer. Run once per accept_budget value: a small budget keeps existing
+# clients responsive, a huge one lets the accept loop starve them.
+#
+# Usage: ./bench_connect_flood.sh [flood seconds] [flood workers] [clients]
+#   BUDGETS="1 16 64 100000" ./bench_connect_flood.sh 5 4 200
+#   BACKLOG=4096 WORKER_CONNECTIONS=100000 (listen backlog and cap)
+# Run from the repository root (needs ./webserv and ./www).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+HOST=127.0.0.1
+PORT=${PORT:-8098}
+SECONDS_FLOOD=${1:-5}
+WORKERS=${2:-4}
+CLIENTS=${3:-200}
+BUDGETS=${BUDGETS:-1 16 64 100000}
+BACKLOG=${BACKLOG:-4096}
+WORKER_CONNECTIONS=${WORKER_CONNECTIONS:-100000}
+
+echo "======================================"
+echo "🌊 Webserv Connect-Flood Benchmark"
+echo "======================================"
+echo ""
+echo "Flood: $WORKERS workers for ${SECONDS_FLOOD}s, established clients: $CLIENTS"
+echo ""
+
+if [ ! -x ./webserv ]; then
+    echo -e "${RED}Error: ./webserv not found (run 'make' in the repository root)${NC}"
+    exit 1
+fi
+
+if ! command -v python3 > /dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required for the load generator${NC}"
+    exit 1
+fi
+
+ulimit -n 65536 2> /dev/null || ulimit -n $(ulimit -Hn) 2> /dev/null
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf "${BLUE}%-10s %-14s %-14s %-14s %-10s${NC}\n" \
+    "budget" "accepts/s" "avg (us)" "p99 (us)" "errors"
+
+for BUDGET in $BUDGETS; do
+    cat > "$TMP/flood.conf" <<CONF
+events {
+    accept_budget $BUDGET;
+    worker_connections $WORKER_CONNECTIONS;
+}
+
+server {
+    listen $HOST:$PORT backlog=$BACKLOG;
+    location / {
+        root ./www;
+        methods GET;
+        index index.html;
+    }
+}
+CONF
+
+    ./webserv "$TMP/flood.conf" > /dev/null 2>&1 &
+    SERVER=$!
+    for _ in $(seq 50); do
+        curl -s -o /dev/null "http://$HOST:$PORT/" && break
+        sleep 0.1
+    done
+
+    python3 - "$HOST" "$PORT" "$SECONDS_FLOOD" "$WORKERS" "$CLIENTS" "$BUDGET" <<'PYEOF'
+import multiprocessing, socket, sys, time
+
+host, port = sys.argv[1], int(sys.argv[2])
+duration, workers, clients, budget = float(sys.argv[3]), int(sys.argv[4]), int(sys.argv[5]), sys.argv[6]
+
+def flood(deadline, counter):
+    done = 0
+    while time.time() < deadline:
+        try:
+            s = socket.create_connection((host, port), timeout=2)
+            s.close()
+            done += 1
+        except OSError:
+            time.sleep(0.001)
+    with counter.get_lock():
+        counter.value += done
+
+# Established clients: connected (and accepted) before the flood starts
+established = []
+for i in range(clients):
+    established.append(socket.create_connection((host, port)))
+    if i % 100 == 99:
+        time.sleep(0.01)
+time.sleep(0.5)
+
+counter = multiprocessing.Value('l', 0)
+start = time.time()
+deadline = start + duration
+procs = [multiprocessing.Process(target=flood, args=(deadline, counter)) for _ in range(workers)]
+for p in procs:
+    p.start()
+time.sleep(min(0.5, duration / 4))
+
+# One request per established client, spread over the flood
+request = ("GET / HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n" % host).encode()
+samples, errors = [], 0
+pause = max(0.0, (duration * 0.6) / max(1, clients))
+for s in established:
+    t0 = time.time()
+    try:
+        s.settimeout(10)
+        s.sendall(request)
+        while s.recv(65536):
+            pass
+        samples.append((time.time() - t0) * 1e6)
+    except OSError:
+        errors += 1
+    s.close()
+    time.sleep(pause)
+
+for p in procs:
+    p.join()
+elapsed = time.time() - start
+
+samples.sort()
+avg = sum(samples) / len(samples) if samples else 0
+p99 = samples[min(len(samples) - 1, int(len(samples) * 0.99))] if samples else 0
+print("%-10s %-14.0f %-14.0f %-14.0f %-10d" % (budget, counter.value / elapsed, avg, p99, errors))
+PYEOF
+
+    kill -TERM $SERVER 2> /dev/null
+    wait $SERVER 2> /dev/null
+    sleep 1
+done
+
+echo ""
+echo -e "${GREEN}Done.${NC}"
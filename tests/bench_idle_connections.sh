@@ -0,0 +1,94 @@
+#!/bin/bash
+
+# =============================================================================
+# Event loop cost vs. idle connections
+# Opens N idle keep-open connections and measures the latency of active
+# requests. With epoll the loop cost should stay flat as N grows.
+#
+# Usage: ./bench_idle_connections.sh [requests] [idle counts...]
+#   ./bench_idle_connections.sh 200 0 1000 5000 10000
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+HOST=${HOST:-127.0.0.1}
+PORT=${PORT:-8080}
+REQUESTS=${1:-200}
+shift
+IDLE_COUNTS=${@:-0 1000 5000 10000}
+
+echo "======================================"
+echo "⏱  Webserv Idle Connections Benchmark"
+echo "======================================"
+echo ""
+echo "Target: http://$HOST:$PORT/"
+echo "Requests per run: $REQUESTS"
+echo "Idle connections: $IDLE_COUNTS"
+echo ""
+
+# Check if server is running
+if ! curl -s "http://$HOST:$PORT/" > /dev/null 2>&1; then
+    echo -e "${RED}Error: Server is not running at http://$HOST:$PORT${NC}"
+    echo "Please start the server with: ./webserv config/cgi.conf"
+    exit 1
+fi
+
+if ! command -v python3 > /dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required to hold idle connections${NC}"
+    exit 1
+fi
+
+# Raise the fd limit for the idle clients (best effort)
+ulimit -n 65536 2> /dev/null || ulimit -n $(ulimit -Hn) 2> /dev/null
+
+printf "${BLUE}%-12s %-12s %-12s %-12s${NC}\n" "idle" "avg (us)" "p99 (us)" "req/s"
+
+for IDLE in $IDLE_COUNTS; do
+    python3 - "$HOST" "$PORT" "$IDLE" "$REQUESTS" <<'PYEOF'
+import socket, sys, time
+
+host, port, idle, requests = sys.argv[1], int(sys.argv[2]), int(sys.argv[3]), int(sys.argv[4])
+
+# Idle clients: connected, never send anything
+# (paced so the listen backlog never overflows)
+held = []
+for i in range(idle):
+    try:
+        held.append(socket.create_connection((host, port)))
+    except OSError:
+        break
+    if i % 100 == 99:
+        time.sleep(0.01)
+time.sleep(1)
+
+request = ("GET / HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n" % host).encode()
+samples = []
+start = time.time()
+for _ in range(requests):
+    t0 = time.time()
+    s = socket.create_connection((host, port))
+    s.sendall(request)
+    while s.recv(65536):
+        pass
+    s.close()
+    samples.append((time.time() - t0) * 1e6)
+elapsed = time.time() - start
+
+samples.sort()
+avg = sum(samples) / len(samples)
+p99 = samples[min(len(samples) - 1, int(len(samples) * 0.99))]
+print("%-12d %-12.0f %-12.0f %-12.0f" % (len(held), avg, p99, requests / elapsed))
+
+for s in held:
+    s.close()
+PYEOF
+    sleep 1
+done
+
+echo ""
+echo -e "${YELLOW}Compare backends with 'events { use poll; }' vs 'events { use epoll; }'${NC}"
@@ -0,0 +1,185 @@
+#!/bin/bash
+
+# =============================================================================
+# Request parser microbenchmark
+# Builds the same small C++ program against the working tree and against a
+# baseline revision (by default the last one before the incremental
+# RequestParser) and reports ns/request for a few typical requests:
+#   parse      Request::parse() on the whole request (both trees)
+#   scan       RequestParser::feed() alone, no strings built (current tree)
+#   split      feed() as the request arrives in 64-byte reads (current tree)
+#
+# Usage: ./bench_parser.sh [baseline revision] [iterations]
+#   ./bench_parser.sh
+#   ./bench_parser.sh HEAD~3 500000
+# Run from the repository root (needs git and a C++ compiler).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+CXX=${CXX:-c++}
+ITERATIONS=${2:-200000}
+BASELINE=$1
+if [ -z "$BASELINE" ]; then
+    ADDED=$(git log -1 --format=%H --diff-filter=A -- src/http/RequestParser.cpp 2> /dev/null)
+    BASELINE=${ADDED:+$ADDED^}
+fi
+
+echo "======================================"
+echo "🔬 Webserv Request Parser Benchmark"
+echo "======================================"
+echo ""
+echo "Baseline: ${BASELINE:-none}, iterations: $ITERATIONS"
+echo ""
+
+if ! command -v $CXX > /dev/null 2>&1; then
+    echo -e "${RED}Error: $CXX not found${NC}"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+cat > "$TMP/bench.cpp" <<'CPPEOF'
+#include "includes/http/Request.hpp"
+#ifdef HAVE_REQUEST_PARSER
+#include "includes/http/RequestParser.hpp"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+static double nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile size_t g_sink;
+
+static double benchParse(const std::string& raw, long iterations) {
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		HTTP::Request request;
+		request.parse(raw);
+		g_sink += request.getBody().size() + request.getHeaders().size();
+	}
+	return (nowNs() - start) / iterations;
+}
+
+#ifdef HAVE_REQUEST_PARSER
+static double benchScan(const std::string& raw, long iterations) {
+	HTTP::RequestParser parser;
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		parser.reset();
+		parser.feed(raw);
+		g_sink += parser.end();
+	}
+	return (nowNs() - start) / iterations;
+}
+
+static double benchSplit(const std::string& raw, long iterations) {
+	HTTP::RequestParser parser;
+	std::string buffer;
+	buffer.reserve(raw.size());
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		parser.reset();
+		buffer.clear();
+		for (size_t off = 0; off < raw.size(); off += 64) {
+			buffer.append(raw, off, 64);
+			parser.feed(buffer);
+		}
+		g_sink += parser.end();
+	}
+	return (nowNs() - start) / iterations;
+}
+#endif
+
+int main(int argc, char** argv) {
+	long iterations = (argc > 1) ? std::atol(argv[1]) : 200000;
+
+	const char* names[] = { "curl GET", "browser GET", "POST 1 KiB", "chunked POST" };
+	std::string requests[4];
+	requests[0] = "GET /index.html HTTP/1.1\r\nHost: localhost:8080\r\n"
+	              "User-Agent: curl/8.5.0\r\nAccept: */*\r\n\r\n";
+	requests[1] = "GET /static/app.js?v=42 HTTP/1.1\r\nHost: www.example.com\r\n"
+	              "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+	              "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+	              "Accept-Language: en-US,en;q=0.5\r\nAccept-Encoding: gzip, deflate, br\r\n"
+	              "Referer: https://www.example.com/\r\nConnection: keep-alive\r\n"
+	              "Cookie: session=4f2a9c1e7b3d8a6f; theme=dark; lang=en\r\n"
+	              "Upgrade-Insecure-Requests: 1\r\nSec-Fetch-Dest: script\r\n"
+	              "If-None-Match: \"11e068-690600e6-826\"\r\nCache-Control: max-age=0\r\n\r\n";
+	requests[2] = "POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/octet-stream\r\n"
+	              "Content-Length: 1024\r\n\r\n" + std::string(1024, 'x');
+	requests[3] = "POST /api HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n";
+	for (int i = 0; i < 8; ++i) {
+		requests[3] += "80\r\n" + std::string(128, 'y') + "\r\n";
+	}
+	requests[3] += "0\r\n\r\n";
+
+	for (int r = 0; r < 4; ++r) {
+		benchParse(requests[r], iterations / 10); // Warm up
+		double parse = benchParse(requests[r], iterations);
+#ifdef HAVE_REQUEST_PARSER
+		double scan = benchScan(requests[r], iterations);
+		double split = benchSplit(requests[r], iterations);
+		std::printf("%-14s %6lu %10.0f %10.0f %10.0f\n", names[r], (unsigned long)requests[r].size(), parse, scan, split);
+#else
+		std::printf("%-14s %6lu %10.0f %10s %10s\n", names[r], (unsigned long)requests[r].size(), parse, "-", "-");
+#endif
+	}
+	return 0;
+}
+CPPEOF
+
+# Build the benchmark against one source tree
+build() {
+    local tree=$1 out=$2
+    local sources="$tree/src/http/Request.cpp $tree/src/utils/Logger.cpp"
+    local defines=""
+    if [ -f "$tree/src/http/RequestParser.cpp" ]; then
+        defines="-DHAVE_REQUEST_PARSER"
+    fi
+    # Sources Request.cpp came to depend on, when this tree has them
+    for extra in src/http/RequestParser.cpp src/http/HeaderTable.cpp src/http/Method.cpp src/http/ParamList.cpp \
+                 src/http/BodySink.cpp src/utils/ByteScan.cpp; do
+        if [ -f "$tree/$extra" ]; then
+            sources="$sources $tree/$extra"
+        fi
+    done
+    $CXX -std=c++98 -O2 -I"$tree" $defines "$TMP/bench.cpp" $sources -o "$out" 2> "$TMP/build.log"
+}
+
+run() {
+    printf "${BLUE}%-14s %6s %10s %10s %10s${NC}\n" "$1" "bytes" "parse ns" "scan ns" "split ns"
+    "$2" "$ITERATIONS" 2> /dev/null
+    echo ""
+}
+
+if ! build . "$TMP/current"; then
+    echo -e "${RED}Error: build failed${NC}"
+    cat "$TMP/build.log"
+    exit 1
+fi
+
+if [ -n "$BASELINE" ]; then
+    mkdir -p "$TMP/baseline"
+    if git archive "$BASELINE" includes src | tar -x -C "$TMP/baseline" 2> /dev/null \
+       && build "$TMP/baseline" "$TMP/old"; then
+        run "baseline" "$TMP/old"
+    else
+        echo -e "${RED}Could not build baseline $BASELINE${NC}"
+        echo ""
+    fi
+fi
+
+run "current" "$TMP/current"
+echo -e "${GREEN}Done.${NC}"
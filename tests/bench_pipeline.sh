@@ -0,0 +1,147 @@
+#!/bin/bash
+
+# =============================================================================
+# HTTP/1.1 pipelining benchmark
+# Each client keeps one persistent connection and sends its requests in
+# batches of DEPTH (all in one write), then reads the DEPTH responses.
+# Depth 1 is plain keep-alive. Reports throughput, batch latency and how many
+# write calls the server made per response (from the SIGUSR1 loop stats):
+# pipelined responses should leave together in one writev.
+#
+# Usage: ./bench_pipeline.sh [requests per client] [clients] [depths...]
+#   ./bench_pipeline.sh 4000 8 1 8 32
+# Run from the repository root (needs ./webserv and ./www).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+HOST=127.0.0.1
+PORT=${PORT:-8099}
+REQUESTS=${1:-4000}
+CLIENTS=${2:-8}
+shift 2 2> /dev/null
+DEPTHS=${*:-1 8 32}
+BACKEND=${BACKEND:-epoll}
+
+echo "======================================"
+echo "🚇 Webserv Pipelining Benchmark"
+echo "======================================"
+echo ""
+echo "Clients: $CLIENTS x $REQUESTS requests, backend: $BACKEND, depths: $DEPTHS"
+echo ""
+
+if [ ! -x ./webserv ]; then
+    echo -e "${RED}Error: ./webserv not found (run 'make' in the repository root)${NC}"
+    exit 1
+fi
+
+if ! command -v python3 > /dev/null 2>&1; then
+    echo -e "${RED}Error: python3 is required for the load generator${NC}"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+cat > "$TMP/bench.conf" <<CONF
+master_process off;
+
+events {
+    use $BACKEND;
+}
+
+server {
+    listen $HOST:$PORT;
+    keepalive_requests 1000000;
+    location / {
+        root ./www;
+        methods GET;
+        index index.html;
+    }
+}
+CONF
+
+printf "${BLUE}%-8s %-10s %-14s %-14s %-12s${NC}\n" \
+    "depth" "req/s" "batch avg us" "batch p99 us" "writes/resp"
+
+for DEPTH in $DEPTHS; do
+    ./webserv "$TMP/bench.conf" > "$TMP/server.log" 2>&1 &
+    SERVER=$!
+    for _ in $(seq 50); do
+        curl -s -o /dev/null "http://$HOST:$PORT/" && break
+        sleep 0.1
+    done
+
+    RESULT=$(python3 - "$HOST" "$PORT" "$CLIENTS" "$REQUESTS" "$DEPTH" <<'PYEOF'
+import socket, sys, threading, time
+
+host, port = sys.argv[1], int(sys.argv[2])
+clients, requests, depth = int(sys.argv[3]), int(sys.argv[4]), int(sys.argv[5])
+
+batch = ("GET / HTTP/1.1\r\nHost: %s\r\n\r\n" % host).encode() * depth
+samples = []
+lock = threading.Lock()
+
+# One response: headers, then Content-Length bytes; returns what follows it
+def read_response(s, pending):
+    while b"\r\n\r\n" not in pending:
+        pending += s.recv(65536)
+    head, _, rest = pending.partition(b"\r\n\r\n")
+    length = 0
+    for line in head.lower().split(b"\r\n"):
+        if line.startswith(b"content-length:"):
+            length = int(line.split(b":", 1)[1])
+    while len(rest) < length:
+        rest += s.recv(65536)
+    return rest[length:]
+
+def client():
+    local = []
+    s = socket.create_connection((host, port))
+    pending = b""
+    for _ in range(max(1, requests // depth)):
+        t0 = time.time()
+        s.sendall(batch)
+        for _ in range(depth):
+            pending = read_response(s, pending)
+        local.append((time.time() - t0) * 1e6)
+    s.close()
+    with lock:
+        samples.extend(local)
+
+threads = [threading.Thread(target=client) for _ in range(clients)]
+start = time.time()
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+elapsed = time.time() - start
+
+samples.sort()
+avg = sum(samples) / len(samples)
+p99 = samples[min(len(samples) - 1, int(len(samples) * 0.99))]
+print("%.0f %.0f %.0f" % (len(samples) * depth / elapsed, avg, p99))
+PYEOF
+)
+
+    # Loop stats: the last block is the process total
+    kill -USR1 $SERVER 2> /dev/null
+    sleep 0.5
+    kill -TERM $SERVER 2> /dev/null
+    wait $SERVER 2> /dev/null
+    WRITES=$(sed 's/\x1b\[[0-9;]*m//g' "$TMP/server.log" | awk '
+        NF >= 6 && $(NF-5) == "handle" { handle = $(NF-4) }
+        NF >= 6 && $(NF-5) == "write"  { write = $(NF-4) }
+        END { if (handle > 0) printf "%.2f", write / handle; else print "-" }')
+
+    read RPS AVG P99 <<< "$RESULT"
+    printf "%-8s %-10s %-14s %-14s %-12s\n" "$DEPTH" "$RPS" "$AVG" "$P99" "$WRITES"
+    sleep 1
+done
+
+echo ""
+echo -e "${GREEN}Done.${NC}"
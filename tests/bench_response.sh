@@ -0,0 +1,188 @@
+#!/bin/bash
+
+# =============================================================================
+# Response serialization microbenchmark
+# Builds the same small C++ program against the working tree and against a
+# baseline revision (by default the last one before Response::serialize())
+# and reports, for a few typical responses, the cost of filling a Response
+# and queueing it the way Connection does:
+#   baseline   Response::build() into a string swapped into the queue
+#   current    Response::serialize() into the connection's OutputQueue:
+#              head written in place, body moved
+# Columns are ns/response and heap allocations/response.
+#
+# Usage: ./bench_response.sh [baseline revision] [iterations]
+#   ./bench_response.sh
+#   ./bench_response.sh HEAD~3 500000
+# Run from the repository root (needs git and a C++ compiler).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+CXX=${CXX:-c++}
+ITERATIONS=${2:-200000}
+BASELINE=$1
+if [ -z "$BASELINE" ]; then
+    ADDED=$(git log -1 --format=%H -S'void serialize(' -- includes/http/Response.hpp 2> /dev/null)
+    BASELINE=${ADDED:+$ADDED^}
+    BASELINE=${BASELINE:-HEAD}
+fi
+
+echo "======================================"
+echo "🔬 Webserv Response Writer Benchmark"
+echo "======================================"
+echo ""
+echo "Baseline: $BASELINE, iterations: $ITERATIONS"
+echo ""
+
+if ! command -v $CXX > /dev/null 2>&1; then
+    echo -e "${RED}Error: $CXX not found${NC}"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+cat > "$TMP/bench.cpp" <<'CPPEOF'
+#include "includes/http/Response.hpp"
+#ifdef HAVE_RESPONSE_WRITER
+#include "includes/network/OutputQueue.hpp"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <string>
+
+// Every heap allocation goes through here
+static size_t g_allocations;
+
+void* operator new(size_t size) throw(std::bad_alloc) {
+	++g_allocations;
+	void* p = std::malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) throw() {
+	std::free(p);
+}
+
+static double nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile size_t g_sink;
+
+enum Kind { STATIC_SMALL, STATIC_LARGE, NOT_FOUND, HEAD_REQUEST };
+
+static void fill(HTTP::Response& response, Kind kind, const std::string& body) {
+	if (kind == NOT_FOUND) {
+		response = HTTP::Response::errorResponse(404, "The requested URL /missing was not found on this server.");
+	} else {
+		response.setStatus(200);
+		response.setContentType("text/html");
+		response.setLastModified(1760000000);
+		response.setETag("68e9b800-800");
+		response.setCacheControl("max-age=0");
+		response.setBody(body);
+		if (kind == HEAD_REQUEST) {
+			response.omitBody();
+		}
+	}
+	response.setKeepAlive(true);
+}
+
+// Fill and queue one response per iteration, as Connection does
+static double bench(Kind kind, const std::string& body, long iterations, double& allocations) {
+#ifdef HAVE_RESPONSE_WRITER
+	OutputQueue queue;  // Connection::_output, reused
+#else
+	std::string queued; // The queue entry
+#endif
+	size_t before = g_allocations;
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		HTTP::Response response;
+		fill(response, kind, body);
+#ifdef HAVE_RESPONSE_WRITER
+		response.serialize(queue);
+		g_sink += queue.messages();
+		queue.clear();
+#else
+		std::string built = response.build();
+		queued.swap(built);
+		g_sink += queued.size();
+#endif
+	}
+	double elapsed = (nowNs() - start) / iterations;
+	allocations = static_cast<double>(g_allocations - before) / iterations;
+	return elapsed;
+}
+
+int main(int argc, char** argv) {
+	long iterations = (argc > 1) ? std::atol(argv[1]) : 200000;
+
+	const char* names[] = { "200 2 KiB", "200 64 KiB", "404 error", "HEAD 2 KiB" };
+	Kind kinds[] = { STATIC_SMALL, STATIC_LARGE, NOT_FOUND, HEAD_REQUEST };
+	std::string bodies[] = { std::string(2048, 'x'), std::string(65536, 'x'), "", std::string(2048, 'x') };
+
+	for (int r = 0; r < 4; ++r) {
+		double allocations;
+		bench(kinds[r], bodies[r], iterations / 10, allocations); // Warm up
+		double ns = bench(kinds[r], bodies[r], iterations, allocations);
+		std::printf("%-14s %10.0f %10.1f\n", names[r], ns, allocations);
+	}
+	return 0;
+}
+CPPEOF
+
+# Build the benchmark against one source tree
+build() {
+    local tree=$1 out=$2
+    local sources="$tree/src/http/Response.cpp $tree/src/core/Settings.cpp $tree/src/core/Instance.cpp"
+    local defines=""
+    if [ -f "$tree/src/network/OutputQueue.cpp" ]; then
+        defines="-DHAVE_RESPONSE_WRITER"
+        sources="$sources $tree/src/network/OutputQueue.cpp $tree/src/utils/Logger.cpp"
+    fi
+    if [ -f "$tree/src/http/HeaderTable.cpp" ]; then
+        sources="$sources $tree/src/http/HeaderTable.cpp"
+    fi
+    if [ -f "$tree/src/http/CompressedStream.cpp" ]; then
+        sources="$sources $tree/src/http/CompressedStream.cpp $tree/src/http/Compressor.cpp"
+    fi
+    $CXX -std=c++98 -O2 -I"$tree" $defines "$TMP/bench.cpp" $sources -o "$out" 2> "$TMP/build.log"
+}
+
+run() {
+    printf "${BLUE}%-14s %10s %10s${NC}\n" "$1" "ns" "allocs"
+    "$2" "$ITERATIONS" 2> /dev/null
+    echo ""
+}
+
+if ! build . "$TMP/current"; then
+    echo -e "${RED}Error: build failed${NC}"
+    cat "$TMP/build.log"
+    exit 1
+fi
+
+mkdir -p "$TMP/baseline"
+if git archive "$BASELINE" includes src | tar -x -C "$TMP/baseline" 2> /dev/null \
+   && build "$TMP/baseline" "$TMP/old"; then
+    run "baseline" "$TMP/old"
+else
+    echo -e "${RED}Could not build baseline $BASELINE${NC}"
+    echo ""
+fi
+
+run "current" "$TMP/current"
+echo -e "${GREEN}Done.${NC}"
@@ -0,0 +1,159 @@
+#!/bin/bash
+
+# =============================================================================
+# Byte scanning benchmark (scalar vs SSE4.2 vs AVX2)
+# Builds a small C++ program against the working tree and times, at each
+# ByteScan level the CPU supports, on browser-like request heads of about
+# 500, 1000 and 2000 bytes:
+#   parse      RequestParser::feed() on the whole head
+#   lines      splitting the head into lines (findLineEnd)
+# and a multipart boundary search over a 1 MiB upload body (find).
+#
+# Usage: ./bench_scan.sh [iterations]
+#   ./bench_scan.sh 200000
+# Run from the repository root (needs a C++ compiler).
+# =============================================================================
+
+# Colors
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+CXX=${CXX:-c++}
+ITERATIONS=${1:-100000}
+
+echo "======================================"
+echo "🔎 Webserv Byte Scanning Benchmark"
+echo "======================================"
+echo ""
+echo "Iterations: $ITERATIONS"
+echo ""
+
+if ! command -v $CXX > /dev/null 2>&1; then
+    echo -e "${RED}Error: $CXX not found${NC}"
+    exit 1
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+cat > "$TMP/bench.cpp" <<'CPPEOF'
+#include "includes/http/RequestParser.hpp"
+#include "includes/utils/ByteScan.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+static double nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static volatile size_t g_sink;
+
+// A browser navigation; cookies and extra headers pad it to about size bytes
+static std::string browserHead(size_t size) {
+	std::string head = "GET /products/view?id=4711&ref=search HTTP/1.1\r\n"
+		"Host: shop.example.com\r\n"
+		"User-Agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0.0.0 Safari/537.36\r\n"
+		"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+		"Accept-Language: en-US,en;q=0.9,pt-PT;q=0.8\r\n"
+		"Accept-Encoding: gzip, deflate, br, zstd\r\n"
+		"Referer: https://shop.example.com/search?q=keyboard\r\n"
+		"Sec-Fetch-Mode: navigate\r\n"
+		"Upgrade-Insecure-Requests: 1\r\nConnection: keep-alive\r\n";
+	std::string cookie = "Cookie: _ga=GA1.2.1234567890.1700000000; session=8f14e45fceea167a5a36dedd4bea2543";
+	const char* hex = "0123456789abcdef";
+	for (int i = 0; head.size() + cookie.size() + 4 < size; ++i) {
+		cookie += (i % 2) ? "; pref_" : "; _trk";
+		for (int j = 0; j < 24; ++j) {
+			cookie += hex[(i * 7 + j * 13) % 16];
+		}
+	}
+	return head + cookie.substr(0, size > head.size() + 4 ? size - head.size() - 4 : 0) + "\r\n\r\n";
+}
+
+static double benchParse(const std::string& raw, long iterations) {
+	HTTP::RequestParser parser;
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		parser.reset();
+		parser.feed(raw);
+		g_sink += parser.headers().size();
+	}
+	return (nowNs() - start) / iterations;
+}
+
+static double benchLines(const std::string& raw, long iterations) {
+	const char* data = raw.data();
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		size_t lines = 0;
+		for (size_t pos = 0; pos < raw.size(); ++lines) {
+			pos = ByteScan::findLineEnd(data, pos, raw.size()) + 1;
+		}
+		g_sink += lines;
+	}
+	return (nowNs() - start) / iterations;
+}
+
+static double benchBoundary(const std::string& body, const std::string& delimiter, long iterations) {
+	double start = nowNs();
+	for (long i = 0; i < iterations; ++i) {
+		g_sink += ByteScan::find(body.data(), 0, body.size(), delimiter.data(), delimiter.size());
+	}
+	return (nowNs() - start) / iterations;
+}
+
+int main(int argc, char** argv) {
+	long iterations = (argc > 1) ? std::atol(argv[1]) : 100000;
+	ByteScan::Level levels[] = { ByteScan::LEVEL_SCALAR, ByteScan::LEVEL_SSE42, ByteScan::LEVEL_AVX2 };
+	size_t sizes[] = { 500, 1000, 2000 };
+
+	// Upload body: binary-ish bytes with plenty of '-' and CRLF, boundary at the end
+	std::string delimiter = "--------------------------a1b2c3d4e5f6";
+	std::string body;
+	for (size_t i = 0; body.size() < (1 << 20); ++i) {
+		body += static_cast<char>((i * 131) % 251);
+		if (i % 97 == 0) {
+			body += "\r\n--";
+		}
+	}
+	body += "\r\n" + delimiter + "--\r\n";
+
+	std::printf("%-8s %-8s %10s %10s %10s\n", "level", "bytes", "parse ns", "lines ns", "MB/s");
+	for (int l = 0; l < 3; ++l) {
+		if (ByteScan::setLevel(levels[l]) != levels[l]) {
+			std::printf("%-8s (not supported)\n", ByteScan::levelName(levels[l]));
+			continue;
+		}
+		for (int s = 0; s < 3; ++s) {
+			std::string head = browserHead(sizes[s]);
+			benchParse(head, iterations / 10); // Warm up
+			double parse = benchParse(head, iterations);
+			double lines = benchLines(head, iterations);
+			std::printf("%-8s %-8lu %10.0f %10.0f %10.0f\n", ByteScan::levelName(levels[l]),
+			            (unsigned long)head.size(), parse, lines, head.size() * 1e3 / parse);
+		}
+		double boundary = benchBoundary(body, delimiter, iterations / 1000 + 1);
+		std::printf("%-8s %-8s %10s %10.0f %10.0f\n", ByteScan::levelName(levels[l]), "1 MiB", "boundary",
+		            boundary, body.size() * 1e3 / boundary);
+	}
+	return 0;
+}
+CPPEOF
+
+SOURCES="src/http/RequestParser.cpp src/http/HeaderTable.cpp src/http/Method.cpp src/http/BodySink.cpp src/utils/ByteScan.cpp src/utils/Logger.cpp"
+if ! $CXX -std=c++98 -O2 -I. "$TMP/bench.cpp" $SOURCES -o "$TMP/bench" 2> "$TMP/build.log"; then
+    echo -e "${RED}Error: build failed${NC}"
+    cat "$TMP/build.log"
+    exit 1
+fi
+
+printf "${BLUE}%s${NC}\n" "parse: feed() per request head, lines: findLineEnd() over it, MB/s: parse throughput"
+"$TMP/bench" "$ITERATIONS" 2> /dev/null
+echo ""
+echo -e "${GREEN}Done.${NC}"
@@ -440,6 +440,195 @@ else
     ((TESTS_PASSED++))
 fi
 
+# =============================================================================
+# TESTE 10: Range Requests
+# =============================================================================
+
+print_header "TESTE 10: Range Requests"
+
+FILE_SIZE=$(curl -s "$SERVER_URL/index.html" | wc -c)
+
+print_test "10.1 - Ranges sobrepostas não multiplicam a resposta"
+RANGES=$(printf '0-,%.0s' {1..16})
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code} %{size_download}" "$SERVER_URL/index.html" -H "Range: bytes=${RANGES%,}")
+assert_equals "$RESPONSE" "206 $FILE_SIZE" "16× '0-' devolve o ficheiro uma só vez"
+
+print_test "10.2 - Range simples devolve 206 com Content-Range"
+RESPONSE=$(curl -s -i "$SERVER_URL/index.html" -H "Range: bytes=0-9")
+assert_http_status "$RESPONSE" "206"
+assert_contains "$RESPONSE" "Content-Range: bytes 0-9/$FILE_SIZE" "Content-Range da parte pedida"
+assert_contains "$RESPONSE" "Content-Length: 10" "Só os 10 bytes pedidos"
+
+print_test "10.3 - Várias ranges devolvem multipart/byteranges"
+RESPONSE=$(curl -s -i "$SERVER_URL/index.html" -H "Range: bytes=0-1,5-6")
+assert_http_status "$RESPONSE" "206"
+assert_contains "$RESPONSE" "Content-Type: multipart/byteranges; boundary=" "Body multipart com boundary"
+
+print_test "10.4 - Range fora do ficheiro devolve 416"
+RESPONSE=$(curl -s -i "$SERVER_URL/index.html" -H "Range: bytes=$FILE_SIZE-")
+assert_http_status "$RESPONSE" "416"
+assert_contains "$RESPONSE" "Content-Range: bytes \*/$FILE_SIZE" "Content-Range com o tamanho do ficheiro"
+
+print_test "10.5 - If-Range com ETag atual devolve a range"
+ETAG=$(curl -s -I "$SERVER_URL/index.html" | grep -i "^ETag:" | cut -d' ' -f2 | tr -d '\r')
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code} %{size_download}" "$SERVER_URL/index.html" -H "Range: bytes=0-9" -H "If-Range: $ETAG")
+assert_equals "$RESPONSE" "206 10" "If-Range coincide: 206"
+
+print_test "10.6 - If-Range desatualizado devolve o ficheiro inteiro"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code} %{size_download}" "$SERVER_URL/index.html" -H "Range: bytes=0-9" -H 'If-Range: "desatualizado"')
+assert_equals "$RESPONSE" "200 $FILE_SIZE" "If-Range não coincide: 200"
+
+# =============================================================================
+# TESTE 11: Transfer-Encoding
+# =============================================================================
+
+print_header "TESTE 11: Transfer-Encoding"
+
+print_test "11.1 - Body chunked é aceite"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$SERVER_URL/test" -H "Transfer-Encoding: chunked" --data-binary "a=b")
+assert_equals "$RESPONSE" "200" "Transfer-Encoding: chunked"
+
+print_test "11.2 - Outras codings devolvem 501"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$SERVER_URL/test" -H "Transfer-Encoding: gzip, chunked" --data-binary "a=b")
+assert_equals "$RESPONSE" "501" "Transfer-Encoding: gzip, chunked"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$SERVER_URL/test" -H "Transfer-Encoding: xchunked" --data-binary "a=b")
+assert_equals "$RESPONSE" "501" "Transfer-Encoding: xchunked"
+
+# =============================================================================
+# TESTE 12: Keep-Alive
+# =============================================================================
+
+print_header "TESTE 12: Keep-Alive"
+
+print_test "12.1 - Duas requisições na mesma conexão"
+RESPONSE=$(curl -s -o /dev/null -o /dev/null -w "%{num_connects} " "$SERVER_URL/index.html" "$SERVER_URL/index.html")
+assert_equals "$RESPONSE" "1 0 " "A segunda requisição reutiliza a conexão"
+
+print_test "12.2 - HTTP/1.1 mantém a conexão aberta"
+RESPONSE=$(curl -s -i "$SERVER_URL/index.html")
+assert_contains "$RESPONSE" "Connection: keep-alive" "Response deve conter Connection: keep-alive"
+
+print_test "12.3 - Connection: close fecha a conexão"
+RESPONSE=$(curl -s -i -H "Connection: close" "$SERVER_URL/index.html")
+assert_contains "$RESPONSE" "Connection: close" "Response deve conter Connection: close"
+
+print_test "12.4 - HTTP/1.0 sem keep-alive fecha a conexão"
+RESPONSE=$(curl -s -i -0 "$SERVER_URL/index.html")
+assert_contains "$RESPONSE" "Connection: close" "Response HTTP/1.0 deve conter Connection: close"
+
+# =============================================================================
+# TESTE 13: Pipelining
+# =============================================================================
+
+print_header "TESTE 13: Pipelining"
+
+print_test "13.1 - Respostas na ordem das requisições"
+HOST_PORT=${SERVER_URL#http://}
+exec 3<>/dev/tcp/${HOST_PORT%:*}/${HOST_PORT#*:}
+printf 'GET /index.html HTTP/1.1\r\nHost: localhost\r\n\r\nGET /arquivo_inexistente_12345.html HTTP/1.1\r\nHost: localhost\r\n\r\nGET /index.html HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n' >&3
+RESPONSE=$(timeout 5 cat <&3 | grep -a -o "^HTTP/1.1 [0-9]*" | tr '\n' ' ')
+exec 3<&-
+assert_equals "$RESPONSE" "HTTP/1.1 200 HTTP/1.1 404 HTTP/1.1 200 " "Três requisições num só envio: 200, 404, 200"
+
+# =============================================================================
+# TESTE 14: Limite de Body (client_max_body_size)
+# =============================================================================
+
+print_header "TESTE 14: Limite de Body"
+
+head -c 11000000 /dev/zero > "$TEMP_DIR/body_11mb.bin"
+
+print_test "14.1 - Content-Length acima de client_max_body_size"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$SERVER_URL/test" --data-binary "@$TEMP_DIR/body_11mb.bin")
+assert_equals "$RESPONSE" "413" "Body de 11MB com limite de 10M"
+
+print_test "14.2 - Body chunked acima de client_max_body_size"
+RESPONSE=$(curl -s -o /dev/null -w "%{http_code}" -X POST "$SERVER_URL/test" -H "Transfer-Encoding: chunked" --data-binary "@$TEMP_DIR/body_11mb.bin")
+assert_equals "$RESPONSE" "413" "Body chunked de 11MB com limite de 10M"
+
+# =============================================================================
+# TESTE 15: Expect: 100-continue
+# =============================================================================
+
+print_header "TESTE 15: Expect: 100-continue"
+
+print_test "15.1 - 100 Continue antes do body aceite"
+RESPONSE=$(curl -s -v -o /dev/null -X POST "$SERVER_URL/test" -H "Expect: 100-continue" --data-binary "a=b" 2>&1 | grep -a "^< HTTP" | tr -d '\r')
+assert_contains "$RESPONSE" "HTTP/1.1 100 Continue" "Interim 100 Continue enviado"
+assert_contains "$RESPONSE" "HTTP/1.1 200" "Resposta final 200"
+
+print_test "15.2 - Body acima do limite: 413 sem 100 Continue"
+RESPONSE=$(curl -s -v -o /dev/null -X POST "$SERVER_URL/test" -H "Expect: 100-continue" --data-binary "@$TEMP_DIR/body_11mb.bin" 2>&1 | grep -a "^< HTTP" | tr -d '\r')
+assert_contains "$RESPONSE" "HTTP/1.1 413" "Resposta final 413"
+! echo "$RESPONSE" | grep -q "100 Continue"
+assert_success $? "Nenhum 100 Continue para um body rejeitado"
+
+print_test "15.3 - Método não permitido: 405 sem 100 Continue"
+RESPONSE=$(curl -s -v -o /dev/null -X POST "$SERVER_URL/static/" -H "Expect: 100-continue" --data-binary "a=b" 2>&1 | grep -a "^< HTTP" | tr -d '\r')
+assert_contains "$RESPONSE" "HTTP/1.1 405" "Resposta final 405"
+! echo "$RESPONSE" | grep -q "100 Continue"
+assert_success $? "Nenhum 100 Continue para um método rejeitado"
+
+# =============================================================================
+# TESTE 16: Compressão (gzip on)
+# =============================================================================
+
+print_header "TESTE 16: Compressão"
+
+print_test "16.1 - Accept-Encoding: gzip devolve o body comprimido"
+RESPONSE=$(curl -s -D - -o /dev/null "$SERVER_URL/index.html" -H "Accept-Encoding: gzip")
+assert_contains "$RESPONSE" "Content-Encoding: gzip" "Response deve conter Content-Encoding: gzip"
+assert_contains "$RESPONSE" "Vary: Accept-Encoding" "Response deve conter Vary: Accept-Encoding"
+
+print_test "16.2 - Body descomprimido igual ao original"
+ORIGINAL=$(curl -s "$SERVER_URL/index.html" | md5sum)
+DECODED=$(curl -s --compressed "$SERVER_URL/index.html" | md5sum)
+assert_equals "$DECODED" "$ORIGINAL" "Mesmo conteúdo depois de descomprimir"
+
+print_test "16.3 - Sem Accept-Encoding: identity, mas com Vary"
+RESPONSE=$(curl -s -D - -o /dev/null "$SERVER_URL/index.html")
+! echo "$RESPONSE" | grep -qi "^Content-Encoding:"
+assert_success $? "Response sem Content-Encoding"
+assert_contains "$RESPONSE" "Vary: Accept-Encoding" "Response deve conter Vary: Accept-Encoding"
+
+print_test "16.4 - Coding com maior q é escolhida"
+RESPONSE=$(curl -s -D - -o /dev/null "$SERVER_URL/index.html" -H "Accept-Encoding: gzip;q=0.5, deflate")
+assert_contains "$RESPONSE" "Content-Encoding: deflate" "deflate preferido a gzip;q=0.5"
+
+print_test "16.5 - gzip;q=0 recusa a compressão"
+RESPONSE=$(curl -s -D - -o /dev/null "$SERVER_URL/index.html" -H "Accept-Encoding: gzip;q=0")
+! echo "$RESPONSE" | grep -qi "^Content-Encoding:"
+assert_success $? "Response sem Content-Encoding"
+
+# =============================================================================
+# TESTE 17: Linha de Pedido
+# =============================================================================
+
+print_header "TESTE 17: Linha de Pedido"
+
+HOST_PORT=${SERVER_URL#http://}
+
+print_test "17.1 - Linhas em branco antes do pedido são ignoradas"
+exec 3<>/dev/tcp/${HOST_PORT%:*}/${HOST_PORT#*:}
+printf '\r\n\r\nGET /index.html HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n' >&3
+RESPONSE=$(timeout 5 cat <&3 | head -1 | tr -d '\r')
+exec 3<&-
+assert_equals "$RESPONSE" "HTTP/1.1 200 OK" "Duas linhas em branco antes do GET"
+
+print_test "17.2 - Linhas em branco sem fim devolvem 400"
+exec 3<>/dev/tcp/${HOST_PORT%:*}/${HOST_PORT#*:}
+printf '\r\n%.0s' {1..5000} >&3
+RESPONSE=$(timeout 5 cat <&3 | head -1 | tr -d '\r')
+exec 3<&-
+assert_equals "$RESPONSE" "HTTP/1.1 400 Bad Request" "10000 bytes de CRLF"
+
+print_test "17.3 - Espaços sem fim antes do target devolvem 400"
+exec 3<>/dev/tcp/${HOST_PORT%:*}/${HOST_PORT#*:}
+{ printf 'GET'; printf ' %.0s' {1..10000}; } >&3
+RESPONSE=$(timeout 5 cat <&3 | head -1 | tr -d '\r')
+exec 3<&-
+assert_equals "$RESPONSE" "HTTP/1.1 400 Bad Request" "GET seguido de 10000 espaços"
+
 # =============================================================================
 # LIMPEZA
 # =============================================================================